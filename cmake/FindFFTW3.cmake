@@ -21,6 +21,7 @@
 #  FFTW3_INCLUDE_DIR    - where to find fftw3.h
 #  FFTW3_LIBRARIES   - List of libraries when using FFTW.
 #  FFTW3_FOUND       - True if FFTW found.
+#  FFTW3_OMP_LIBRARIES - OpenMP threads library of FFTW, if available.
 
 if(FFTW3_INCLUDE_DIR)
   # Already in cache, be silent
@@ -29,6 +30,7 @@ endif(FFTW3_INCLUDE_DIR)
 
 find_path(FFTW3_INCLUDE_DIR fftw3.h)
 find_library(FFTW3_LIBRARIES NAMES fftw3)
+find_library(FFTW3_OMP_LIBRARIES NAMES fftw3_omp)
 
 # handle the QUIETLY and REQUIRED arguments and set FFTW_FOUND to TRUE if all
 # listed variables are TRUE
@@ -36,10 +38,16 @@ include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(FFTW3 DEFAULT_MSG FFTW3_LIBRARIES
                                   FFTW3_INCLUDE_DIR)
 
-mark_as_advanced(FFTW3_LIBRARIES FFTW3_INCLUDE_DIR)
+mark_as_advanced(FFTW3_LIBRARIES FFTW3_OMP_LIBRARIES FFTW3_INCLUDE_DIR)
 
 if(FFTW3_FOUND AND NOT TARGET FFTW3::FFTW3)
   add_library(FFTW3::FFTW3 INTERFACE IMPORTED)
   target_include_directories(FFTW3::FFTW3 INTERFACE "${FFTW3_INCLUDE_DIR}")
   target_link_libraries(FFTW3::FFTW3 INTERFACE "${FFTW3_LIBRARIES}")
 endif()
+
+if(FFTW3_FOUND AND FFTW3_OMP_LIBRARIES AND NOT TARGET FFTW3::FFTW3_OMP)
+  add_library(FFTW3::FFTW3_OMP INTERFACE IMPORTED)
+  target_link_libraries(FFTW3::FFTW3_OMP INTERFACE "${FFTW3_OMP_LIBRARIES}"
+                                                   FFTW3::FFTW3)
+endif()
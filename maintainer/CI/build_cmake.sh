@@ -109,6 +109,7 @@ set_default_value with_ccache false
 set_default_value with_hdf5 true
 set_default_value with_scafacos false
 set_default_value with_stokesian_dynamics false
+set_default_value with_openmp false
 set_default_value test_timeout 300
 set_default_value hide_gpu false
 
@@ -156,6 +157,12 @@ else
     cmake_params="${cmake_params} -DWITH_STOKESIAN_DYNAMICS=OFF"
 fi
 
+if [ "${with_openmp}" = true ]; then
+    cmake_params="${cmake_params} -DWITH_OPENMP=ON"
+else
+    cmake_params="${cmake_params} -DWITH_OPENMP=OFF"
+fi
+
 if [ "${with_coverage}" = true ]; then
     cmake_params="-DWITH_COVERAGE=ON ${cmake_params}"
 fi
@@ -198,7 +205,7 @@ outp srcdir builddir \
     check_odd_only \
     with_static_analysis with_fast_math myconfig \
     build_procs check_procs \
-    with_cuda with_cuda_compiler with_ccache
+    with_cuda with_cuda_compiler with_ccache with_openmp
 
 echo "Creating ${builddir}..."
 mkdir -p "${builddir}"
@@ -0,0 +1,108 @@
+#
+# Copyright (C) 2013-2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import espressomd
+import benchmarks
+import numpy as np
+import argparse
+
+parser = argparse.ArgumentParser(description="Benchmark the viscoelastic "
+                                 "(GLE) thermostat with non-linear Prony "
+                                 "modes. Save the results to a CSV file.")
+parser.add_argument("--particles_per_core", metavar="N", action="store",
+                    type=int, default=1000, required=False,
+                    help="Number of particles in the simulation box")
+parser.add_argument("--modes", metavar="M", action="store",
+                    type=int, default=16, required=False,
+                    help="Number of Prony modes of the memory kernel")
+parser.add_argument("--exponents", action="store", type=str,
+                    default="generic", required=False,
+                    choices=["scalar", "generic", "fast", "linear"],
+                    help="Shear-thinning exponents: 'scalar' (a=0.37, "
+                    "b close to 1.3 but different for every mode, which "
+                    "takes two std::pow calls per mode like the former "
+                    "per-mode evaluation, i.e. the baseline), 'generic' "
+                    "(a=0.37, b=1.3), 'fast' (a=0.5, b=2, integer and "
+                    "half-integer fast paths) or 'linear' (a=0), "
+                    "default: generic")
+parser.add_argument("--output", metavar="FILEPATH", action="store",
+                    type=str, required=False, default="benchmarks.csv",
+                    help="Output file (default: benchmarks.csv)")
+
+args = parser.parse_args()
+
+# process and check arguments
+measurement_steps = int(np.round(5e6 / args.particles_per_core, -2))
+n_iterations = 30
+assert args.modes > 0, "modes must be a positive number"
+assert measurement_steps >= 100, \
+    f"{measurement_steps} steps per tick are too short"
+
+required_features = ["EXTERNAL_FORCES"]
+espressomd.assert_features(required_features)
+
+# make simulation deterministic
+np.random.seed(42)
+
+# System
+#############################################################
+system = espressomd.System(box_l=[1, 1, 1])
+
+n_proc = system.cell_system.get_state()['n_nodes']
+n_part = n_proc * args.particles_per_core
+system.box_l = 3 * ((n_part / 0.1)**(1. / 3.),)
+
+# Integration parameters
+#############################################################
+system.time_step = 0.01
+system.cell_system.skin = 0.4
+system.thermostat.turn_off()
+
+# Particle setup
+#############################################################
+system.part.add(pos=np.random.random((n_part, 3)) * system.box_l)
+
+# Thermostat setup
+#############################################################
+aexp, bexp = {"scalar": (0.37, 1.3), "generic": (0.37, 1.3),
+              "fast": (0.5, 2.), "linear": (0., 2.)}[args.exponents]
+bexps = np.full(args.modes, bexp)
+if args.exponents == "scalar":
+    # no shared exponent b: (v^2/v_c^2)^(b/2) is evaluated for every mode
+    bexps *= 1. + 1e-3 * np.arange(args.modes)
+taus = np.logspace(-1, 1, args.modes)
+system.thermostat.set_langevin(kT=1.0, gamma=1.0, seed=42)
+system.thermostat.set_gle(kT=1.0, seed=42)
+system.thermostat.set_gle_kernel(
+    particle_type=0, gamma=np.ones(args.modes) / args.modes, tau=taus,
+    vcrit=np.linspace(0.5, 2., args.modes), aexp=args.modes * [aexp],
+    bexp=bexps)
+
+print("Equilibration")
+system.integrator.run(min(5 * measurement_steps, 20000))
+
+# time integration loop
+timings = benchmarks.get_timings(system, measurement_steps, n_iterations)
+
+# average time
+avg, ci = benchmarks.get_average_time(timings)
+print(f"average: {avg:.3e} +/- {ci:.3e} (95% C.I.)")
+
+# write report
+benchmarks.write_report(args.output, n_proc, timings, measurement_steps)
@@ -23,11 +23,11 @@
 
 #include "BondList.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 #include <utils/compact_vector.hpp>
 #include <utils/math/quaternion.hpp>
 #include <utils/quaternion.hpp>
-#include <utils/matrix.hpp>
 
 #include <boost/container/vector.hpp>
 #include <boost/serialization/is_bitwise_serializable.hpp>
@@ -35,7 +35,10 @@
 #include <boost/serialization/vector.hpp>
 
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace detail {
@@ -199,22 +202,9 @@ struct ParticleProperties {
 #ifdef EXTERNAL_FORCES
   /** External force. */
   Utils::Vector3d ext_force = {0., 0., 0.};
-  Utils::Vector3d visc_force = {0., 0., 0.};
-  Utils::Vector3d visc_gamma_vec = {1., 1., 1.};
-  Utils::Matrix<double, 20, 3> visc_force_mat = {};
-  Utils::Vector<double,20> visc_gamma = {};
-  Utils::Vector<double,20> taum = {};
-  Utils::Vector<double,20> vcrit = {};
-  Utils::Vector<double,20> aexp = {};
-  Utils::Vector<double,20> bexp = {};
-  int Nm = 0;
 #ifdef ROTATION
   /** External torque. */
   Utils::Vector3d ext_torque = {0., 0., 0.};
-  Utils::Vector3d visc_torque = {0., 0., 0.};
-  Utils::Matrix<double, 20, 3> visc_torque_mat = {};
-  Utils::Vector<double,20> omegacrit = {};
-  Utils::Vector<double,20> visc_gamma_rot = {};
 #endif // ROTATION
 #endif // EXTERNAL_FORCES
 
@@ -262,21 +252,8 @@ struct ParticleProperties {
 #ifdef EXTERNAL_FORCES
     ar &ext_flag;
     ar &ext_force;
-    ar &visc_force;
-    ar &visc_force_mat;
-    ar &visc_gamma_vec;
-    ar &visc_gamma;
-    ar &taum;
-    ar &vcrit;
-    ar &aexp;
-    ar &bexp;
-    ar &Nm;
 #ifdef ROTATION
     ar &ext_torque;
-    ar &visc_torque;
-    ar &visc_torque_mat;
-    ar &omegacrit;
-    ar &visc_gamma_rot;
 #endif
 #endif // EXTERNAL_FORCES
 
@@ -426,6 +403,87 @@ struct ParticleRattle {
 };
 #endif
 
+#ifdef EXTERNAL_FORCES
+/** Auxiliary variables of the Prony modes of the generalized Langevin
+ *  equation. The mode parameters are shared by all particles of a type and
+ *  stored in the GLE thermostat, only the extended variables are stored
+ *  here, as a structure of arrays in a single buffer sized to the number
+ *  of modes of the particle. The buffer stays empty for particles without
+ *  viscoelastic friction. It is only needed on the node the particle
+ *  belongs to, hence it is not part of the ghost communication.
+ */
+class ParticleGLE {
+public:
+  /** Components of the extended variables, each one stored as a contiguous
+   *  array over the modes.
+   */
+  enum Field : unsigned {
+    U_X = 0u, ///< translational extended variables
+    U_Y,
+    U_Z,
+    U_ROT_X, ///< rotational extended variables
+    U_ROT_Y,
+    U_ROT_Z,
+    N_FIELDS
+  };
+
+  /** Number of Prony modes. */
+  int n_modes() const { return static_cast<int>(m_data.size() / N_FIELDS); }
+  /** Largest number of Prony modes the buffer can hold. */
+  static constexpr int max_modes() {
+    return static_cast<int>(
+        std::numeric_limits<Utils::detail::container_size_type>::max() /
+        N_FIELDS);
+  }
+
+  /** Change the number of modes, keeping the values of the existing ones.
+   *  New modes are zero-initialized, setting zero modes frees the buffer.
+   */
+  void resize(int n_modes) {
+    assert(n_modes >= 0 and n_modes <= max_modes());
+    if (n_modes == 0) {
+      m_data.clear();
+      m_data.shrink_to_fit();
+      return;
+    }
+    auto const old_n_modes = static_cast<std::size_t>(this->n_modes());
+    auto const new_n_modes = static_cast<std::size_t>(n_modes);
+    Utils::compact_vector<double> data(N_FIELDS * new_n_modes, 0.);
+    for (unsigned f = 0u; f < N_FIELDS; ++f) {
+      std::copy_n(m_data.begin() + f * old_n_modes,
+                  std::min(old_n_modes, new_n_modes),
+                  data.begin() + f * new_n_modes);
+    }
+    m_data = std::move(data);
+  }
+
+  /** Values of a component over all modes. */
+  Utils::Span<double> operator[](Field field) {
+    auto const n = static_cast<std::size_t>(n_modes());
+    return {m_data.data() + field * n, n};
+  }
+  Utils::Span<const double> operator[](Field field) const {
+    auto const n = static_cast<std::size_t>(n_modes());
+    return {m_data.data() + field * n, n};
+  }
+
+  /** All extended variables, component-major. */
+  std::vector<double> state() const { return {m_data.begin(), m_data.end()}; }
+  void set_state(std::vector<double> const &state) {
+    assert(state.size() % N_FIELDS == 0u);
+    m_data = Utils::compact_vector<double>(state.begin(), state.end());
+  }
+
+private:
+  Utils::compact_vector<double> m_data;
+
+  friend boost::serialization::access;
+  template <class Archive> void serialize(Archive &ar, long int /* version */) {
+    ar &m_data;
+  }
+};
+#endif // EXTERNAL_FORCES
+
 /** Struct holding all information for one particle. */
 struct Particle { // NOLINT(bugprone-exception-escape)
   ///
@@ -454,6 +512,11 @@ private:
   Utils::compact_vector<int> el;
 #endif
 
+#ifdef EXTERNAL_FORCES
+  /** Extended variables of the generalized Langevin equation. */
+  ParticleGLE gl;
+#endif
+
 public:
   auto const &id() const { return p.identity; }
   auto &id() { return p.identity; }
@@ -521,14 +584,6 @@ public:
   auto const &ext_torque() const { return p.ext_torque; }
   auto &ext_torque() { return p.ext_torque; }
   auto calc_director() const { return r.calc_director(); }
-  auto const &visc_torque() const { return p.visc_torque; }
-  auto &visc_torque() { return p.visc_torque; }
-  auto const &visc_torque_mat() const { return p.visc_torque_mat; }
-  auto &visc_torque_mat() { return p.visc_torque_mat; }
-  auto const &omegacrit() const { return p.omegacrit; }
-  auto &omegacrit() { return p.omegacrit; }
-  auto const &visc_gamma_rot() const { return p.visc_gamma_rot; }
-  auto &visc_gamma_rot() { return p.visc_gamma_rot; }
 #else  // ROTATION
   bool can_rotate() const { return false; }
   bool can_rotate_around(int const axis) const { return false; }
@@ -588,24 +643,9 @@ public:
   }
   auto const &ext_force() const { return p.ext_force; }
   auto &ext_force() { return p.ext_force; }
-  auto const &visc_force() const { return p.visc_force; }
-  auto &visc_force() { return p.visc_force; }
-  auto const &visc_force_mat() const { return p.visc_force_mat; }
-  auto &visc_force_mat() { return p.visc_force_mat; }
-  auto const &visc_gamma_vec() const { return p.visc_gamma_vec; }
-  auto &visc_gamma_vec() { return p.visc_gamma_vec; }
-  auto const &visc_gamma() const { return p.visc_gamma; }
-  auto &visc_gamma() { return p.visc_gamma; }
-  auto const &taum() const { return p.taum; }
-  auto &taum() { return p.taum; }
-  auto const &vcrit() const { return p.vcrit; }
-  auto &vcrit() { return p.vcrit; }
-  auto const &aexp() const { return p.aexp; }
-  auto &aexp() { return p.aexp; }
-  auto const &bexp() const { return p.bexp; }
-  auto &bexp() { return p.bexp; }
-  auto const &Nm() const { return p.Nm; }
-  auto &Nm() { return p.Nm; }
+  auto const &gle() const { return gl; }
+  auto &gle() { return gl; }
+  auto Nm() const { return gl.n_modes(); }
 #else  // EXTERNAL_FORCES
   constexpr bool has_fixed_coordinates() const { return false; }
   constexpr bool is_fixed_along(int const) const { return false; }
@@ -643,6 +683,9 @@ private:
     ar &bl;
 #ifdef EXCLUSIONS
     ar &el;
+#endif
+#ifdef EXTERNAL_FORCES
+    ar &gl;
 #endif
   }
 };
@@ -654,6 +697,9 @@ BOOST_CLASS_IMPLEMENTATION(ParticlePosition, object_serializable)
 BOOST_CLASS_IMPLEMENTATION(ParticleMomentum, object_serializable)
 BOOST_CLASS_IMPLEMENTATION(ParticleForce, object_serializable)
 BOOST_CLASS_IMPLEMENTATION(ParticleLocal, object_serializable)
+#ifdef EXTERNAL_FORCES
+BOOST_CLASS_IMPLEMENTATION(ParticleGLE, object_serializable)
+#endif
 #ifdef BOND_CONSTRAINT
 BOOST_CLASS_IMPLEMENTATION(ParticleRattle, object_serializable)
 #endif
@@ -61,6 +61,9 @@ public:
   ParticleIterator(BidirectionalIterator end)
       : m_cell(end), m_end(end), m_part() {}
 
+  /** Cell of the current particle, or the end cell. */
+  BidirectionalIterator cell() const { return m_cell; }
+
 private:
   friend typename base_type::difference_type
   distance(ParticleIterator const &begin, ParticleIterator const &end) {
@@ -18,6 +18,7 @@
  */
 #include "accumulators.hpp"
 
+#include <boost/mpi/communicator.hpp>
 #include <boost/range/algorithm/remove_if.hpp>
 #include <boost/range/numeric.hpp>
 
@@ -39,12 +40,13 @@ struct AutoUpdateAccumulator {
 std::vector<AutoUpdateAccumulator> auto_update_accumulators;
 } // namespace
 
-void auto_update(int steps) {
+void auto_update(boost::mpi::communicator const &comm, int steps) {
+  ObservableSamples samples;
   for (auto &acc : auto_update_accumulators) {
     assert(steps <= acc.frequency);
     acc.counter -= steps;
     if (acc.counter <= 0) {
-      acc.acc->update();
+      acc.acc->update(comm, samples);
       acc.counter = acc.frequency;
     }
 
@@ -21,15 +21,19 @@
 
 #include "accumulators/AccumulatorBase.hpp"
 
+#include <boost/mpi/communicator.hpp>
+
 namespace Accumulators {
 /**
  * @brief Update accumulators.
  *
  * Checks for all auto update accumulators if
  * they need to be updated and if so does.
+ * Accumulators due in the same step share the observable evaluations.
+ * Has to be called on all ranks.
  *
  */
-void auto_update(int steps);
+void auto_update(boost::mpi::communicator const &comm, int steps);
 int auto_update_next_update();
 void auto_update_add(AccumulatorBase *);
 void auto_update_remove(AccumulatorBase *);
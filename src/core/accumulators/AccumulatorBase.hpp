@@ -19,11 +19,45 @@
 #ifndef CORE_ACCUMULATORS_ACCUMULATOR_BASE_HPP
 #define CORE_ACCUMULATORS_ACCUMULATOR_BASE_HPP
 
+#include "observables/Observable.hpp"
+
+#include <boost/mpi/communicator.hpp>
+
+#include <algorithm>
 #include <cstddef>
+#include <deque>
+#include <utility>
 #include <vector>
 
 namespace Accumulators {
 
+/** Observable values sampled during one update sweep.
+ *
+ *  Accumulators updated in the same sweep share the samples of their
+ *  observables, so that each observable is evaluated only once. The
+ *  evaluation is collective: all ranks have to request the observables
+ *  in the same order. The values are only available on rank 0.
+ */
+class ObservableSamples {
+public:
+  std::vector<double> const &operator()(Observables::Observable const &obs,
+                                        boost::mpi::communicator const &comm) {
+    auto const it = std::find_if(
+        m_samples.begin(), m_samples.end(),
+        [&obs](auto const &sample) { return sample.first == &obs; });
+    if (it != m_samples.end()) {
+      return it->second;
+    }
+    m_samples.emplace_back(&obs, obs(comm));
+    return m_samples.back().second;
+  }
+
+private:
+  /** References to the samples stay valid while new ones are added. */
+  std::deque<std::pair<Observables::Observable const *, std::vector<double>>>
+      m_samples;
+};
+
 class AccumulatorBase {
 public:
   explicit AccumulatorBase(int delta_N = 1) : m_delta_N(delta_N) {}
@@ -31,7 +65,18 @@ public:
 
   int &delta_N() { return m_delta_N; }
 
-  virtual void update() = 0;
+  /** Sample the observables. Collective call, the samples are only
+   *  recorded on rank 0.
+   */
+  void update(boost::mpi::communicator const &comm) {
+    ObservableSamples samples;
+    update(comm, samples);
+  }
+  /** Sample the observables, reusing the values already evaluated
+   *  in @p samples by other accumulators.
+   */
+  virtual void update(boost::mpi::communicator const &comm,
+                      ObservableSamples &samples) = 0;
   /** Dimensions needed to reshape the flat array returned by the accumulator */
   virtual std::vector<std::size_t> shape() const = 0;
 
@@ -28,6 +28,7 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/mpi/communicator.hpp>
 #include <boost/range/algorithm/transform.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
@@ -42,6 +43,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -50,120 +52,123 @@ int min(int i, unsigned int j) { return std::min(i, static_cast<int>(j)); }
 
 namespace Accumulators {
 /** Compress computing arithmetic mean: A_compressed=(A1+A2)/2 */
-std::vector<double> compress_linear(std::vector<double> const &A1,
-                                    std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A1.size());
-
-  std::transform(A1.begin(), A1.end(), A2.begin(), A_compressed.begin(),
-                 [](double a, double b) -> double { return 0.5 * (a + b); });
-
-  return A_compressed;
+void compress_linear(double const *A1, double const *A2, double *A_compressed,
+                     std::size_t dim) {
+  for (std::size_t k = 0; k < dim; k++) {
+    A_compressed[k] = 0.5 * (A1[k] + A2[k]);
+  }
 }
 
 /** Compress discarding the 1st argument and return the 2nd */
-std::vector<double> compress_discard1(std::vector<double> const &A1,
-                                      std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A2);
-  return A_compressed;
+void compress_discard1(double const *, double const *A2, double *A_compressed,
+                       std::size_t dim) {
+  std::copy_n(A2, dim, A_compressed);
 }
 
 /** Compress discarding the 2nd argument and return the 1st */
-std::vector<double> compress_discard2(std::vector<double> const &A1,
-                                      std::vector<double> const &A2) {
-  assert(A1.size() == A2.size());
-  std::vector<double> A_compressed(A1);
-  return A_compressed;
+void compress_discard2(double const *A1, double const *, double *A_compressed,
+                       std::size_t dim) {
+  std::copy_n(A1, dim, A_compressed);
 }
 
-std::vector<double> scalar_product(std::vector<double> const &A,
-                                   std::vector<double> const &B,
-                                   Utils::Vector3d const &) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in scalar product: The vector sizes do not match");
-  }
-
-  auto const result = std::inner_product(A.begin(), A.end(), B.begin(), 0.0);
-  return {result};
-}
+/* Correlation operations. Each kernel adds the correlation of an old
+ * sample @c A with the newest sample @c B to the result row @c C.
+ */
 
-std::vector<double> componentwise_product(std::vector<double> const &A,
-                                          std::vector<double> const &B,
-                                          Utils::Vector3d const &) {
-  std::vector<double> C(A.size());
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in componentwise product: The vector sizes do not match");
+struct ScalarProduct {
+  static void accumulate(double const *A, double const *B, double *C,
+                         std::size_t dim_A, std::size_t,
+                         Utils::Vector3d const &) {
+    auto sum = 0.;
+    for (std::size_t k = 0; k < dim_A; k++) {
+      sum += A[k] * B[k];
+    }
+    C[0] += sum;
   }
-
-  std::transform(A.begin(), A.end(), B.begin(), C.begin(), std::multiplies<>());
-
-  return C;
-}
-
-std::vector<double> tensor_product(std::vector<double> const &A,
-                                   std::vector<double> const &B,
-                                   Utils::Vector3d const &) {
-  std::vector<double> C(A.size() * B.size());
-  auto C_it = C.begin();
-
-  for (double a : A) {
-    for (double b : B) {
-      *(C_it++) = a * b;
+};
+
+struct ComponentwiseProduct {
+  static void accumulate(double const *A, double const *B, double *C,
+                         std::size_t dim_A, std::size_t,
+                         Utils::Vector3d const &) {
+    for (std::size_t k = 0; k < dim_A; k++) {
+      C[k] += A[k] * B[k];
     }
   }
-
-  return C;
-}
-
-std::vector<double> square_distance_componentwise(std::vector<double> const &A,
-                                                  std::vector<double> const &B,
-                                                  Utils::Vector3d const &) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in square distance componentwise: The vector sizes do not "
-        "match.");
+};
+
+struct TensorProduct {
+  static void accumulate(double const *A, double const *B, double *C,
+                         std::size_t dim_A, std::size_t dim_B,
+                         Utils::Vector3d const &) {
+    for (std::size_t i = 0; i < dim_A; i++) {
+      auto const a = A[i];
+      auto *const C_row = C + i * dim_B;
+      for (std::size_t j = 0; j < dim_B; j++) {
+        C_row[j] += a * B[j];
+      }
+    }
   }
-
-  std::vector<double> C(A.size());
-
-  std::transform(
-      A.begin(), A.end(), B.begin(), C.begin(),
-      [](double a, double b) -> double { return Utils::sqr(a - b); });
-
-  return C;
-}
+};
+
+struct SquareDistanceComponentwise {
+  static void accumulate(double const *A, double const *B, double *C,
+                         std::size_t dim_A, std::size_t,
+                         Utils::Vector3d const &) {
+    for (std::size_t k = 0; k < dim_A; k++) {
+      C[k] += Utils::sqr(A[k] - B[k]);
+    }
+  }
+};
 
 // note: the argument name wsquare denotes that its value is w^2 while the user
 // sets w
-std::vector<double> fcs_acf(std::vector<double> const &A,
-                            std::vector<double> const &B,
-                            Utils::Vector3d const &wsquare) {
-  if (A.size() != B.size()) {
-    throw std::runtime_error(
-        "Error in fcs_acf: The vector sizes do not match.");
-  }
-
-  auto const C_size = A.size() / 3;
-  assert(3 * C_size == A.size());
-
-  std::vector<double> C(C_size, 0);
-
-  for (std::size_t i = 0; i < C_size; i++) {
-    for (int j = 0; j < 3; j++) {
-      auto const &a = A[3 * i + j];
-      auto const &b = B[3 * i + j];
-
-      C[i] -= Utils::sqr(a - b) / wsquare[j];
+struct FcsAcf {
+  static void accumulate(double const *A, double const *B, double *C,
+                         std::size_t dim_A, std::size_t,
+                         Utils::Vector3d const &wsquare) {
+    auto const C_size = dim_A / 3;
+    for (std::size_t i = 0; i < C_size; i++) {
+      auto c = 0.;
+      for (int j = 0; j < 3; j++) {
+        c -= Utils::sqr(A[3 * i + j] - B[3 * i + j]) / wsquare[j];
+      }
+      C[i] += std::exp(c);
     }
   }
+};
+
+template <class Operation>
+void Correlator::correlate_level(int level, long lag_begin, long lag_end) {
+  // lag j of level i > 0 is stored in row j + i * tau_lin / 2
+  auto const row_offset = level * (m_tau_lin / 2);
+  auto const index_new = newest[level];
+  auto const *const B_new = B[level][index_new].origin();
+  for (long j = lag_begin; j < lag_end; j++) {
+    auto const index_old = (index_new - j + m_tau_lin + 1) % (m_tau_lin + 1);
+    auto const index_res = j + row_offset;
+    Operation::accumulate(A[level][index_old].origin(), B_new,
+                          result[index_res].origin(), dim_A, dim_B,
+                          m_correlation_args);
+    n_sweeps[index_res]++;
+  }
+}
 
-  std::transform(C.begin(), C.end(), C.begin(),
-                 [](double c) -> double { return std::exp(c); });
+void Correlator::correlate(int level, long lag_begin) {
+  auto const lag_end = min(m_tau_lin + 1, n_vals[level]);
+  if (lag_begin < lag_end) {
+    (this->*m_correlate)(level, lag_begin, lag_end);
+  }
+}
 
-  return C;
+void Correlator::compress(int level) {
+  auto const index_1 = (newest[level] + 1) % (m_tau_lin + 1);
+  auto const index_2 = (newest[level] + 2) % (m_tau_lin + 1);
+  auto const index_new = newest[level + 1];
+  (*compressA)(A[level][index_1].origin(), A[level][index_2].origin(),
+               A[level + 1][index_new].origin(), dim_A);
+  (*compressB)(B[level][index_1].origin(), B[level][index_2].origin(),
+               B[level + 1][index_new].origin(), dim_B);
 }
 
 void Correlator::initialize() {
@@ -210,18 +215,27 @@ void Correlator::initialize() {
   if (corr_operation_name == "componentwise_product") {
     m_dim_corr = dim_A;
     m_shape = A_obs->shape();
-    corr_operation = &componentwise_product;
+    m_correlate = &Correlator::correlate_level<ComponentwiseProduct>;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
+    if (dim_A != dim_B) {
+      throw std::runtime_error(
+          "Error in componentwise product: The vector sizes do not match");
+    }
   } else if (corr_operation_name == "tensor_product") {
     m_dim_corr = dim_A * dim_B;
     m_shape = {dim_A, dim_B};
-    corr_operation = &tensor_product;
+    m_correlate = &Correlator::correlate_level<TensorProduct>;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
   } else if (corr_operation_name == "square_distance_componentwise") {
     m_dim_corr = dim_A;
     m_shape = A_obs->shape();
-    corr_operation = &square_distance_componentwise;
+    m_correlate = &Correlator::correlate_level<SquareDistanceComponentwise>;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
+    if (dim_A != dim_B) {
+      throw std::runtime_error(
+          "Error in square distance componentwise: The vector sizes do not "
+          "match.");
+    }
   } else if (corr_operation_name == "fcs_acf") {
     // note: user provides w=(wx,wy,wz) but we want to use
     // wsquare=(wx^2,wy^2,wz^2)
@@ -239,12 +253,20 @@ void Correlator::initialize() {
       throw std::runtime_error(
           "the last dimension of dimA must be 3 for fcs_acf");
     m_shape.pop_back();
-    corr_operation = &fcs_acf;
+    m_correlate = &Correlator::correlate_level<FcsAcf>;
+    if (dim_A != dim_B) {
+      throw std::runtime_error(
+          "Error in fcs_acf: The vector sizes do not match.");
+    }
   } else if (corr_operation_name == "scalar_product") {
     m_dim_corr = 1;
     m_shape = {1};
-    corr_operation = &scalar_product;
+    m_correlate = &Correlator::correlate_level<ScalarProduct>;
     m_correlation_args = Utils::Vector3d{0, 0, 0};
+    if (dim_A != dim_B) {
+      throw std::runtime_error(
+          "Error in scalar product: The vector sizes do not match");
+    }
   } else {
     throw std::invalid_argument("correlation operation '" +
                                 corr_operation_name + "' not implemented");
@@ -275,10 +297,13 @@ void Correlator::initialize() {
 
   using index_type = decltype(result)::index;
 
-  A.resize(std::array<int, 2>{{m_hierarchy_depth, m_tau_lin + 1}});
-  std::fill_n(A.data(), A.num_elements(), std::vector<double>(dim_A, 0));
-  B.resize(std::array<int, 2>{{m_hierarchy_depth, m_tau_lin + 1}});
-  std::fill_n(B.data(), B.num_elements(), std::vector<double>(dim_B, 0));
+  // each hierarchy level is stored as one contiguous block of samples
+  auto const n_slots = static_cast<std::size_t>(m_tau_lin + 1);
+  auto const depth = static_cast<std::size_t>(m_hierarchy_depth);
+  A.resize(std::array<std::size_t, 3>{{depth, n_slots, dim_A}});
+  std::fill_n(A.data(), A.num_elements(), 0.);
+  B.resize(std::array<std::size_t, 3>{{depth, n_slots, dim_B}});
+  std::fill_n(B.data(), B.num_elements(), 0.);
 
   n_data = 0;
   A_accumulated_average = std::vector<double>(dim_A, 0);
@@ -310,11 +335,27 @@ void Correlator::initialize() {
   }
 }
 
-void Correlator::update() {
+void Correlator::update(boost::mpi::communicator const &comm,
+                        ObservableSamples &samples) {
   if (finalized) {
     throw std::runtime_error(
         "No data can be added after finalize() was called.");
   }
+  auto const &sample_A = samples(*A_obs, comm);
+  auto const &sample_B = samples(*B_obs, comm);
+  if (comm.rank() != 0) {
+    return;
+  }
+  if (sample_A.size() != dim_A) {
+    throw std::runtime_error(
+        "Error in correlator update: the dimension of the first observable "
+        "changed");
+  }
+  if (sample_B.size() != dim_B) {
+    throw std::runtime_error(
+        "Error in correlator update: the dimension of the second observable "
+        "changed");
+  }
   // We must now go through the hierarchy and make sure there is space for the
   // new datapoint. For every hierarchy level we have to decide if it is
   // necessary to move something
@@ -349,70 +390,34 @@ void Correlator::update() {
     // folding)
     newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
     n_vals[i + 1] += 1;
-    A[i + 1][newest[i + 1]] =
-        (*compressA)(A[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     A[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-    B[i + 1][newest[i + 1]] =
-        (*compressB)(B[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     B[i][(newest[i] + 2) % (m_tau_lin + 1)]);
+    compress(i);
   }
 
   newest[0] = (newest[0] + 1) % (m_tau_lin + 1);
   n_vals[0]++;
 
-  A[0][newest[0]] = A_obs->operator()();
-  if (A_obs != B_obs) {
-    B[0][newest[0]] = B_obs->operator()();
-  } else {
-    B[0][newest[0]] = A[0][newest[0]];
-  }
+  std::copy_n(sample_A.begin(), dim_A, A[0][newest[0]].origin());
+  std::copy_n(sample_B.begin(), dim_B, B[0][newest[0]].origin());
 
   // Now we update the cumulated averages and variances of A and B
   n_data++;
   for (std::size_t k = 0; k < dim_A; k++) {
-    A_accumulated_average[k] += A[0][newest[0]][k];
+    A_accumulated_average[k] += sample_A[k];
   }
 
   for (std::size_t k = 0; k < dim_B; k++) {
-    B_accumulated_average[k] += B[0][newest[0]][k];
+    B_accumulated_average[k] += sample_B[k];
   }
 
-  using index_type = decltype(result)::index;
   // Now update the lowest level correlation estimates
-  for (long j = 0; j < min(m_tau_lin + 1, n_vals[0]); j++) {
-    auto const index_new = newest[0];
-    auto const index_old = (newest[0] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-    auto const temp =
-        (corr_operation)(A[0][index_old], B[0][index_new], m_correlation_args);
-    assert(temp.size() == m_dim_corr);
-
-    n_sweeps[j]++;
-    for (index_type k = 0; k < static_cast<index_type>(m_dim_corr); k++) {
-      result[j][k] += temp[k];
-    }
-  }
+  correlate(0, 0);
   // Now for the higher ones
   for (int i = 1; i < highest_level_to_compress + 2; i++) {
-    for (long j = (m_tau_lin + 1) / 2 + 1; j < min(m_tau_lin + 1, n_vals[i]);
-         j++) {
-      auto const index_new = newest[i];
-      auto const index_old = (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-      auto const index_res =
-          m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
-      auto const temp = (corr_operation)(A[i][index_old], B[i][index_new],
-                                         m_correlation_args);
-      assert(temp.size() == m_dim_corr);
-
-      n_sweeps[index_res]++;
-      for (index_type k = 0; k < static_cast<index_type>(m_dim_corr); k++) {
-        result[index_res][k] += temp[k];
-      }
-    }
+    correlate(i, (m_tau_lin + 1) / 2 + 1);
   }
 }
 
 int Correlator::finalize() {
-  using index_type = decltype(result)::index;
   if (finalized) {
     throw std::runtime_error("Correlator::finalize() can only be called once.");
   }
@@ -451,40 +456,20 @@ int Correlator::finalize() {
 
       // Now we know we must make space on the levels
       // 0..highest_level_to_compress
-      // Now let's compress the data level by level.
+      // Now let's shift the data level by level. The compressed values
+      // are not stored, only the correlations of the remaining data.
 
       for (int i = highest_level_to_compress; i >= ll; i--) {
         // We increase the index indicating the newest on level i+1 by one (plus
         // folding)
         newest[i + 1] = (newest[i + 1] + 1) % (m_tau_lin + 1);
         n_vals[i + 1] += 1;
-
-        (*compressA)(A[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     A[i][(newest[i] + 2) % (m_tau_lin + 1)]);
-        (*compressB)(B[i][(newest[i] + 1) % (m_tau_lin + 1)],
-                     B[i][(newest[i] + 2) % (m_tau_lin + 1)]);
       }
       newest[ll] = (newest[ll] + 1) % (m_tau_lin + 1);
 
       // We only need to update correlation estimates for the higher levels
       for (int i = ll + 1; i < highest_level_to_compress + 2; i++) {
-        for (long j = (m_tau_lin + 1) / 2 + 1;
-             j < min(m_tau_lin + 1, n_vals[i]); j++) {
-          auto const index_new = newest[i];
-          auto const index_old =
-              (newest[i] - j + m_tau_lin + 1) % (m_tau_lin + 1);
-          auto const index_res =
-              m_tau_lin + (i - 1) * m_tau_lin / 2 + (j - m_tau_lin / 2 + 1) - 1;
-
-          auto const temp = (corr_operation)(A[i][index_old], B[i][index_new],
-                                             m_correlation_args);
-          assert(temp.size() == m_dim_corr);
-
-          n_sweeps[index_res]++;
-          for (index_type k = 0; k < static_cast<index_type>(m_dim_corr); k++) {
-            result[index_res][k] += temp[k];
-          }
-        }
+        correlate(i, (m_tau_lin + 1) / 2 + 1);
       }
     }
   }
@@ -106,6 +106,7 @@
 
 #include <utils/Vector.hpp>
 
+#include <boost/mpi/communicator.hpp>
 #include <boost/multi_array.hpp>
 #include <boost/serialization/access.hpp>
 
@@ -177,7 +178,9 @@ public:
    *  the correlation estimate is updated.
    *  TODO: Not all correlation estimates have to be updated.
    */
-  void update() override;
+  using AccumulatorBase::update;
+  void update(boost::mpi::communicator const &comm,
+              ObservableSamples &samples) override;
 
   /** At the end of data collection, go through the whole hierarchy and
    *  correlate data left there.
@@ -244,8 +247,10 @@ private:
   std::shared_ptr<Observables::Observable> B_obs;
 
   std::vector<int> tau; ///< time differences
-  boost::multi_array<std::vector<double>, 2> A;
-  boost::multi_array<std::vector<double>, 2> B;
+  /// samples of A, indexed by hierarchy level, ring index and component
+  boost::multi_array<double, 3> A;
+  /// samples of B, indexed by hierarchy level, ring index and component
+  boost::multi_array<double, 3> B;
 
   boost::multi_array<double, 2> result; ///< output quantity
 
@@ -264,14 +269,25 @@ private:
   std::size_t dim_B;                ///< dimensionality of B
   std::vector<std::size_t> m_shape; ///< dimensionality of the correlation
 
-  using correlation_operation_type = std::vector<double> (*)(
-      std::vector<double> const &, std::vector<double> const &,
-      Utils::Vector3d const &);
+  /** Add the correlations of lags <tt>[lag_begin, lag_end)</tt> on
+   *  hierarchy level @p level to the result, using the kernel of the
+   *  correlation operation @p Operation.
+   */
+  template <class Operation>
+  void correlate_level(int level, long lag_begin, long lag_end);
+  /** Correlate the newest sample of @p level with the older ones. */
+  void correlate(int level, long lag_begin);
+  /** Compress the two oldest samples of @p level into the newest
+   *  sample of the next level.
+   */
+  void compress(int level);
+
+  using correlation_function = void (Correlator::*)(int, long, long);
 
-  correlation_operation_type corr_operation;
+  correlation_function m_correlate;
 
-  using compression_function = std::vector<double> (*)(
-      std::vector<double> const &A1, std::vector<double> const &A2);
+  using compression_function = void (*)(double const *A1, double const *A2,
+                                        double *A_compressed, std::size_t dim);
 
   // compression functions
   compression_function compressA;
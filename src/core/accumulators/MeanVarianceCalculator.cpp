@@ -23,6 +23,7 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/mpi/communicator.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
@@ -32,7 +33,13 @@
 #include <vector>
 
 namespace Accumulators {
-void MeanVarianceCalculator::update() { m_acc(m_obs->operator()()); }
+void MeanVarianceCalculator::update(boost::mpi::communicator const &comm,
+                                    ObservableSamples &samples) {
+  auto const &sample = samples(*m_obs, comm);
+  if (comm.rank() == 0) {
+    m_acc(sample);
+  }
+}
 
 std::vector<double> MeanVarianceCalculator::mean() { return m_acc.mean(); }
 
@@ -23,6 +23,8 @@
 #include "observables/Observable.hpp"
 #include <utils/Accumulator.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <memory>
 #include <string>
@@ -38,7 +40,9 @@ public:
                          int delta_N)
       : AccumulatorBase(delta_N), m_obs(obs), m_acc(obs->n_values()) {}
 
-  void update() override;
+  using AccumulatorBase::update;
+  void update(boost::mpi::communicator const &comm,
+              ObservableSamples &samples) override;
   std::vector<double> mean();
   std::vector<double> variance();
   std::vector<double> std_error();
@@ -22,13 +22,20 @@
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
+#include <boost/mpi/communicator.hpp>
 #include <boost/serialization/vector.hpp>
 
 #include <sstream>
 #include <string>
 
 namespace Accumulators {
-void TimeSeries::update() { m_data.emplace_back(m_obs->operator()()); }
+void TimeSeries::update(boost::mpi::communicator const &comm,
+                        ObservableSamples &samples) {
+  auto const &sample = samples(*m_obs, comm);
+  if (comm.rank() == 0) {
+    m_data.emplace_back(sample);
+  }
+}
 
 std::string TimeSeries::get_internal_state() const {
   std::stringstream ss;
@@ -22,6 +22,8 @@
 #include "AccumulatorBase.hpp"
 #include "observables/Observable.hpp"
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <memory>
 #include <string>
@@ -43,7 +45,9 @@ public:
   TimeSeries(std::shared_ptr<Observables::Observable> obs, int delta_N)
       : AccumulatorBase(delta_N), m_obs(std::move(obs)) {}
 
-  void update() override;
+  using AccumulatorBase::update;
+  void update(boost::mpi::communicator const &comm,
+              ObservableSamples &samples) override;
   std::string get_internal_state() const;
   void set_internal_state(std::string const &);
 
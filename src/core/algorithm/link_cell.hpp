@@ -19,10 +19,38 @@
 #ifndef ALGORITHM_LINK_CELL_HPP
 #define ALGORITHM_LINK_CELL_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <unordered_map>
+#include <vector>
 
 namespace Algorithm {
 
+/**
+ * @brief Iterates over all pairs within a cell and
+ *        with its red neighbors.
+ */
+template <typename CellType, typename PairKernel>
+void link_cell_pairs(CellType &cell, PairKernel &&pair_kernel) {
+  for (auto it = cell.particles().begin(); it != cell.particles().end();
+       ++it) {
+    auto &p1 = *it;
+
+    /* Pairs in this cell */
+    for (auto jt = std::next(it); jt != cell.particles().end(); ++jt) {
+      pair_kernel(p1, *jt);
+    }
+
+    /* Pairs with neighbors */
+    for (auto &neighbor : cell.neighbors().red()) {
+      for (auto &p2 : neighbor->particles()) {
+        pair_kernel(p1, p2);
+      }
+    }
+  }
+}
+
 /**
  * @brief Iterates over all particles in the cell range,
  *        and over all pairs within the cells and with
@@ -32,23 +60,63 @@ template <typename CellIterator, typename PairKernel>
 void link_cell(CellIterator first, CellIterator last,
                PairKernel &&pair_kernel) {
   for (; first != last; ++first) {
-    for (auto it = first->particles().begin(); it != first->particles().end();
-         ++it) {
-      auto &p1 = *it;
+    link_cell_pairs(*first, pair_kernel);
+  }
+}
 
-      /* Pairs in this cell */
-      for (auto jt = std::next(it); jt != first->particles().end(); ++jt) {
-        pair_kernel(p1, *jt);
-      }
+/**
+ * @brief Partitions a cell range into colors, such that
+ *        @ref link_cell_pairs can run concurrently on all
+ *        cells of a color.
+ *
+ * A cell and its red neighbors form the footprint of the
+ * cell, i.e. the cells whose particles are visited by
+ * @ref link_cell_pairs. Cells of the same color have
+ * disjoint footprints. Colors are assigned first-fit in
+ * the order of the range, hence the result only depends
+ * on the cells and their neighbors.
+ *
+ * @return Indices of the cells in the range, by color.
+ */
+template <typename CellIterator>
+std::vector<std::vector<std::size_t>> color_cells(CellIterator first,
+                                                  CellIterator last) {
+  std::vector<std::vector<std::size_t>> colors;
+  /* colors already used by a footprint containing the key */
+  std::unordered_map<void const *, std::vector<bool>> used;
 
-      /* Pairs with neighbors */
-      for (auto &neighbor : first->neighbors().red()) {
-        for (auto &p2 : neighbor->particles()) {
-          pair_kernel(p1, p2);
-        }
+  for (std::size_t i = 0; first != last; ++first, ++i) {
+    std::vector<void const *> footprint = {&*first};
+    for (auto const &neighbor : first->neighbors().red()) {
+      footprint.push_back(&*neighbor);
+    }
+
+    auto const is_free = [&footprint, &used](std::size_t color) {
+      return std::none_of(footprint.begin(), footprint.end(),
+                          [&used, color](void const *cell) {
+                            auto const &flags = used[cell];
+                            return color < flags.size() and flags[color];
+                          });
+    };
+    std::size_t color = 0;
+    while (not is_free(color)) {
+      ++color;
+    }
+
+    for (auto const cell : footprint) {
+      auto &flags = used[cell];
+      if (flags.size() <= color) {
+        flags.resize(color + 1, false);
       }
+      flags[color] = true;
     }
+    if (colors.size() <= color) {
+      colors.resize(color + 1);
+    }
+    colors[color].push_back(i);
   }
+
+  return colors;
 }
 } // namespace Algorithm
 
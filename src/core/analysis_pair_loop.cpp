@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "analysis_pair_loop.hpp"
+
+#include "BoxGeometry.hpp"
+#include "cells.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_to_all.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace boost {
+namespace serialization {
+template <class Archive>
+void serialize(Archive &ar, Analysis::PairParticle &p, const unsigned int) {
+  ar &p.pos;
+  ar &p.id;
+  ar &p.type;
+}
+} // namespace serialization
+} // namespace boost
+
+namespace Analysis {
+namespace detail {
+
+bool cell_system_covers(boost::mpi::communicator const &comm, double max_r) {
+  auto const type = cell_structure.decomposition_type();
+  auto const max_range = cell_structure.max_range();
+  /* the hybrid decomposition only finds the pairs of its regular part
+   * up to the regular cutoff */
+  auto const covers =
+      type != CellStructureType::CELL_STRUCTURE_HYBRID and
+      max_r <= *std::min_element(max_range.begin(), max_range.end());
+  return boost::mpi::all_reduce(comm, covers, std::logical_and<bool>());
+}
+
+namespace {
+/** Position folded into the primary box in the periodic directions. */
+Utils::Vector3d fold(Utils::Vector3d pos) {
+  auto const &box_l = box_geo.length();
+  for (unsigned int d = 0; d < 3; d++) {
+    if (box_geo.periodic(d)) {
+      pos[d] -= std::floor(pos[d] / box_l[d]) * box_l[d];
+    }
+  }
+  return pos;
+}
+
+/** Lower bound of the minimum image distance between the folded position
+ *  @p pos and the bounding box [@p lower, @p upper] of folded positions.
+ */
+double box_distance2(Utils::Vector3d const &pos, Utils::Vector3d const &lower,
+                     Utils::Vector3d const &upper) {
+  auto const &box_l = box_geo.length();
+  auto const shear_direction =
+      (box_geo.type() == BoxType::LEES_EDWARDS)
+          ? static_cast<int>(box_geo.lees_edwards_bc().shear_direction)
+          : -1;
+  double dist2 = 0.;
+  for (unsigned int d = 0; d < 3; d++) {
+    // the shear offset changes the image in the shear direction
+    if (static_cast<int>(d) == shear_direction or
+        (lower[d] <= pos[d] and pos[d] <= upper[d])) {
+      continue;
+    }
+    auto dist = (pos[d] < lower[d]) ? lower[d] - pos[d] : pos[d] - upper[d];
+    if (box_geo.periodic(d)) {
+      auto const wrapped = (pos[d] < lower[d]) ? pos[d] + box_l[d] - upper[d]
+                                               : lower[d] + box_l[d] - pos[d];
+      dist = std::min(dist, wrapped);
+    }
+    dist2 += Utils::sqr(dist);
+  }
+  return dist2;
+}
+} // namespace
+
+std::vector<PairParticle>
+exchange_halo(boost::mpi::communicator const &comm,
+              std::vector<PairParticle> const &local, double max_r) {
+  auto const inf = std::numeric_limits<double>::infinity();
+  Utils::Vector3d lower = Utils::Vector3d::broadcast(inf);
+  Utils::Vector3d upper = Utils::Vector3d::broadcast(-inf);
+  for (auto const &p : local) {
+    auto const pos = fold(p.pos);
+    for (unsigned int d = 0; d < 3; d++) {
+      lower[d] = std::min(lower[d], pos[d]);
+      upper[d] = std::max(upper[d], pos[d]);
+    }
+  }
+  std::vector<std::pair<Utils::Vector3d, Utils::Vector3d>> bounding_boxes;
+  boost::mpi::all_gather(comm, std::make_pair(lower, upper), bounding_boxes);
+
+  auto const max_r2 = Utils::sqr(max_r);
+  std::vector<std::vector<PairParticle>> send(comm.size());
+  for (auto const &p : local) {
+    auto const pos = fold(p.pos);
+    for (int rank = 0; rank < comm.size(); ++rank) {
+      auto const &box = bounding_boxes[rank];
+      if (rank != comm.rank() and box.first[0] <= box.second[0] and
+          box_distance2(pos, box.first, box.second) <= max_r2) {
+        send[rank].push_back(p);
+      }
+    }
+  }
+  std::vector<std::vector<PairParticle>> recv;
+  boost::mpi::all_to_all(comm, send, recv);
+
+  auto particles = local;
+  for (auto const &chunk : recv) {
+    particles.insert(particles.end(), chunk.begin(), chunk.end());
+  }
+  return particles;
+}
+
+AnalysisGrid::AnalysisGrid(std::vector<PairParticle> particles,
+                           std::size_t n_local, double max_r) {
+  auto const &box_l = box_geo.length();
+  // not more cells than particles per direction
+  auto const n_max =
+      std::max(1., std::cbrt(static_cast<double>(particles.size())));
+  for (int d = 0; d < 3; d++) {
+    auto const n = std::floor(box_l[d] / max_r);
+    m_cell_grid[d] = static_cast<int>(std::max(1., std::min(n, n_max)));
+  }
+  if (box_geo.type() == BoxType::LEES_EDWARDS) {
+    m_cell_grid[box_geo.lees_edwards_bc().shear_direction] = 1;
+  }
+
+  auto const cell_index = [this, &box_l](Utils::Vector3d const &pos) {
+    std::size_t index = 0;
+    for (int d = 0; d < 3; d++) {
+      auto const n = m_cell_grid[d];
+      auto const folded = pos[d] - std::floor(pos[d] / box_l[d]) * box_l[d];
+      auto const i = std::min(n - 1, static_cast<int>(folded / box_l[d] * n));
+      index = index * static_cast<std::size_t>(n) +
+              static_cast<std::size_t>(i);
+    }
+    return index;
+  };
+
+  // counting sort of the particles by cell
+  auto const n_cells = static_cast<std::size_t>(Utils::product(m_cell_grid));
+  std::vector<std::size_t> cells(particles.size());
+  m_cell_start.assign(n_cells + 1, 0);
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    cells[i] = cell_index(particles[i].pos);
+    m_cell_start[cells[i] + 1]++;
+  }
+  for (std::size_t c = 0; c < n_cells; ++c) {
+    m_cell_start[c + 1] += m_cell_start[c];
+  }
+  auto fill = m_cell_start;
+  m_particles.resize(particles.size());
+  m_local.resize(particles.size());
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    auto const j = fill[cells[i]]++;
+    m_particles[j] = std::move(particles[i]);
+    m_local[j] = (i < n_local) ? 1 : 0;
+  }
+}
+
+std::vector<std::size_t>
+AnalysisGrid::neighbor_cells(std::size_t cell) const {
+  Utils::Vector3i index;
+  for (int d = 2; d >= 0; d--) {
+    auto const n = static_cast<std::size_t>(m_cell_grid[d]);
+    index[d] = static_cast<int>(cell % n);
+    cell /= n;
+  }
+  // distinct offsets per direction, all cells if there are less than three
+  auto const offsets = [this](int d) {
+    switch (m_cell_grid[d]) {
+    case 1:
+      return std::vector<int>{0};
+    case 2:
+      return std::vector<int>{0, 1};
+    default:
+      return std::vector<int>{-1, 0, 1};
+    }
+  };
+  std::vector<std::size_t> neighbors;
+  for (auto const dx : offsets(0)) {
+    for (auto const dy : offsets(1)) {
+      for (auto const dz : offsets(2)) {
+        auto const shifted = Utils::Vector3i{dx, dy, dz} + index;
+        std::size_t neighbor = 0;
+        for (int d = 0; d < 3; d++) {
+          auto const n = m_cell_grid[d];
+          auto const i = (shifted[d] + n) % n;
+          neighbor = neighbor * static_cast<std::size_t>(n) +
+                     static_cast<std::size_t>(i);
+        }
+        neighbors.push_back(neighbor);
+      }
+    }
+  }
+  return neighbors;
+}
+
+} // namespace detail
+} // namespace Analysis
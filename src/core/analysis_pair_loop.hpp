@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_ANALYSIS_PAIR_LOOP_HPP
+#define CORE_ANALYSIS_PAIR_LOOP_HPP
+/** @file
+ *  Distributed pair search for the analysis functions.
+ *
+ *  Pairs within the range of the cell system are taken from the cell system
+ *  itself. Pairs beyond it are searched on a dedicated analysis cell grid,
+ *  which every rank builds from its own selected particles and the ones of
+ *  the other ranks within the pair range, like a ghost layer.
+ */
+
+#include "Particle.hpp"
+#include "cells.hpp"
+#include "event.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace Analysis {
+
+/** Particle data seen by the analysis pair kernels. */
+struct PairParticle {
+  Utils::Vector3d pos;
+  int id;
+  int type;
+};
+
+namespace detail {
+/** Whether all pairs closer than @p max_r are visited by the pair loop of
+ *  the cell system. Collective call.
+ */
+bool cell_system_covers(boost::mpi::communicator const &comm, double max_r);
+
+/** @brief Add the particles of the other ranks within @p max_r of the
+ *  particles of this rank.
+ *
+ *  Every rank sends its particles to the ranks whose particles have a
+ *  bounding box closer than @p max_r. Collective call.
+ *
+ *  @return The particles of this rank followed by the received ones.
+ */
+std::vector<PairParticle>
+exchange_halo(boost::mpi::communicator const &comm,
+              std::vector<PairParticle> const &local, double max_r);
+
+/** @brief Cell grid over the whole box for an analysis range.
+ *
+ *  The cells are at least @c max_r wide, so that the pairs closer than
+ *  @c max_r are in the same or in adjacent cells. Directions with fewer
+ *  than three cells and the shear direction of Lees-Edwards boundary
+ *  conditions are searched in full.
+ */
+class AnalysisGrid {
+public:
+  /** @param particles  particles of this rank followed by the halo
+   *  @param n_local    number of particles of this rank
+   *  @param max_r      pair range
+   */
+  AnalysisGrid(std::vector<PairParticle> particles, std::size_t n_local,
+               double max_r);
+
+  /** Run @p kernel on every pair closer than @p max_r with a particle of
+   *  this rank and a larger id on the second particle. Every pair is
+   *  visited exactly once over all ranks.
+   */
+  template <class Kernel>
+  void for_each_pair(double max_r, Kernel &&kernel) const;
+
+private:
+  std::size_t n_cells() const { return m_cell_start.size() - 1; }
+  /** Distinct cells adjacent to cell @p cell, including itself. */
+  std::vector<std::size_t> neighbor_cells(std::size_t cell) const;
+
+  /** Particles sorted by cell. */
+  std::vector<PairParticle> m_particles;
+  /** Whether each sorted particle belongs to this rank. */
+  std::vector<char> m_local;
+  /** Index of the first particle of each cell, and one past the last. */
+  std::vector<std::size_t> m_cell_start;
+  Utils::Vector3i m_cell_grid;
+};
+
+template <class Kernel>
+void AnalysisGrid::for_each_pair(double max_r, Kernel &&kernel) const {
+  auto const max_r2 = Utils::sqr(max_r);
+  for (std::size_t cell = 0; cell < n_cells(); ++cell) {
+    if (std::none_of(m_local.begin() + m_cell_start[cell],
+                     m_local.begin() + m_cell_start[cell + 1],
+                     [](char local) { return local; })) {
+      continue;
+    }
+    auto const neighbors = neighbor_cells(cell);
+    for (auto i = m_cell_start[cell]; i < m_cell_start[cell + 1]; ++i) {
+      if (not m_local[i]) {
+        continue;
+      }
+      auto const &p1 = m_particles[i];
+      for (auto const neighbor : neighbors) {
+        for (auto j = m_cell_start[neighbor]; j < m_cell_start[neighbor + 1];
+             ++j) {
+          /* a pair of two local particles is visited from the smaller id,
+           * a pair with a halo particle by the rank of the smaller id */
+          auto const &p2 = m_particles[j];
+          if (p2.id <= p1.id) {
+            continue;
+          }
+          auto const dist2 = box_geo.get_mi_vector(p1.pos, p2.pos).norm2();
+          if (dist2 <= max_r2) {
+            kernel(p1, p2, dist2);
+          }
+        }
+      }
+    }
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Run a kernel over the pairs of selected particles closer than
+ * @p max_r.
+ *
+ * Every unordered pair of distinct particles is visited exactly once, on one
+ * of the ranks, with the square of its minimum image distance. Collective
+ * call, the kernel results have to be reduced by the caller.
+ *
+ * @param comm      communicator
+ * @param max_r     pair range
+ * @param select    predicate on the local particles taking part
+ * @param kernel    callable with (PairParticle, PairParticle, double dist2)
+ */
+template <class Selector, class Kernel>
+void analysis_pair_loop(boost::mpi::communicator const &comm, double max_r,
+                        Selector const &select, Kernel &&kernel) {
+  if (detail::cell_system_covers(comm, max_r)) {
+    cells_update_ghosts(global_ghost_flags());
+    auto const max_r2 = Utils::sqr(max_r);
+    cell_structure.non_bonded_loop(
+        [&](Particle const &p1, Particle const &p2, Distance const &d) {
+          if (d.dist2 <= max_r2 and select(p1) and select(p2)) {
+            kernel(PairParticle{p1.pos(), p1.id(), p1.type()},
+                   PairParticle{p2.pos(), p2.id(), p2.type()}, d.dist2);
+          }
+        });
+    return;
+  }
+
+  std::vector<PairParticle> local;
+  for (auto const &p : cell_structure.local_particles()) {
+    if (select(p)) {
+      local.push_back({p.pos(), p.id(), p.type()});
+    }
+  }
+  auto const n_local = local.size();
+  detail::AnalysisGrid const grid(detail::exchange_halo(comm, local, max_r),
+                                  n_local, max_r);
+  grid.for_each_pair(max_r, kernel);
+}
+
+} // namespace Analysis
+
+#endif
@@ -36,11 +36,13 @@
 #include <boost/variant.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -175,6 +177,7 @@ unsigned map_data_parts(unsigned data_parts) {
          | ((DATA_PART_FORCE & data_parts) ? GHOSTTRANS_FORCE : 0u)
 #ifdef BOND_CONSTRAINT
          | ((DATA_PART_RATTLE & data_parts) ? GHOSTTRANS_RATTLE : 0u)
+         | ((DATA_PART_POS_LAST & data_parts) ? GHOSTTRANS_POS_LAST : 0u)
 #endif
          | ((DATA_PART_BONDS & data_parts) ? GHOSTTRANS_BONDS : 0u);
   /* clang-format on */
@@ -184,13 +187,15 @@ void CellStructure::ghosts_count() {
   ghost_communicator(decomposition().exchange_ghosts_comm(),
                      GHOSTTRANS_PARTNUM);
 }
-void CellStructure::ghosts_update(unsigned data_parts) {
+void CellStructure::ghosts_update(unsigned data_parts,
+                                  std::function<bool()> const &overlap) {
   ghost_communicator(decomposition().exchange_ghosts_comm(),
-                     map_data_parts(data_parts));
+                     map_data_parts(data_parts), overlap, nonblocking_ghosts);
 }
-void CellStructure::ghosts_reduce_forces() {
+void CellStructure::ghosts_reduce_forces(
+    std::function<bool()> const &overlap) {
   ghost_communicator(decomposition().collect_ghost_force_comm(),
-                     GHOSTTRANS_FORCE);
+                     GHOSTTRANS_FORCE, overlap, nonblocking_ghosts);
 }
 #ifdef BOND_CONSTRAINT
 void CellStructure::ghosts_reduce_rattle_correction() {
@@ -246,6 +251,7 @@ void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
   }
 
   m_rebuild_verlet_list = true;
+  m_rebuild_compact_particles = true;
   m_le_pos_offset_at_last_resort = box.lees_edwards_bc().pos_offset;
 
 #ifdef ADDITIONAL_CHECKS
@@ -254,6 +260,65 @@ void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
 #endif
 }
 
+std::vector<std::vector<std::size_t>> const &CellStructure::cell_colors() {
+  if (m_rebuild_cell_colors) {
+    auto const cells = local_cells();
+    m_cell_colors =
+        Algorithm::color_cells(boost::make_indirect_iterator(cells.begin()),
+                               boost::make_indirect_iterator(cells.end()));
+
+    /* interior cells only have local cells as red neighbors */
+    std::unordered_set<Cell const *> const local(cells.begin(), cells.end());
+    std::vector<bool> interior(cells.size());
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+      auto const red = cells[i]->neighbors().red();
+      interior[i] = std::all_of(red.begin(), red.end(), [&local](Cell *c) {
+        return local.count(c) != 0;
+      });
+    }
+
+    auto &serial = m_pair_loop_steps[0];
+    auto &by_color = m_pair_loop_steps[1];
+    serial = {};
+    by_color = {};
+    for (auto const part : {true, false}) {
+      for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (interior[i] == part) {
+          serial.cells.push_back({i});
+        }
+      }
+      for (auto const &color : m_cell_colors) {
+        std::vector<std::size_t> step;
+        std::copy_if(color.begin(), color.end(), std::back_inserter(step),
+                     [&](std::size_t i) { return interior[i] == part; });
+        if (not step.empty()) {
+          by_color.cells.push_back(std::move(step));
+        }
+      }
+      if (part) {
+        serial.n_interior = serial.cells.size();
+        by_color.n_interior = by_color.cells.size();
+      }
+    }
+    m_rebuild_cell_colors = false;
+  }
+  return m_cell_colors;
+}
+
+CellStructure::PairLoopSteps const &
+CellStructure::pair_loop_steps(bool threaded) {
+  cell_colors();
+  return m_pair_loop_steps[threaded ? 1 : 0];
+}
+
+CompactParticles &CellStructure::compact_particles() {
+  if (m_rebuild_compact_particles) {
+    m_compact_particles.rebuild(local_cells(), decomposition().ghost_cells());
+    m_rebuild_compact_particles = false;
+  }
+  return m_compact_particles;
+}
+
 void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
                                            BoxGeometry const &box,
                                            LocalBox<double> &local_geo) {
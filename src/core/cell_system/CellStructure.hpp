@@ -33,7 +33,9 @@
 #include "bond_error.hpp"
 #include "cell_system/Cell.hpp"
 #include "cell_system/CellStructureType.hpp"
+#include "cell_system/CompactParticles.hpp"
 #include "ghosts.hpp"
+#include "threads.hpp"
 
 #include <utils/math/sqr.hpp>
 
@@ -45,7 +47,10 @@
 #include <boost/range/algorithm/transform.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <set>
@@ -65,13 +70,16 @@ enum Resort : unsigned {
 enum DataPart : unsigned {
   DATA_PART_NONE = 0u,       /**< Nothing */
   DATA_PART_PROPERTIES = 1u, /**< Particle::p */
-  DATA_PART_POSITION = 2u,   /**< Particle::r */
+  DATA_PART_POSITION = 2u,   /**< Particle::r, except the last position */
   DATA_PART_MOMENTUM = 8u,   /**< Particle::m */
   DATA_PART_FORCE = 16u,     /**< Particle::f */
 #ifdef BOND_CONSTRAINT
   DATA_PART_RATTLE = 32u, /**< Particle::rattle */
 #endif
-  DATA_PART_BONDS = 64u /**< Particle::bonds */
+  DATA_PART_BONDS = 64u, /**< Particle::bonds */
+#ifdef BOND_CONSTRAINT
+  DATA_PART_POS_LAST = 128u, /**< Particle::r::p_last_timestep */
+#endif
 };
 } // namespace Cells
 
@@ -126,6 +134,21 @@ struct MinimalImageDistance {
  *  be stored in separate structures.
  */
 struct CellStructure {
+  /**
+   * @brief Local cells of the non-bonded pair loop, in the order in which
+   *        they are visited.
+   *
+   * Each step is a single cell, or the cells of a color in the threaded
+   * loop. The interior cells, whose pairs do not involve ghost particles,
+   * come first, so that their pairs can be computed during the ghost
+   * update, see @ref short_range_loop.
+   */
+  struct PairLoopSteps {
+    std::vector<std::vector<std::size_t>> cells;
+    /** Number of steps over interior cells */
+    std::size_t n_interior = 0;
+  };
+
 private:
   /** The local id-to-particle index */
   std::vector<Particle *> m_particle_index;
@@ -136,14 +159,38 @@ private:
   /** One of @ref Cells::Resort, announces the level of resort needed.
    */
   unsigned m_resort_particles = Cells::RESORT_NONE;
+  /** The verlet lists are stored in the cells that own the pairs, see
+   *  @ref build_verlet_list */
   bool m_rebuild_verlet_list = true;
-  std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
+  /** Whether the verlet list of a local cell is up to date */
+  std::vector<char> m_verlet_list_valid;
+  /** Local cell indices by color, see @ref Algorithm::color_cells */
+  std::vector<std::vector<std::size_t>> m_cell_colors;
+  /** Pair loop steps, serially and by color */
+  std::array<PairLoopSteps, 2> m_pair_loop_steps;
+  bool m_rebuild_cell_colors = true;
+  /** Structure-of-arrays copy of the particles, see @ref compact_particles */
+  CompactParticles m_compact_particles;
+  bool m_rebuild_compact_particles = true;
   double m_le_pos_offset_at_last_resort = 0.;
 
 public:
   CellStructure(BoxGeometry const &box);
 
   bool use_verlet_list = true;
+  /** Overlap the ghost communication with work that does not depend on
+   *  the ghosts, see @ref ghost_communicator. */
+  bool nonblocking_ghosts = true;
+  /** Run the pair loop color by color, and with central forces on the
+   *  structure-of-arrays copy of the particles, also with a single
+   *  thread, see @ref threaded_pair_loop. */
+  bool always_threaded_pairs = false;
+
+  /** Whether the pair loop runs color by color, which it does with
+   *  several threads or if @ref always_threaded_pairs is set. */
+  bool threaded_pair_loop() const {
+    return always_threaded_pairs or get_n_threads() > 1;
+  }
 
   /**
    * @brief Update local particle index.
@@ -404,13 +451,18 @@ public:
    *
    * @param data_parts Particle parts to update, combination of @ref
    * Cells::DataPart
+   * @param overlap Work done during the update, see @ref ghost_communicator
    */
-  void ghosts_update(unsigned data_parts);
+  void ghosts_update(unsigned data_parts,
+                     std::function<bool()> const &overlap = {});
 
   /**
    * @brief Add forces from ghost particles to real particles.
+   *
+   * @param overlap Work done during the reduction, see @ref
+   * ghost_communicator
    */
-  void ghosts_reduce_forces();
+  void ghosts_reduce_forces(std::function<bool()> const &overlap = {});
 #ifdef BOND_CONSTRAINT
   /**
    * @brief Add rattle corrections from ghost particles to real particles.
@@ -498,6 +550,9 @@ private:
 
     /* Swap in new cell system */
     std::swap(m_decomposition, decomposition);
+    m_rebuild_verlet_list = true;
+    m_rebuild_cell_colors = true;
+    m_rebuild_compact_particles = true;
 
     /* Add particles to new system */
     for (auto &p : Cells::particles(decomposition->local_cells())) {
@@ -566,40 +621,109 @@ private:
             Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
   }
 
-  /** Non-bonded pair loop with verlet lists.
+  /**
+   * @brief Rebuild the verlet list of a cell from the pairs of the
+   *        link cell loop, and run the kernel on the new pairs.
    *
-   * @param pair_kernel Kernel to apply
-   * @param verlet_criterion Filter for verlet lists.
+   * Each pair is stored in the cell that owns it in the link cell loop,
+   * so that the lists can be replayed cell by cell, serially as well
+   * as color by color, see @ref non_bonded_loop_step.
    */
   template <class PairKernel, class VerletCriterion>
-  void verlet_list_loop(PairKernel pair_kernel,
-                        const VerletCriterion &verlet_criterion) {
-    /* In this case the verlet list update is attached to
-     * the pair kernel, and the verlet list is rebuilt as
-     * we go. */
-    if (m_rebuild_verlet_list) {
-      m_verlet_list.clear();
+  static void build_verlet_list(Cell &cell, PairKernel &pair_kernel,
+                                const VerletCriterion &verlet_criterion,
+                                detail::MinimalImageDistance const &df) {
+    cell.m_verlet_list.clear();
+    Algorithm::link_cell_pairs(cell, [&](Particle &p1, Particle &p2) {
+      auto const d = df(p1, p2);
+      if (verlet_criterion(p1, p2, d)) {
+        cell.m_verlet_list.emplace_back(&p1, &p2);
+        pair_kernel(p1, p2, d);
+      }
+    });
+  }
 
-      link_cell([&](Particle &p1, Particle &p2, Distance const &d) {
-        if (verlet_criterion(p1, p2, d)) {
-          m_verlet_list.emplace_back(&p1, &p2);
-          pair_kernel(p1, p2, d);
-        }
-      });
+  /** @brief Run the kernel over the verlet list of a cell. */
+  template <class PairKernel>
+  static void replay_verlet_list(Cell &cell, PairKernel &pair_kernel,
+                                 detail::MinimalImageDistance const &df) {
+    for (auto &pair : cell.m_verlet_list) {
+      pair_kernel(*pair.first, *pair.second, df(*pair.first, *pair.second));
+    }
+  }
+
+public:
+  /**
+   * @brief Structure-of-arrays copy of the local and ghost particles.
+   *
+   * The layout is rebuilt after a resort, the cell indices of the
+   * local cells are the same as in @ref local_cells and @ref
+   * cell_colors. The particle data has to be copied in with
+   * @ref CompactParticles::gather, and the forces accumulated in
+   * the copy added to the particles with
+   * @ref CompactParticles::scatter_forces.
+   */
+  CompactParticles &compact_particles();
 
+  /** Local cell indices by color, rebuilt after a change of the
+   *  particle decomposition, see @ref Algorithm::color_cells.
+   */
+  std::vector<std::vector<std::size_t>> const &cell_colors();
+
+  /** Steps of the non-bonded pair loop, by color if @p threaded.
+   *  Rebuilt together with @ref cell_colors.
+   */
+  PairLoopSteps const &pair_loop_steps(bool threaded);
+
+  /**
+   * @brief Non-bonded pair loop over the local cells of a step of
+   *        @ref pair_loop_steps, with verlet lists if
+   *        @ref use_verlet_list is set.
+   *
+   * The verlet list of a cell is rebuilt on its first visit after a
+   * resort, and replayed afterwards.
+   *
+   * @param pair_kernel Kernel to apply, may only modify the two particles
+   *                    if @p threaded
+   * @param verlet_criterion Filter for verlet lists.
+   * @param cells Indices of the local cells
+   * @param threaded Process the cells concurrently, they have to be of
+   *                 the same color
+   */
+  template <class PairKernel, class VerletCriterion>
+  void non_bonded_loop_step(PairKernel &pair_kernel,
+                            const VerletCriterion &verlet_criterion,
+                            std::vector<std::size_t> const &cells,
+                            bool threaded) {
+    auto const local = local_cells();
+    auto const df = detail::MinimalImageDistance{decomposition().box()};
+    if (m_rebuild_verlet_list) {
+      m_verlet_list_valid.assign(local.size(), false);
       m_rebuild_verlet_list = false;
+    }
+    auto const visit = [&](std::size_t i) {
+      auto const index = cells[i];
+      auto &cell = *local[index];
+      if (not use_verlet_list) {
+        Algorithm::link_cell_pairs(cell, [&](Particle &p1, Particle &p2) {
+          pair_kernel(p1, p2, df(p1, p2));
+        });
+      } else if (m_verlet_list_valid[index]) {
+        replay_verlet_list(cell, pair_kernel, df);
+      } else {
+        build_verlet_list(cell, pair_kernel, verlet_criterion, df);
+        m_verlet_list_valid[index] = true;
+      }
+    };
+    if (threaded) {
+      parallel_for(cells.size(), visit);
     } else {
-      /* In this case the pair kernel is just run over the verlet list. */
-      auto const distance_function =
-          detail::MinimalImageDistance{decomposition().box()};
-      for (auto &pair : m_verlet_list) {
-        pair_kernel(*pair.first, *pair.second,
-                    distance_function(*pair.first, *pair.second));
+      for (std::size_t i = 0; i < cells.size(); ++i) {
+        visit(i);
       }
     }
   }
 
-public:
   /** Non-bonded pair loop.
    * @param pair_kernel Kernel to apply
    */
@@ -615,11 +739,24 @@ public:
   template <class PairKernel, class VerletCriterion>
   void non_bonded_loop(PairKernel pair_kernel,
                        const VerletCriterion &verlet_criterion) {
-    if (use_verlet_list) {
-      verlet_list_loop(pair_kernel, verlet_criterion);
-    } else {
-      /* No verlet lists, just run the kernel with pairs from the cells. */
-      link_cell(pair_kernel);
+    for (auto const &cells : pair_loop_steps(false).cells) {
+      non_bonded_loop_step(pair_kernel, verlet_criterion, cells, false);
+    }
+  }
+
+  /** Non-bonded pair loop distributed over the threads, color by color.
+   *  Each particle receives its pair contributions in the same order for
+   *  any number of threads. Runs serially with a single thread, unless
+   *  @ref always_threaded_pairs is set.
+   * @param pair_kernel Kernel to apply, may only modify the two particles
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void non_bonded_loop_threaded(PairKernel const &pair_kernel,
+                                const VerletCriterion &verlet_criterion) {
+    auto const threaded = threaded_pair_loop();
+    for (auto const &cells : pair_loop_steps(threaded).cells) {
+      non_bonded_loop_step(pair_kernel, verlet_criterion, cells, threaded);
     }
   }
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.hpp"
+
+#include "cell_system/CompactParticles.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "threads.hpp"
+
+#include <utils/Span.hpp>
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+void CompactParticles::rebuild(Utils::Span<Cell *> local_cells,
+                               Utils::Span<Cell *> ghost_cells) {
+  m_particles.clear();
+  m_cell_offsets.assign(1, 0);
+  m_has_exclusions = false;
+  m_verlet_lists_valid = false;
+  std::unordered_map<Cell const *, std::size_t> cell_index;
+
+  for (auto const cells : {local_cells, ghost_cells}) {
+    for (auto const cell : cells) {
+      cell_index[cell] = m_cell_offsets.size() - 1;
+      for (auto &p : cell->particles()) {
+        m_particles.push_back(&p);
+#ifdef EXCLUSIONS
+        m_has_exclusions |= not p.exclusions().empty();
+#endif
+      }
+      m_cell_offsets.push_back(m_particles.size());
+    }
+  }
+
+  m_n_local_cells = local_cells.size();
+  m_neighbor_offsets.assign(1, 0);
+  m_neighbors.clear();
+  for (auto const cell : local_cells) {
+    for (auto const neighbor : cell->neighbors().red()) {
+      m_neighbors.push_back(cell_index.at(neighbor));
+    }
+    m_neighbor_offsets.push_back(m_neighbors.size());
+  }
+
+  auto const n_part = m_particles.size();
+  for (int j = 0; j < 3; j++) {
+    pos[j].resize(n_part);
+    force[j].resize(n_part);
+  }
+  type.resize(n_part);
+  q.assign(n_part, 0.);
+}
+
+void CompactParticles::gather() {
+  parallel_for(m_particles.size(), [this](std::size_t i) {
+    auto const &p = *m_particles[i];
+    for (int j = 0; j < 3; j++) {
+      pos[j][i] = p.pos()[j];
+      force[j][i] = 0.;
+    }
+    type[i] = p.type();
+#ifdef ELECTROSTATICS
+    q[i] = p.q();
+#endif
+  });
+}
+
+void CompactParticles::scatter_forces() const {
+  parallel_for(m_particles.size(), [this](std::size_t i) {
+    auto &p = *m_particles[i];
+    for (int j = 0; j < 3; j++) {
+      p.force()[j] += force[j][i];
+    }
+  });
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_COMPACT_PARTICLES_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_COMPACT_PARTICLES_HPP
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "threads.hpp"
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+/**
+ * @brief Structure-of-arrays copy of the particle data read by the
+ *        central pair forces.
+ *
+ * The particles are stored cell by cell, local cells first, followed
+ * by the ghost cells, so that the particles of a cell form a contiguous
+ * index range and the pair loop streams through a few small arrays
+ * instead of the particle structs.
+ *
+ * The layout refers to the particles by pointer and has to be rebuilt
+ * after each resort, which also invalidates the Verlet lists. Positions,
+ * types and charges are gathered, and forces scattered, once per force
+ * calculation.
+ */
+class CompactParticles {
+public:
+  /**
+   * @brief Rebuild the layout from the cells.
+   *
+   * @param local_cells Local cells, the pair loop runs over them.
+   * @param ghost_cells Ghost cells.
+   */
+  void rebuild(Utils::Span<Cell *> local_cells,
+               Utils::Span<Cell *> ghost_cells);
+
+  /** @brief Copy positions, types and charges from the particles, reset
+   *  forces.
+   */
+  void gather();
+
+  /** @brief Add the accumulated forces to the particles. */
+  void scatter_forces() const;
+
+  /** Number of particles, local and ghost. */
+  std::size_t size() const { return m_particles.size(); }
+  /** Number of local cells. */
+  std::size_t n_local_cells() const { return m_n_local_cells; }
+  /** First particle index of a cell. */
+  std::size_t cell_begin(std::size_t cell) const {
+    return m_cell_offsets[cell];
+  }
+  /** Past-the-end particle index of a cell. */
+  std::size_t cell_end(std::size_t cell) const {
+    return m_cell_offsets[cell + 1];
+  }
+  /** Indices of the red neighbors of a local cell. */
+  Utils::Span<const std::size_t> red_neighbors(std::size_t cell) const {
+    return {m_neighbors.data() + m_neighbor_offsets[cell],
+            m_neighbor_offsets[cell + 1] - m_neighbor_offsets[cell]};
+  }
+  /** Whether any of the particles has exclusions. */
+  bool has_exclusions() const { return m_has_exclusions; }
+
+  /**
+   * @brief Rebuild the Verlet lists of the local particles.
+   *
+   * The candidate pairs are the pairs of the link cell loop, the
+   * partners of a particle are stored in compressed sparse row format
+   * and in the order of the link cell loop. The cells are processed
+   * in parallel, first to count and then to store the partners.
+   *
+   * @param criterion Callable with two particle indices, returns whether
+   *                  the pair is added to the lists.
+   */
+  template <class Criterion>
+  void rebuild_verlet_lists(Criterion const &criterion) {
+    auto const for_each_partner = [this, &criterion](std::size_t cell,
+                                                     std::size_t i,
+                                                     auto const &f) {
+      for (auto j = i + 1; j < cell_end(cell); ++j) {
+        if (criterion(i, j)) {
+          f(j);
+        }
+      }
+      for (auto const neighbor : red_neighbors(cell)) {
+        for (auto j = cell_begin(neighbor); j < cell_end(neighbor); ++j) {
+          if (criterion(i, j)) {
+            f(j);
+          }
+        }
+      }
+    };
+
+    m_verlet_offsets.assign(cell_begin(m_n_local_cells) + 1, 0);
+    parallel_for(m_n_local_cells, [&](std::size_t cell) {
+      for (auto i = cell_begin(cell); i < cell_end(cell); ++i) {
+        for_each_partner(cell, i,
+                         [&](std::size_t) { ++m_verlet_offsets[i + 1]; });
+      }
+    });
+    std::partial_sum(m_verlet_offsets.begin(), m_verlet_offsets.end(),
+                     m_verlet_offsets.begin());
+
+    m_verlet_partners.resize(m_verlet_offsets.back());
+    parallel_for(m_n_local_cells, [&](std::size_t cell) {
+      for (auto i = cell_begin(cell); i < cell_end(cell); ++i) {
+        auto out = m_verlet_partners.begin() +
+                   static_cast<std::ptrdiff_t>(m_verlet_offsets[i]);
+        for_each_partner(cell, i, [&out](std::size_t j) { *out++ = j; });
+      }
+    });
+    m_verlet_lists_valid = true;
+  }
+
+  /** Whether the Verlet lists are up to date with the layout. */
+  bool verlet_lists_valid() const { return m_verlet_lists_valid; }
+  /** Verlet list partners of a local particle. */
+  Utils::Span<const std::size_t> verlet_list(std::size_t i) const {
+    return {m_verlet_partners.data() + m_verlet_offsets[i],
+            m_verlet_offsets[i + 1] - m_verlet_offsets[i]};
+  }
+  /** Number of pairs in the Verlet lists. */
+  std::size_t n_verlet_pairs() const { return m_verlet_partners.size(); }
+
+  /** Particle the compact data of index @p i was gathered from. */
+  Particle const &particle(std::size_t i) const { return *m_particles[i]; }
+
+  /** Position of a particle. */
+  Utils::Vector3d position(std::size_t i) const {
+    return {pos[0][i], pos[1][i], pos[2][i]};
+  }
+
+  /** Positions, by component. */
+  std::array<std::vector<double>, 3> pos;
+  /** Forces, by component. */
+  std::array<std::vector<double>, 3> force;
+  /** Particle types. */
+  std::vector<int> type;
+  /** Particle charges, zero without electrostatics. */
+  std::vector<double> q;
+
+private:
+  std::vector<Particle *> m_particles;
+  std::size_t m_n_local_cells = 0;
+  std::vector<std::size_t> m_cell_offsets = {0};
+  std::vector<std::size_t> m_neighbor_offsets = {0};
+  std::vector<std::size_t> m_neighbors;
+  bool m_has_exclusions = false;
+  std::vector<std::size_t> m_verlet_offsets = {0};
+  std::vector<std::size_t> m_verlet_partners;
+  bool m_verlet_lists_valid = false;
+};
+
+#endif
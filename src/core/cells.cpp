@@ -235,9 +235,12 @@ void check_resort_particles() {
   cell_structure.set_resort_particles(level);
 }
 
-void cells_update_ghosts(unsigned data_parts) {
+unsigned cells_resort_particles(unsigned data_parts) {
   /* data parts that are only updated on resort */
   auto constexpr resort_only_parts =
+#ifdef BOND_CONSTRAINT
+      Cells::DATA_PART_POS_LAST |
+#endif
       Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS;
 
   auto const global_resort =
@@ -264,10 +267,14 @@ void cells_update_ghosts(unsigned data_parts) {
 
     /* Particles are now sorted */
     cell_structure.clear_resort_particles();
-  } else {
-    /* Communication step: ghost information */
-    cell_structure.ghosts_update(data_parts & ~resort_only_parts);
+    return Cells::DATA_PART_NONE;
   }
+  return data_parts & ~resort_only_parts;
+}
+
+void cells_update_ghosts(unsigned data_parts) {
+  /* Communication step: ghost information */
+  cell_structure.ghosts_update(cells_resort_particles(data_parts));
 }
 
 Cell *find_current_cell(Particle const &p) {
@@ -92,6 +92,12 @@ void cells_re_init(CellStructureType new_cs);
  */
 void cells_update_ghosts(unsigned data_parts);
 
+/** Resort the particles if needed on any node, which also updates the
+ *  ghosts, see @ref cells_update_ghosts.
+ *  @return The ghost data parts that still have to be updated.
+ */
+unsigned cells_resort_particles(unsigned data_parts);
+
 /**
  * @brief Get pairs closer than @p distance from the cells.
  *
@@ -48,6 +48,7 @@
 #include "event.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
+#include "threads.hpp"
 #include "tuning.hpp"
 
 #include <utils/Span.hpp>
@@ -71,6 +72,8 @@
 #include <complex>
 #include <cstddef>
 #include <functional>
+#include <iterator>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
 
@@ -280,6 +283,43 @@ CoulombP3M::CoulombP3M(P3MParameters &&parameters, double prefactor,
 }
 
 namespace {
+/** Number of particles whose weights are calculated together. */
+constexpr std::size_t assign_batch_size = 8ul;
+
+/**
+ * @brief Add the charge of one point to a mesh.
+ *
+ * The innermost loop runs over consecutive mesh points of a row.
+ *
+ * @param local_mesh Mesh info.
+ * @param w Interpolation weights of the point.
+ * @param q Charge of the point.
+ * @param mesh Mesh to add to.
+ * @param offset Linear index of the first element of @p mesh.
+ */
+template <int cao>
+void assign_point(P3MLocalMesh const &local_mesh,
+                  InterpolationWeights<cao> const &w, double q, double *mesh,
+                  int offset) {
+  auto const row_stride = local_mesh.dim[2];
+  auto const slab_stride = local_mesh.dim[1] * local_mesh.dim[2];
+
+  Utils::Array<double, cao> q_z;
+  for (int i2 = 0; i2 < cao; i2++) {
+    q_z[i2] = q * w.w_z[i2];
+  }
+
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto const w_xy = w.w_x[i0] * w.w_y[i1];
+      auto *row = mesh + (w.ind - offset + i0 * slab_stride + i1 * row_stride);
+      for (int i2 = 0; i2 < cao; i2++) {
+        row[i2] += w_xy * q_z[i2];
+      }
+    }
+  }
+}
+
 template <std::size_t cao> struct AssignCharge {
   void operator()(p3m_data_struct &p3m, double q,
                   Utils::Vector3d const &real_pos,
@@ -303,12 +343,126 @@ template <std::size_t cao> struct AssignCharge {
         [q, &p3m](int ind, double w) { p3m.rs_mesh[ind] += w * q; });
   }
 
+  /**
+   * @brief Assign the charges of all charged particles.
+   *
+   * The weights are calculated for batches of particles and cached in
+   * particle order. The particles are then sorted by the mesh row of
+   * their first mesh point and assigned in that order. With several
+   * threads, each thread assigns the particles of a contiguous range of
+   * mesh slabs to a private patch of the mesh, and the patches are summed
+   * slab by slab afterwards.
+   */
   void operator()(p3m_data_struct &p3m, ParticleRange const &particles) {
-    for (auto &p : particles) {
+    auto const &local_mesh = p3m.local_mesh;
+    auto &inter_weights = p3m.inter_weights;
+    auto &charges = p3m.ca_charges;
+    auto const row_size = local_mesh.dim[2];
+    auto const slab_size = local_mesh.dim[1] * local_mesh.dim[2];
+
+    /* calculate the weights, a batch of particles at a time */
+    std::vector<int> rows;
+    charges.clear();
+    std::array<Utils::Vector3d, assign_batch_size> positions;
+    std::array<InterpolationWeights<cao>, assign_batch_size> weights;
+    std::size_t n_batch = 0ul;
+    auto const flush = [&]() {
+      p3m_calculate_interpolation_weights<cao, assign_batch_size>(
+          Utils::make_const_span(positions.data(), n_batch), p3m.params.ai,
+          local_mesh, Utils::make_span(weights.data(), n_batch));
+      for (std::size_t j = 0; j < n_batch; j++) {
+        inter_weights.store(weights[j]);
+        rows.push_back(weights[j].ind / row_size);
+      }
+      n_batch = 0ul;
+    };
+    for (auto const &p : particles) {
       if (p.q() != 0.0) {
-        this->operator()(p3m, p.q(), p.pos(), p3m.inter_weights);
+        charges.push_back(p.q());
+        positions[n_batch++] = p.pos();
+        if (n_batch == assign_batch_size) {
+          flush();
+        }
+      }
+    }
+    flush();
+
+    /* counting sort by mesh row */
+    auto const n_part = charges.size();
+    auto const n_slabs = local_mesh.dim[0];
+    std::vector<std::size_t> row_begin(n_slabs * local_mesh.dim[1] + 1, 0ul);
+    for (auto const row : rows) {
+      row_begin[row + 1]++;
+    }
+    std::partial_sum(row_begin.begin(), row_begin.end(), row_begin.begin());
+    auto &order = p3m.ca_order;
+    order.resize(n_part);
+    {
+      auto next = row_begin;
+      for (std::size_t i = 0; i < n_part; i++) {
+        order[next[rows[i]]++] = i;
       }
     }
+    auto const slab_begin = [&](int slab) {
+      return row_begin[slab * local_mesh.dim[1]];
+    };
+
+    auto const n_chunks =
+        static_cast<std::size_t>(std::min(get_n_threads(), n_slabs));
+    if (n_chunks <= 1ul) {
+      for (auto const i : order) {
+        assign_point(local_mesh, inter_weights.load<cao>(i), charges[i],
+                     p3m.rs_mesh.data(), 0);
+      }
+      return;
+    }
+
+    /* split the slabs into chunks with similar numbers of particles */
+    std::vector<int> chunk_begin(n_chunks + 1ul);
+    chunk_begin.front() = 0;
+    chunk_begin.back() = n_slabs;
+    auto slab = 0;
+    for (std::size_t c = 1ul; c < n_chunks; c++) {
+      while (slab < n_slabs and slab_begin(slab) < c * n_part / n_chunks) {
+        ++slab;
+      }
+      chunk_begin[c] = slab;
+    }
+
+    /* the particles of a chunk reach cao - 1 slabs beyond it */
+    p3m.ca_patches.resize(n_chunks);
+    parallel_for(n_chunks, [&](std::size_t c) {
+      auto const first = chunk_begin[c];
+      auto const last = chunk_begin[c + 1ul];
+      auto &patch = p3m.ca_patches[c];
+      patch.clear();
+      if (first == last) {
+        return;
+      }
+      auto const n_patch = std::min(last + static_cast<int>(cao) - 1, n_slabs);
+      patch.assign(static_cast<std::size_t>((n_patch - first) * slab_size), 0.);
+      for (auto k = slab_begin(first); k < slab_begin(last); k++) {
+        auto const i = order[k];
+        assign_point(local_mesh, inter_weights.load<cao>(i), charges[i],
+                     patch.data(), first * slab_size);
+      }
+    });
+
+    auto const n_slab_size = static_cast<std::size_t>(slab_size);
+    parallel_for(static_cast<std::size_t>(n_slabs), [&](std::size_t slab) {
+      auto *out = p3m.rs_mesh.data() + slab * n_slab_size;
+      for (std::size_t c = 0ul; c < n_chunks; c++) {
+        auto const &patch = p3m.ca_patches[c];
+        auto const first = static_cast<std::size_t>(chunk_begin[c]);
+        if (slab < first or (slab - first) * n_slab_size >= patch.size()) {
+          continue;
+        }
+        auto const *in = patch.data() + (slab - first) * n_slab_size;
+        for (int i = 0; i < slab_size; i++) {
+          out[i] += in[i];
+        }
+      }
+    });
   }
 };
 } // namespace
@@ -335,33 +489,82 @@ void CoulombP3M::assign_charge(double q, Utils::Vector3d const &real_pos) {
 }
 
 namespace {
+/**
+ * @brief Interpolate the electric field at one point.
+ *
+ * The partial sums are kept per mesh point of a row, so that the
+ * innermost loop has no dependencies between its iterations.
+ *
+ * @param local_mesh Mesh info.
+ * @param w Interpolation weights of the point.
+ * @param E_mesh Components of the electric field on the mesh.
+ */
+template <int cao>
+Utils::Vector3d
+interpolate_field(P3MLocalMesh const &local_mesh,
+                  InterpolationWeights<cao> const &w,
+                  std::array<fft_vector<double>, 3> const &E_mesh) {
+  auto const row_stride = local_mesh.dim[2];
+  auto const slab_stride = local_mesh.dim[1] * local_mesh.dim[2];
+  auto const *E_x = E_mesh[0].data();
+  auto const *E_y = E_mesh[1].data();
+  auto const *E_z = E_mesh[2].data();
+
+  Utils::Array<double, cao> sum_x{}, sum_y{}, sum_z{};
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto const w_xy = w.w_x[i0] * w.w_y[i1];
+      auto const row = w.ind + i0 * slab_stride + i1 * row_stride;
+      for (int i2 = 0; i2 < cao; i2++) {
+        sum_x[i2] += w_xy * E_x[row + i2];
+        sum_y[i2] += w_xy * E_y[row + i2];
+        sum_z[i2] += w_xy * E_z[row + i2];
+      }
+    }
+  }
+
+  Utils::Vector3d field{};
+  for (int i2 = 0; i2 < cao; i2++) {
+    field[0] += w.w_z[i2] * sum_x[i2];
+    field[1] += w.w_z[i2] * sum_y[i2];
+    field[2] += w.w_z[i2] * sum_z[i2];
+  }
+  return field;
+}
+
 template <std::size_t cao> struct AssignForces {
   void operator()(p3m_data_struct &p3m, double force_prefac,
                   ParticleRange const &particles) const {
-    using Utils::make_const_span;
-    using Utils::Span;
-    using Utils::Vector;
-
     assert(cao == p3m.inter_weights.cao());
 
-    /* charged particle counter */
+    /* index of the first charged particle of each cell in the cache */
+    auto const first_cell = particles.begin().cell();
+    auto const n_cells = static_cast<std::size_t>(
+        std::distance(first_cell, particles.end().cell()));
+    std::vector<std::size_t> cell_offset(n_cells);
     auto p_index = std::size_t{0ul};
+    for (std::size_t c = 0ul; c < n_cells; c++) {
+      cell_offset[c] = p_index;
+      for (auto const &p : first_cell[c]->particles()) {
+        if (p.q() != 0.0) {
+          ++p_index;
+        }
+      }
+    }
+    assert(p_index == p3m.inter_weights.size());
 
-    for (auto &p : particles) {
-      if (p.q() != 0.0) {
-        auto const pref = p.q() * force_prefac;
-        auto const w = p3m.inter_weights.load<cao>(p_index);
-
-        Utils::Vector3d force{};
-        p3m_interpolate(p3m.local_mesh, w, [&force, &p3m](int ind, double w) {
-          force += w * Utils::Vector3d{p3m.E_mesh[0][ind], p3m.E_mesh[1][ind],
-                                       p3m.E_mesh[2][ind]};
-        });
+    parallel_for(n_cells, [&](std::size_t c) {
+      auto p_index = cell_offset[c];
+      for (auto &p : first_cell[c]->particles()) {
+        if (p.q() != 0.0) {
+          auto const pref = p.q() * force_prefac;
+          auto const w = p3m.inter_weights.load<cao>(p_index);
 
-        p.force() -= pref * force;
-        ++p_index;
+          p.force() -= pref * interpolate_field(p3m.local_mesh, w, p3m.E_mesh);
+          ++p_index;
+        }
       }
-    }
+    });
   }
 };
 
@@ -399,6 +602,8 @@ Utils::Vector9d CoulombP3M::p3m_calc_kspace_pressure_tensor() {
     int ind = 0;
     int j[3];
     auto const half_alpha_inv_sq = Utils::sqr(1. / 2. / p3m.params.alpha);
+    auto const half_dim = p3m.fft.ks_half_dim;
+    auto const half_start = p3m.fft.plan[3].start[half_dim];
     for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[RX]; j[0]++) {
       for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[RY]; j[1]++) {
         for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[RZ]; j[2]++) {
@@ -415,8 +620,10 @@ Utils::Vector9d CoulombP3M::p3m_calc_kspace_pressure_tensor() {
 
           if (sqk != 0.) {
             auto const node_k_space_energy =
-                p3m.g_energy[ind] * (Utils::sqr(p3m.rs_mesh[2 * ind]) +
-                                     Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+                fft_ks_multiplicity(p3m.fft, j[half_dim] + half_start) *
+                p3m.g_energy[ind] *
+                (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                 Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
             auto const vterm = -2. * (1. / sqk + half_alpha_inv_sq);
             auto const pref = node_k_space_energy * vterm;
             node_k_space_pressure_tensor[0] += pref * kx * kx; /* sigma_xx */
@@ -490,14 +697,11 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
     }
 
     /* Back FFT force component mesh */
-    auto const check_complex = !p3m.params.tuning;
-    for (int d = 0; d < 3; d++) {
-      fft_perform_back(p3m.E_mesh[d].data(), check_complex, p3m.fft, comm_cart);
-    }
-
-    /* redistribute force component mesh */
     std::array<double *, 3> E_fields = {
         {p3m.E_mesh[0].data(), p3m.E_mesh[1].data(), p3m.E_mesh[2].data()}};
+    fft_perform_back(Utils::make_span(E_fields), p3m.fft, comm_cart);
+
+    /* redistribute force component mesh */
     p3m.sm.spread_grid(Utils::make_span(E_fields), comm_cart,
                        p3m.local_mesh.dim);
 
@@ -517,10 +721,21 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
   /* === k-space energy calculation  === */
   if (energy_flag) {
     auto node_energy = 0.;
-    for (int i = 0; i < p3m.fft.plan[3].new_size; i++) {
-      // Use the energy optimized influence function for energy!
-      node_energy += p3m.g_energy[i] * (Utils::sqr(p3m.rs_mesh[2 * i]) +
-                                        Utils::sqr(p3m.rs_mesh[2 * i + 1]));
+    auto const half_dim = p3m.fft.ks_half_dim;
+    auto const half_start = p3m.fft.plan[3].start[half_dim];
+    int j[3];
+    int ind = 0;
+    for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
+      for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
+        for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
+          // Use the energy optimized influence function for energy!
+          node_energy +=
+              fft_ks_multiplicity(p3m.fft, j[half_dim] + half_start) *
+              p3m.g_energy[ind] * (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                                   Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+          ind++;
+        }
+      }
     }
     node_energy /= 2. * volume;
 
@@ -55,6 +55,8 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 struct p3m_data_struct : public p3m_data_struct_base {
   explicit p3m_data_struct(P3MParameters &&parameters)
@@ -75,6 +77,12 @@ struct p3m_data_struct : public p3m_data_struct_base {
   double square_sum_q = 0.;
 
   p3m_interpolation_cache inter_weights;
+  /** charges of the particles in @ref inter_weights. */
+  std::vector<double> ca_charges;
+  /** order of the charge assignment, sorted by mesh row. */
+  std::vector<std::size_t> ca_order;
+  /** private mesh patches of the threads for charge assignment. */
+  std::vector<std::vector<double>> ca_patches;
 
   /** send/recv mesh sizes */
   p3m_send_mesh sm;
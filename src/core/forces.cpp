@@ -26,17 +26,21 @@
 
 #include "EspressoSystemInterface.hpp"
 
+#include "BoxGeometry.hpp"
 #include "bond_breakage/bond_breakage.hpp"
 #include "cell_system/CellStructure.hpp"
+#include "cell_system/CompactParticles.hpp"
 #include "cells.hpp"
 #include "collision.hpp"
 #include "comfixed_global.hpp"
 #include "communication.hpp"
 #include "constraints.hpp"
 #include "electrostatics/icc.hpp"
+#include "event.hpp"
 #include "electrostatics/p3m_gpu.hpp"
 #include "forcecap.hpp"
 #include "forces_inline.hpp"
+#include "grid.hpp"
 #include "grid_based_algorithms/electrokinetics.hpp"
 #include "grid_based_algorithms/lb_interface.hpp"
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
@@ -50,16 +54,23 @@
 #include "rotation.hpp"
 #include "short_range_loop.hpp"
 #include "thermostat.hpp"
+#include "thermostats/gle_inline.hpp"
 #include "thermostats/langevin_inline.hpp"
+#include "threads.hpp"
 #include "virtual_sites.hpp"
 
+#include <boost/range/irange.hpp>
 #include <boost/variant.hpp>
 
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+
 #include <profiler/profiler.hpp>
 
 #include <cassert>
 #include <cmath>
-#include <random>
+#include <cstddef>
+#include <vector>
 
 /** Initialize the forces for a ghost particle */
 inline ParticleForce init_ghost_force(Particle const &) { return {}; }
@@ -104,10 +115,25 @@ inline ParticleForce thermostat_force(Particle const &p, double time_step,
 #endif
 }
 
+/** Viscoelastic forces of the Prony modes, which are propagated in place */
+inline ParticleForce viscoelastic_force(Particle &p,
+                                        std::vector<double> &factors) {
+#ifdef EXTERNAL_FORCES
+  if (thermo_switch & THERMO_GLE) {
+    if (auto const *const kernel = gle.kernel(p.type())) {
+      return friction_thermo_gle(gle, *kernel, p, factors);
+    }
+  }
+#endif
+  return {};
+}
+
 /** Initialize the forces for a real particle */
-inline ParticleForce init_real_particle_force(Particle const &p,
-                                              double time_step, double kT) {
-  return thermostat_force(p, time_step, kT) + external_force(p);
+inline ParticleForce init_real_particle_force(Particle &p, double time_step,
+                                              double kT,
+                                              std::vector<double> &factors) {
+  return thermostat_force(p, time_step, kT) + external_force(p) +
+         viscoelastic_force(p, factors);
 }
 
 static void init_forces(const ParticleRange &particles,
@@ -125,16 +151,132 @@ static void init_forces(const ParticleRange &particles,
      or zero depending on the thermostat
      set torque to zero for all and rescale quaternions
   */
-  for (auto &p : particles) {
-    p.f = init_real_particle_force(p, time_step, kT);
-  }
+  /* the viscoelastic forces are computed in the same pass, so that each
+     particle is only loaded once */
+  for_each_particle(particles, [time_step, kT](Particle &p) {
+    thread_local std::vector<double> gle_factors;
+    p.f = init_real_particle_force(p, time_step, kT, gle_factors);
+  });
 
   /* initialize ghost forces with zero
      set torque to zero for all and rescale quaternions
   */
-  for (auto &p : ghost_particles) {
-    p.f = init_ghost_force(p);
+  for_each_particle(ghost_particles,
+                    [](Particle &p) { p.f = init_ghost_force(p); });
+}
+
+/** Whether all non-bonded pair forces are central forces that only
+ *  depend on the particle types and charges, see
+ *  @ref calc_central_pair_force_factor. Electrostatics and magnetostatics
+ *  are checked by the caller.
+ */
+static bool only_central_pair_forces() {
+#ifdef DPD
+  if (thermo_switch & THERMO_DPD) {
+    return false;
+  }
+#endif
+#if defined(GAY_BERNE) || defined(THOLE)
+  for (auto const &ia_params : nonbonded_ia_params) {
+#ifdef GAY_BERNE
+    if (ia_params.gay_berne.cut != INACTIVE_CUTOFF) {
+      return false;
+    }
+#endif
+#ifdef THOLE
+    if (ia_params.thole.scaling_coeff != 0. and ia_params.thole.q1q2 != 0.) {
+      return false;
+    }
+#endif
+  }
+#endif
+  return true;
+}
+
+/** Central pair forces between the particle @p i and the particles
+ *  @p partners, in the same order of summation as
+ *  @ref add_non_bonded_pair_force. The forces on the partners are
+ *  accumulated in the compact copy.
+ */
+template <class Partners>
+static void add_central_pair_forces(
+    CompactParticles &cp, BoxGeometry const &box,
+    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel,
+    std::size_t i, Partners const &partners, Utils::Vector3d &force_i) {
+  auto const pos_i = cp.position(i);
+  auto const type_i = cp.type[i];
+  auto const q_i = cp.q[i];
+  for (auto const j : partners) {
+    auto const &ia_params = *get_ia_param(type_i, cp.type[j]);
+    auto const d = box.get_mi_vector(pos_i, cp.position(j));
+    auto const dist = d.norm();
+    Utils::Vector3d f{};
+    if (dist < ia_params.max_cut) {
+      f += calc_central_pair_force_factor(ia_params, dist) * d;
+    }
+    auto const q1q2 = q_i * cp.q[j];
+    if (q1q2 != 0. and coulomb_kernel != nullptr) {
+      f += (*coulomb_kernel)(q1q2, d, dist);
+    }
+    force_i += f;
+    for (int k = 0; k < 3; k++) {
+      cp.force[k][j] -= f[k];
+    }
+  }
+}
+
+/** Non-bonded pair loop for central forces on the structure-of-arrays
+ *  copy of the particles. The cells are processed color by color like
+ *  in the threaded link cell loop, with the pairs from the Verlet lists
+ *  if @ref CellStructure::use_verlet_list is set. The Verlet lists are
+ *  built with the same @p verlet_criterion as the ones of the cell
+ *  structure.
+ */
+static void
+central_pair_loop(CellStructure &cell_structure, CompactParticles &cp,
+                  BoxGeometry const &box,
+                  Coulomb::ShortRangeForceKernel::kernel_type const
+                      *coulomb_kernel,
+                  VerletCriterion<> const &verlet_criterion) {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+  cp.gather();
+  auto const use_verlet_list = cell_structure.use_verlet_list;
+  if (use_verlet_list and not cp.verlet_lists_valid()) {
+    cp.rebuild_verlet_lists(
+        [&cp, &box, &verlet_criterion](std::size_t i, std::size_t j) {
+          auto const &p1 = cp.particle(i);
+          auto const &p2 = cp.particle(j);
+          return verlet_criterion(
+              p1, p2, Distance(box.get_mi_vector(p1.pos(), p2.pos())));
+        });
+  }
+  auto const kernel = [&cp, &box, coulomb_kernel,
+                       use_verlet_list](std::size_t cell) {
+    auto const end = cp.cell_end(cell);
+    for (auto i = cp.cell_begin(cell); i < end; ++i) {
+      Utils::Vector3d force_i{};
+      if (use_verlet_list) {
+        add_central_pair_forces(cp, box, coulomb_kernel, i, cp.verlet_list(i),
+                                force_i);
+      } else {
+        add_central_pair_forces(cp, box, coulomb_kernel, i,
+                                boost::irange(i + 1, end), force_i);
+        for (auto const neighbor : cp.red_neighbors(cell)) {
+          add_central_pair_forces(
+              cp, box, coulomb_kernel, i,
+              boost::irange(cp.cell_begin(neighbor), cp.cell_end(neighbor)),
+              force_i);
+        }
+      }
+      for (int k = 0; k < 3; k++) {
+        cp.force[k][i] += force_i[k];
+      }
+    }
+  };
+  for (auto const &color : cell_structure.cell_colors()) {
+    parallel_for(color.size(), [&](std::size_t c) { kernel(color[c]); });
   }
+  cp.scatter_forces();
 }
 
 void init_forces_ghosts(const ParticleRange &particles) {
@@ -143,82 +285,66 @@ void init_forces_ghosts(const ParticleRange &particles) {
   }
 }
 
-double calc_viscosity(double v2, double eta_a, double vcrit, double aexp, double bexp) {
-  return eta_a / pow((1 + pow(v2 / (vcrit * vcrit), (bexp / 2.0))), aexp);
-}
-
-void viscoelastic_forces(const ParticleRange &particles, double time_step, double kT) {
-    
-  double vmod2 = 0.0;
-  double visc = 0.0;
-  double nu = 0.0;
-  double randomG = 0.0;
-  double omegamod2 = 0.0;
-  double viscr = 0.0;
-  double randomGr = 0.0;
-
-  /*
-    RANDOM NUMBERS NEEDED
-  */
+/** Force contributions after the short-range loop, some of which write to
+ *  ghost particles.
+ */
+static void add_forces_before_ghost_reduction(CellStructure &cell_structure,
+                                              ParticleRange &particles,
+                                              ParticleRange &ghost_particles,
+                                              double time_step) {
+  Constraints::constraints.add_forces(particles, get_sim_time());
 
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::normal_distribution<> gaussianDist(0,1);
+  if (max_oif_objects) {
+    // There are two global quantities that need to be evaluated:
+    // object's surface and object's volume.
+    for (int i = 0; i < max_oif_objects; i++) {
+      auto const area_volume = calc_oif_global(i, cell_structure);
+      if (fabs(area_volume[0]) < 1e-100 && fabs(area_volume[1]) < 1e-100)
+        break;
+      add_oif_global_forces(area_volume, i, cell_structure);
+    }
+  }
 
+  // Must be done here. Forces need to be ghost-communicated
+  immersed_boundaries.volume_conservation(cell_structure);
 
-  for (auto &p : particles) {
-    if (p.visc_gamma()[0] > 0) {
-      /* Computation of velocity modulus squared */
-      vmod2 = 0.0;
-      for (int j = 0; j < 3; j++) {
-        vmod2 += p.v()[j] * p.v()[j];
-      }
+  lb_lbcoupling_calc_particle_lattice_ia(thermo_virtual, particles,
+                                         ghost_particles, time_step);
 
-      /* Update of the viscoelastic force */
-      for (int k = 0; k < p.Nm(); k++) {
-        visc = calc_viscosity(vmod2, p.visc_gamma()[k], p.vcrit()[k], p.aexp()[k], p.bexp()[k]);
-        nu = 1.0 / p.taum()[k];
-        for (int j = 0; j < 3; j++) {
-          if ((!p.is_fixed_along(j)) && thermo_switch) {
-            randomG = gaussianDist(gen);
-            p.visc_force_mat()(k,j) -= ((nu * p.visc_force_mat()(k,j) + p.v()[j]) * time_step + \
-            sqrt(2 * kT * time_step / (visc * p.visc_gamma_vec()[j])) * randomG);
-            /* p.visc_force()[j] = p.visc_force_mat()(k,j); */
-            p.force()[j] += nu * visc * p.visc_gamma_vec()[j] * p.visc_force_mat()(k,j);
-          }
-        }
-      }
+#ifdef CUDA
+  copy_forces_from_GPU(particles, this_node);
+#endif
 
-      if (p.can_rotate()) {
-        /* Computation of angular velocity modulus squared */
-        omegamod2 = 0.0;
-        for (int j = 0; j < 3; j++) {
-          omegamod2 += p.omega()[j] * p.omega()[j];
-        }
+// VIRTUAL_SITES distribute forces
+#ifdef VIRTUAL_SITES
+  virtual_sites()->back_transfer_forces_and_torques();
+#endif
+}
 
-        /* Update the viscoelastic torque */
-        for (int k=0; k < p.Nm(); k++) {
-          if (p.visc_gamma_rot()[k] == 0) p.visc_gamma_rot()[k] = p.visc_gamma()[k];
-          viscr = calc_viscosity(omegamod2, p.visc_gamma_rot()[k], p.omegacrit()[k], p.aexp()[k], p.bexp()[k]);
-          nu = 1.0 / p.taum()[k];
-          for (int j = 0; j < 3; j++) {
-            if (p.can_rotate_around(j) && thermo_switch) {
-              randomGr = gaussianDist(gen);
-              p.visc_torque_mat()(k,j) -= ((nu * p.visc_torque_mat()(k,j) + p.omega()[j]) * time_step + \
-              sqrt(2 * kT * time_step / (viscr * p.visc_gamma_vec()[j])) * randomGr);
-              /* p.visc_torque()[j] = p.visc_torque_mat()(k,j); */
-              p.torque()[j] += nu * viscr * p.visc_gamma_vec()[j] * p.visc_torque_mat()(k,j);
-            }
-          }
-        }
-      }
-    }
+/** Whether the ghost forces can be reduced during the long-range and
+ *  constraint forces, i.e. no later contribution writes to ghost particles
+ *  or transfers the forces of virtual sites.
+ */
+static bool reduce_ghost_forces_early() {
+  if (max_oif_objects or immersed_boundaries.volume_conservation_active() or
+      lattice_switch != ActiveLB::NONE) {
+    return false;
   }
+#ifdef VIRTUAL_SITES
+  if (virtual_sites()->back_transfers_forces()) {
+    return false;
+  }
+#endif
+  return true;
 }
 
 void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
+  // Communication step: resort the particles if needed, the ghost
+  // positions are distributed during the short-range loop
+  auto ghost_parts = cells_resort_particles(global_ghost_flags());
+
   auto &espresso_system = EspressoSystemInterface::Instance();
   espresso_system.update();
 
@@ -232,15 +358,18 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   if (electrostatics_extension) {
     if (auto icc = boost::get<std::shared_ptr<ICCStar>>(
             electrostatics_extension.get_ptr())) {
+      cell_structure.ghosts_update(ghost_parts);
+      ghost_parts = Cells::DATA_PART_NONE;
       (**icc).iteration(cell_structure, particles, ghost_particles);
     }
   }
 #endif
   init_forces(particles, ghost_particles, time_step, kT);
 
-  viscoelastic_forces(particles, time_step, kT);
-
-  calc_long_range_forces(particles);
+  auto const reduce_early = reduce_ghost_forces_early();
+  if (not reduce_early) {
+    calc_long_range_forces(particles);
+  }
 
   auto const elc_kernel = Coulomb::pair_force_elc_kernel();
   auto const coulomb_kernel = Coulomb::pair_force_kernel();
@@ -258,6 +387,26 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
+  /* the pair loop can run on several threads unless the kernel also
+     writes to global state (NpT virial, collision queue) */
+  auto threaded_pairs = integ_switch != INTEG_METHOD_NPT_ISO;
+#ifdef COLLISION_DETECTION
+  threaded_pairs = threaded_pairs and
+                   collision_params.mode == CollisionModeType::OFF;
+#endif
+
+  /* with central pair potentials and plain real-space electrostatics
+     only, the threaded pair loop runs on the structure-of-arrays copy of
+     the particles */
+  auto const central_pairs =
+      threaded_pairs and cell_structure.threaded_pair_loop() and
+      not elc_kernel and not dipoles_kernel and only_central_pair_forces() and
+      not cell_structure.compact_particles().has_exclusions();
+
+  auto const verlet_criterion =
+      VerletCriterion<>{skin, interaction_range(), coulomb_cutoff,
+                        dipole_cutoff, collision_detection_cutoff()};
+
   short_range_loop(
       [coulomb_kernel_ptr = coulomb_kernel.get_ptr()](
           Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
@@ -275,40 +424,36 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
           detect_collision(p1, p2, d.dist2);
 #endif
       },
-      maximal_cutoff(n_nodes), maximal_cutoff_bonded(),
-      VerletCriterion<>{skin, interaction_range(), coulomb_cutoff,
-                        dipole_cutoff, collision_detection_cutoff()});
-
-  Constraints::constraints.add_forces(particles, get_sim_time());
+      central_pairs ? INACTIVE_CUTOFF : maximal_cutoff(n_nodes),
+      maximal_cutoff_bonded(), verlet_criterion, threaded_pairs, ghost_parts);
 
-  if (max_oif_objects) {
-    // There are two global quantities that need to be evaluated:
-    // object's surface and object's volume.
-    for (int i = 0; i < max_oif_objects; i++) {
-      auto const area_volume = calc_oif_global(i, cell_structure);
-      if (fabs(area_volume[0]) < 1e-100 && fabs(area_volume[1]) < 1e-100)
-        break;
-      add_oif_global_forces(area_volume, i, cell_structure);
-    }
+  if (central_pairs) {
+    central_pair_loop(cell_structure, cell_structure.compact_particles(),
+                      box_geo, coulomb_kernel.get_ptr(), verlet_criterion);
   }
 
-  // Must be done here. Forces need to be ghost-communicated
-  immersed_boundaries.volume_conservation(cell_structure);
-
-  lb_lbcoupling_calc_particle_lattice_ia(thermo_virtual, particles,
-                                         ghost_particles, time_step);
-
+  if (reduce_early) {
+    // Communication step: ghost forces, during the forces on the local
+    // particles only
+    auto n_steps = 0;
+    cell_structure.ghosts_reduce_forces([&]() {
+      if (n_steps++ == 0) {
+        calc_long_range_forces(particles);
+      } else {
+        Constraints::constraints.add_forces(particles, get_sim_time());
 #ifdef CUDA
-  copy_forces_from_GPU(particles, this_node);
-#endif
-
-// VIRTUAL_SITES distribute forces
-#ifdef VIRTUAL_SITES
-  virtual_sites()->back_transfer_forces_and_torques();
+        copy_forces_from_GPU(particles, this_node);
 #endif
-
-  // Communication Step: ghost forces
-  cell_structure.ghosts_reduce_forces();
+      }
+      return n_steps < 2;
+    });
+  } else {
+    add_forces_before_ghost_reduction(cell_structure, particles,
+                                      ghost_particles, time_step);
+
+    // Communication step: ghost forces
+    cell_structure.ghosts_reduce_forces();
+  }
 
   // should be pretty late, since it needs to zero out the total force
   comfixed.apply(comm_cart, particles);
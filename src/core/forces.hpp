@@ -46,10 +46,14 @@ void init_forces_ghosts(const ParticleRange &particles);
  *
  *  A short list, what the function is doing:
  *  <ol>
+ *  <li> Resort the particles if needed
  *  <li> Initialize forces
+ *  <li> Calculate non-bonded short range interaction forces of the
+ *       interior cells while the ghosts are updated
  *  <li> Calculate bonded interaction forces
- *  <li> Calculate non-bonded short range interaction forces
- *  <li> Calculate long range interaction forces
+ *  <li> Calculate the remaining non-bonded short range interaction forces
+ *  <li> Calculate long range interaction forces, while the ghost forces
+ *       are reduced if no later contribution writes to ghost particles
  *  </ol>
  */
 void force_calc(CellStructure &cell_structure, double time_step, double kT);
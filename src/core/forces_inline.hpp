@@ -74,12 +74,12 @@
 
 #include <tuple>
 
-inline ParticleForce calc_non_bonded_pair_force(
-    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
-    Utils::Vector3d const &d, double const dist,
-    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
-
-  ParticleForce pf{};
+/** Force factor of the central (radial) pair potentials.
+ *  These only depend on the particle types and on the distance; the
+ *  force on the first particle is the factor times the distance vector.
+ */
+inline double calc_central_pair_force_factor(IA_parameters const &ia_params,
+                                             double const dist) {
   double force_factor = 0;
 /* Lennard-Jones */
 #ifdef LENNARD_JONES
@@ -133,13 +133,23 @@ inline ParticleForce calc_non_bonded_pair_force(
 #ifdef LJCOS2
   force_factor += ljcos2_pair_force_factor(ia_params, dist);
 #endif
-/* Thole damping */
-#ifdef THOLE
-  pf.f += thole_pair_force(p1, p2, ia_params, d, dist, coulomb_kernel);
-#endif
 /* tabulated */
 #ifdef TABULATED
   force_factor += tabulated_pair_force_factor(ia_params, dist);
+#endif
+  return force_factor;
+}
+
+inline ParticleForce calc_non_bonded_pair_force(
+    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
+    Utils::Vector3d const &d, double const dist,
+    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
+
+  ParticleForce pf{};
+  auto const force_factor = calc_central_pair_force_factor(ia_params, dist);
+/* Thole damping */
+#ifdef THOLE
+  pf.f += thole_pair_force(p1, p2, ia_params, d, dist, coulomb_kernel);
 #endif
 /* Gay-Berne */
 #ifdef GAY_BERNE
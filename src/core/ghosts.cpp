@@ -42,6 +42,7 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/request.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/serialization/vector.hpp>
 
@@ -50,6 +51,8 @@
 #include <cstddef>
 #include <functional>
 #include <iterator>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /** Tag for ghosts communications. */
@@ -86,12 +89,63 @@ private:
   std::vector<char> bondbuf; ///< Buffer for bond lists
 };
 
+/**
+ * Work done during a ghost communication, see @ref ghost_communicator.
+ * Forces received for real particles are held back until the work is
+ * done, and then added in the order in which they were received.
+ */
+class OverlapWork {
+public:
+  explicit OverlapWork(std::function<bool()> step)
+      : m_step(std::move(step)), m_done(!m_step) {}
+
+  /** Do a step of the work, returns whether steps remain. */
+  bool step() {
+    if (!m_done && !m_step()) {
+      m_done = true;
+      for (auto &entry : m_forces) {
+        entry.first->f += entry.second;
+      }
+      m_forces.clear();
+    }
+    return !m_done;
+  }
+
+  /** Do the remaining steps of the work. */
+  void finish() {
+    while (step()) {
+    }
+  }
+
+  void add_force(Particle &p, ParticleForce const &f) {
+    if (m_done || p.is_ghost()) {
+      p.f += f;
+    } else {
+      m_forces.emplace_back(&p, f);
+    }
+  }
+
+private:
+  std::function<bool()> m_step;
+  bool m_done;
+  std::vector<std::pair<Particle *, ParticleForce>> m_forces;
+};
+
 static std::size_t calc_transmit_size(unsigned data_parts) {
   std::size_t size = {};
   if (data_parts & GHOSTTRANS_PROPRTS)
     size += Utils::MemcpyOArchive::packing_size<ParticleProperties>();
-  if (data_parts & GHOSTTRANS_POSITION)
-    size += Utils::MemcpyOArchive::packing_size<ParticlePosition>();
+  if (data_parts & GHOSTTRANS_POSITION) {
+    size += Utils::MemcpyOArchive::packing_size<Utils::Vector3d>();
+    size += Utils::MemcpyOArchive::packing_size<Utils::Vector3i>();
+#ifdef ROTATION
+    size += Utils::MemcpyOArchive::packing_size<Utils::Quaternion<double>>();
+#endif
+  }
+#ifdef BOND_CONSTRAINT
+  if (data_parts & GHOSTTRANS_POS_LAST)
+    size += Utils::MemcpyOArchive::packing_size<Utils::Vector3d>();
+#endif
   if (data_parts & GHOSTTRANS_MOMENTUM)
     size += Utils::MemcpyOArchive::packing_size<ParticleMomentum>();
   if (data_parts & GHOSTTRANS_FORCE)
@@ -142,12 +196,20 @@ static void prepare_send_buffer(CommBuf &send_buffer,
           archiver << part.p;
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          /* ok, this is not nice, but perhaps fast */
-          auto pp = part.r;
-          pp.p += ghost_comm.shift;
-          fold_position(pp.p, pp.i, ::box_geo);
-          archiver << pp;
+          auto pos = part.pos() + ghost_comm.shift;
+          auto image_box = part.image_box();
+          fold_position(pos, image_box, ::box_geo);
+          archiver << pos;
+          archiver << image_box;
+#ifdef ROTATION
+          archiver << part.quat();
+#endif
+        }
+#ifdef BOND_CONSTRAINT
+        if (data_parts & GHOSTTRANS_POS_LAST) {
+          archiver << part.pos_last_time_step();
         }
+#endif
         if (data_parts & GHOSTTRANS_MOMENTUM) {
           archiver << part.m;
         }
@@ -207,8 +269,17 @@ static void put_recv_buffer(CommBuf &recv_buffer,
           archiver >> part.p;
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          archiver >> part.r;
+          archiver >> part.pos();
+          archiver >> part.image_box();
+#ifdef ROTATION
+          archiver >> part.quat();
+#endif
         }
+#ifdef BOND_CONSTRAINT
+        if (data_parts & GHOSTTRANS_POS_LAST) {
+          archiver >> part.pos_last_time_step();
+        }
+#endif
         if (data_parts & GHOSTTRANS_MOMENTUM) {
           archiver >> part.m;
         }
@@ -258,20 +329,39 @@ add_rattle_correction_from_recv_buffer(CommBuf &recv_buffer,
 #endif
 
 static void add_forces_from_recv_buffer(CommBuf &recv_buffer,
-                                        const GhostCommunication &ghost_comm) {
+                                        const GhostCommunication &ghost_comm,
+                                        OverlapWork &work) {
   /* put back data */
   auto archiver = Utils::MemcpyIArchive{Utils::make_span(recv_buffer)};
   for (auto &part_list : ghost_comm.part_lists) {
     for (Particle &part : *part_list) {
       ParticleForce pf;
       archiver >> pf;
-      part.f += pf;
+      work.add_force(part, pf);
     }
   }
 }
 
+/** Write back received data of a single-node or multi-node operation.
+ *  Forces have to be added, the rest overwritten. Exception is RDCE,
+ *  where the addition is integrated into the communication.
+ */
+static void apply_recv_buffer(CommBuf &recv_buffer,
+                              const GhostCommunication &ghost_comm,
+                              int comm_type, unsigned int data_parts,
+                              OverlapWork &work) {
+  if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
+    add_forces_from_recv_buffer(recv_buffer, ghost_comm, work);
+#ifdef BOND_CONSTRAINT
+  else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
+    add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
+#endif
+  else
+    put_recv_buffer(recv_buffer, ghost_comm, data_parts);
+}
+
 static void cell_cell_transfer(const GhostCommunication &ghost_comm,
-                               unsigned int data_parts) {
+                               unsigned int data_parts, OverlapWork &work) {
   /* transfer data */
   auto const offset = ghost_comm.part_lists.size() / 2;
   for (std::size_t pl = 0; pl < offset; pl++) {
@@ -296,16 +386,23 @@ static void cell_cell_transfer(const GhostCommunication &ghost_comm,
           part2.bonds() = part1.bonds();
         }
         if (data_parts & GHOSTTRANS_POSITION) {
-          /* ok, this is not nice, but perhaps fast */
-          part2.r = part1.r;
-          part2.pos() += ghost_comm.shift;
+          part2.pos() = part1.pos() + ghost_comm.shift;
+          part2.image_box() = part1.image_box();
           fold_position(part2.pos(), part2.image_box(), ::box_geo);
+#ifdef ROTATION
+          part2.quat() = part1.quat();
+#endif
+        }
+#ifdef BOND_CONSTRAINT
+        if (data_parts & GHOSTTRANS_POS_LAST) {
+          part2.pos_last_time_step() = part1.pos_last_time_step();
         }
+#endif
         if (data_parts & GHOSTTRANS_MOMENTUM) {
           part2.m = part1.m;
         }
         if (data_parts & GHOSTTRANS_FORCE)
-          part2.f += part1.f;
+          work.add_force(part2, part1.f);
 #ifdef BOND_CONSTRAINT
         if (data_parts & GHOSTTRANS_RATTLE)
           part2.rattle_params() += part1.rattle_params();
@@ -342,9 +439,130 @@ static bool is_poststorable(GhostCommunication const &ghost_comm,
   return is_recv_op(comm_type, node, this_node) && poststore;
 }
 
-void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
-  if (GHOSTTRANS_NONE == data_parts)
+/** Whether a communication can be done with non-blocking point-to-point
+ *  messages. The bond lists have a variable size and need the blocking
+ *  protocol. This does not depend on the prefetch and poststore flags,
+ *  which may differ between sender and receiver.
+ */
+static bool is_nonblocking(GhostCommunication const &ghost_comm,
+                           unsigned int data_parts) {
+  int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+  return (comm_type == GHOST_SEND || comm_type == GHOST_RECV ||
+          comm_type == GHOST_LOCL) &&
+         !(data_parts & GHOSTTRANS_BONDS);
+}
+
+/**
+ * @brief Wait for a request, doing steps of the work in the meantime.
+ */
+template <class Request>
+static void wait_with_work(Request &request, OverlapWork &work) {
+  while (!request.test()) {
+    if (!work.step()) {
+      request.wait();
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Do the communications [first, last) with non-blocking messages.
+ *
+ * All receives are posted at once. The sends and local transfers are done
+ * in the order of the communications, each one as soon as the cells it
+ * reads have been received, e.g. the sends of the second Cartesian axis
+ * wait for the ghost layers of the first one. The received data is written
+ * back in the order of the communications, so that the result is the same
+ * as with the blocking protocol. Steps of the work are done whenever a
+ * message has not arrived yet.
+ */
+template <class Iterator>
+static void nonblocking_communications(boost::mpi::communicator const &comm,
+                                       Iterator first, Iterator last,
+                                       unsigned int data_parts,
+                                       OverlapWork &work) {
+  static std::vector<CommBuf> buffers;
+  static std::vector<boost::mpi::request> recv_requests;
+  static std::vector<boost::mpi::request> send_requests;
+  /* last receive into a cell so far */
+  static std::unordered_map<ParticleList const *, std::size_t> received;
+
+  auto const n_comms = static_cast<std::size_t>(std::distance(first, last));
+  if (buffers.size() < n_comms)
+    buffers.resize(n_comms);
+  recv_requests.assign(n_comms, boost::mpi::request{});
+  send_requests.clear();
+  received.clear();
+
+  for (std::size_t i = 0; i < n_comms; ++i) {
+    auto const &ghost_comm = first[i];
+    if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_RECV) {
+      prepare_recv_buffer(buffers[i], ghost_comm, data_parts);
+      recv_requests[i] =
+          comm.irecv(ghost_comm.node, REQ_GHOST_SEND, buffers[i].data(),
+                     static_cast<int>(buffers[i].size()));
+    }
+  }
+
+  /* the receives [0, n_applied) are written back */
+  std::size_t n_applied = 0;
+  auto const apply_until = [&](std::size_t end) {
+    for (; n_applied < end; ++n_applied) {
+      auto const &ghost_comm = first[n_applied];
+      if ((ghost_comm.type & GHOST_JOBMASK) == GHOST_RECV) {
+        wait_with_work(recv_requests[n_applied], work);
+        apply_recv_buffer(buffers[n_applied], ghost_comm, GHOST_RECV,
+                          data_parts, work);
+      }
+    }
+  };
+
+  for (std::size_t i = 0; i < n_comms; ++i) {
+    auto const &ghost_comm = first[i];
+    int const comm_type = ghost_comm.type & GHOST_JOBMASK;
+    if (comm_type == GHOST_RECV) {
+      for (auto const part_list : ghost_comm.part_lists) {
+        received[part_list] = i;
+      }
+      continue;
+    }
+
+    /* write back the receives into the cells of this communication */
+    auto depends_on = n_applied;
+    for (auto const part_list : ghost_comm.part_lists) {
+      auto const it = received.find(part_list);
+      if (it != received.end()) {
+        depends_on = std::max(depends_on, it->second + 1);
+      }
+    }
+    apply_until(depends_on);
+
+    if (comm_type == GHOST_SEND) {
+      prepare_send_buffer(buffers[i], ghost_comm, data_parts);
+      send_requests.push_back(
+          comm.isend(ghost_comm.node, REQ_GHOST_SEND, buffers[i].data(),
+                     static_cast<int>(buffers[i].size())));
+    } else {
+      cell_cell_transfer(ghost_comm, data_parts, work);
+    }
+  }
+  apply_until(n_comms);
+
+  for (auto &request : send_requests) {
+    wait_with_work(request, work);
+  }
+}
+
+void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts,
+                        std::function<bool()> const &overlap,
+                        bool nonblocking) {
+  OverlapWork work{overlap};
+  if (!nonblocking)
+    work.finish();
+  if (GHOSTTRANS_NONE == data_parts) {
+    work.finish();
     return;
+  }
 
   static CommBuf send_buffer, recv_buffer;
 
@@ -355,8 +573,21 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
     const GhostCommunication &ghost_comm = *it;
     int const comm_type = ghost_comm.type & GHOST_JOBMASK;
 
+    if (nonblocking && is_nonblocking(ghost_comm, data_parts)) {
+      auto const last = std::find_if(
+          it, gcr.communications.end(), [data_parts](auto const &other) {
+            return !is_nonblocking(other, data_parts);
+          });
+      nonblocking_communications(comm, it, last, data_parts, work);
+      it = std::prev(last);
+      continue;
+    }
+
+    /* the blocking protocol reads and writes any particle */
+    work.finish();
+
     if (comm_type == GHOST_LOCL) {
-      cell_cell_transfer(ghost_comm, data_parts);
+      cell_cell_transfer(ghost_comm, data_parts, work);
       continue;
     }
 
@@ -432,16 +663,8 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
     // recv op; write back data directly, if no PSTSTORE delay is requested.
     if (is_recv_op(comm_type, node, comm.rank())) {
       if (!poststore) {
-        /* forces have to be added, the rest overwritten. Exception is RDCE,
-         * where the addition is integrated into the communication. */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
-#endif
-        else
-          put_recv_buffer(recv_buffer, ghost_comm, data_parts);
+        apply_recv_buffer(recv_buffer, ghost_comm, comm_type, data_parts,
+                          work);
       }
     } else if (poststore) {
       /* send op; write back delayed data from last recv, when this was a
@@ -456,17 +679,11 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
       if (poststore_ghost_comm != gcr.communications.rend()) {
         assert(recv_buffer.size() ==
                calc_transmit_size(*poststore_ghost_comm, data_parts));
-        /* as above */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, *poststore_ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer,
-                                                 *poststore_ghost_comm);
-#endif
-        else
-          put_recv_buffer(recv_buffer, *poststore_ghost_comm, data_parts);
+        apply_recv_buffer(recv_buffer, *poststore_ghost_comm, comm_type,
+                          data_parts, work);
       }
     }
   }
+
+  work.finish();
 }
@@ -42,7 +42,10 @@
  *  determined by their type) and a list of ghost communications. The data
  *  types are described by the particle data classes:
  *  - @ref GHOSTTRANS_PROPRTS transfers the @ref ParticleProperties
- *  - @ref GHOSTTRANS_POSITION transfers the @ref ParticlePosition
+ *  - @ref GHOSTTRANS_POSITION transfers the position, image box and
+ *    orientation of the @ref ParticlePosition
+ *  - @ref GHOSTTRANS_POS_LAST transfers the position at the previous
+ *    time step, which is only read by RATTLE
  *  - @ref GHOSTTRANS_MOMENTUM transfers the @ref ParticleMomentum
  *  - @ref GHOSTTRANS_FORCE transfers the @ref ParticleForce
  *  - @ref GHOSTTRANS_RATTLE transfers the @ref ParticleRattle
@@ -81,6 +84,14 @@
  *  The pststore is similar and postpones the write back of received data
  *  until a send operation (with a precreated send buffer) is finished.
  *
+ *  Consecutive @ref GHOST_SEND, @ref GHOST_RECV and @ref GHOST_LOCL
+ *  operations are done with non-blocking messages: all receives are posted
+ *  at once, and each send as soon as the cells it forwards have been
+ *  received, e.g. the corners of the second and third Cartesian axis.
+ *  Meanwhile, the caller can do work that does not depend on the ghosts,
+ *  see @ref ghost_communicator. Bond lists are always transferred with the
+ *  blocking protocol.
+ *
  *  The ghost communicators are created by the cell systems.
  */
 #include "ParticleList.hpp"
@@ -90,6 +101,7 @@
 #include <boost/mpi/communicator.hpp>
 
 #include <cstddef>
+#include <functional>
 #include <utility>
 #include <vector>
 
@@ -121,7 +133,7 @@ enum : unsigned {
   GHOSTTRANS_NONE = 0u,
   /// transfer \ref ParticleProperties
   GHOSTTRANS_PROPRTS = 1u,
-  /// transfer \ref ParticlePosition
+  /// transfer \ref ParticlePosition, except the last position
   GHOSTTRANS_POSITION = 2u,
   /// transfer \ref ParticleMomentum
   GHOSTTRANS_MOMENTUM = 8u,
@@ -133,7 +145,11 @@ enum : unsigned {
 #endif
   /// resize the receiver particle arrays to the size of the senders
   GHOSTTRANS_PARTNUM = 64u,
-  GHOSTTRANS_BONDS = 128u
+  GHOSTTRANS_BONDS = 128u,
+#ifdef BOND_CONSTRAINT
+  /// transfer \ref ParticlePosition::p_last_timestep
+  GHOSTTRANS_POS_LAST = 256u,
+#endif
 };
 
 struct GhostCommunication {
@@ -165,7 +181,22 @@ struct GhostCommunicator {
 
 /**
  * @brief Do a ghost communication with caller specified data parts.
+ *
+ * The work @p overlap is done in steps while non-blocking messages are in
+ * flight, each call does one step and returns whether steps remain. All
+ * steps are done before the function returns. The work may not read data
+ * written by the communication, nor write data read by it, except for the
+ * forces of real particles: received forces are added to those after the
+ * work, so that the result is the same as with the blocking protocol.
+ *
+ * @param gcr          Ghost communicator
+ * @param data_parts   Particle parts to transfer
+ * @param overlap      Work to do during the communication
+ * @param nonblocking  Use non-blocking messages where possible, otherwise
+ *                     the work is done before the blocking protocol
  */
-void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts);
+void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts,
+                        std::function<bool()> const &overlap = {},
+                        bool nonblocking = true);
 
 #endif
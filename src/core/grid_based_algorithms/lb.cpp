@@ -63,6 +63,7 @@
 #include <cinttypes>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
@@ -192,6 +193,24 @@ std::vector<LB_FluidNode> lbfields;
 
 HaloCommunicator update_halo_comm = HaloCommunicator(0);
 
+LBKernel lb_kernel = LBKernel::REFERENCE;
+
+/** Local fluid nodes in memory order */
+static std::vector<LBFluidNodeEntry> lb_fluid_nodes;
+
+std::vector<LBFluidNodeEntry> const &lb_get_fluid_nodes() {
+  return lb_fluid_nodes;
+}
+
+#ifdef LB_BOUNDARIES
+/** Links of all boundary nodes, in memory order of the boundary nodes */
+static std::vector<LBBoundaryLink> lb_boundary_links;
+
+std::vector<LBBoundaryLink> const &lb_get_boundary_links() {
+  return lb_boundary_links;
+}
+#endif // LB_BOUNDARIES
+
 /**
  * @brief Initialize fluid nodes.
  * @param[out] lb_fields      Vector containing the fluid nodes
@@ -209,24 +228,44 @@ void lb_initialize_fields(std::vector<LB_FluidNode> &lb_fields,
 #endif // LB_BOUNDARIES
   }
   on_lbboundary_change();
+  lb_init_node_lists();
 }
 
-/** (Re-)allocate memory for the fluid and initialize pointers. */
+/** (Re-)allocate memory for the fluid and initialize pointers.
+ *  The in-place kernel doesn't need the post-collision populations.
+ */
 void lb_realloc_fluid(LB_FluidData &lb_fluid_a, LB_FluidData &lb_fluid_b,
-                      const Lattice::index_t halo_grid_volume,
+                      const Lattice::index_t halo_grid_volume, LBKernel kernel,
                       LB_Fluid &lb_fluid, LB_Fluid &lb_fluid_post) {
   const std::array<int, 2> size = {{D3Q19::n_vel, halo_grid_volume}};
+  const std::array<int, 2> size_post = {
+      {D3Q19::n_vel, (kernel == LBKernel::IN_PLACE) ? 0 : halo_grid_volume}};
 
   lb_fluid_a.resize(size);
-  lb_fluid_b.resize(size);
+  lb_fluid_b.resize(size_post);
 
   using Utils::Span;
   for (int i = 0; i < size[0]; i++) {
     lb_fluid[i] = Span<double>(lb_fluid_a[i].origin(), size[1]);
-    lb_fluid_post[i] = Span<double>(lb_fluid_b[i].origin(), size[1]);
+    lb_fluid_post[i] = Span<double>(lb_fluid_b[i].origin(), size_post[1]);
   }
 }
 
+void lb_set_kernel(LBKernel kernel) {
+  auto const was_in_place = (lb_kernel == LBKernel::IN_PLACE);
+  lb_kernel = kernel;
+  if (was_in_place == (kernel == LBKernel::IN_PLACE) ||
+      lbfluid_a.num_elements() == 0) {
+    return;
+  }
+  /* keep the current populations in the first array */
+  if (lbfluid[0].data() != lbfluid_a.origin()) {
+    lbfluid_a = lbfluid_b;
+  }
+  lb_realloc_fluid(lbfluid_a, lbfluid_b, lblattice.halo_grid_volume,
+                   lb_kernel, lbfluid, lbfluid_post);
+}
+
 void lb_set_equilibrium_populations(const Lattice &lb_lattice,
                                     const LB_Parameters &lb_parameters) {
   for (Lattice::index_t index = 0; index < lb_lattice.halo_grid_volume;
@@ -256,8 +295,8 @@ void lb_init(const LB_Parameters &lb_parameters) {
   }
 
   /* allocate memory for data structures */
-  lb_realloc_fluid(lbfluid_a, lbfluid_b, lblattice.halo_grid_volume, lbfluid,
-                   lbfluid_post);
+  lb_realloc_fluid(lbfluid_a, lbfluid_b, lblattice.halo_grid_volume,
+                   lb_kernel, lbfluid, lbfluid_post);
 
   lb_initialize_fields(lbfields, lbpar, lblattice);
 
@@ -883,6 +922,93 @@ auto lb_next_offsets(const Lattice &lb_lattice,
   return offsets;
 }
 
+/** Entry of the local fluid node at (x, y, z) in @ref lb_fluid_nodes */
+static LBFluidNodeEntry
+lb_fluid_node_entry(int x, int y, int z,
+                    std::array<std::ptrdiff_t, 19> const &next) {
+  auto const &grid = lblattice.grid;
+  auto const index = get_linear_index(x, y, z, lblattice.halo_grid);
+  /* the link is streamed by this node if the other node is visited
+   * before, or never (halo and boundary nodes) */
+  std::uint32_t swap_links = 0u;
+  for (int i = 1; i < 19; i++) {
+    auto const ci = D3Q19::c[i];
+    auto const to_halo = x + ci[0] < 1 || x + ci[0] > grid[0] ||
+                         y + ci[1] < 1 || y + ci[1] > grid[1] ||
+                         z + ci[2] < 1 || z + ci[2] > grid[2];
+    auto swap = to_halo || next[i] < 0;
+#ifdef LB_BOUNDARIES
+    swap = swap || lbfields[index + next[i]].boundary;
+#endif // LB_BOUNDARIES
+    if (swap) {
+      swap_links |= 1u << i;
+    }
+  }
+  return {index, swap_links};
+}
+
+/** Call @p kernel with the entry of every local fluid node, in memory
+ *  order, see @ref lb_init_node_lists.
+ */
+template <class Kernel> static void lb_for_each_fluid_node(Kernel &&kernel) {
+  for (auto const &node : lb_fluid_nodes) {
+    kernel(node);
+  }
+}
+
+#ifdef LB_BOUNDARIES
+/** Append the links of the boundary node at (x, y, z), halo included, to
+ *  local nodes.
+ */
+static void lb_add_boundary_links(std::vector<LBBoundaryLink> &links, int x,
+                                  int y, int z,
+                                  std::array<std::ptrdiff_t, 19> const &next) {
+  auto const &grid = lblattice.grid;
+  auto const k = get_linear_index(x, y, z, lblattice.halo_grid);
+  for (int i = 0; i < 19; i++) {
+    auto const ci = D3Q19::c[i];
+    if (x - ci[0] > 0 && x - ci[0] < grid[0] + 1 && y - ci[1] > 0 &&
+        y - ci[1] < grid[1] + 1 && z - ci[2] > 0 && z - ci[2] < grid[2] + 1) {
+      links.push_back({k, i, !lbfields[k - next[i]].boundary});
+    }
+  }
+}
+#endif // LB_BOUNDARIES
+
+void lb_init_node_lists() {
+  auto const &grid = lblattice.grid;
+  auto const next = lb_next_offsets(lblattice, D3Q19::c);
+
+  lb_fluid_nodes.clear();
+  for (int z = 1; z <= grid[2]; z++) {
+    for (int y = 1; y <= grid[1]; y++) {
+      for (int x = 1; x <= grid[0]; x++) {
+#ifdef LB_BOUNDARIES
+        if (lbfields[get_linear_index(x, y, z, lblattice.halo_grid)]
+                .boundary) {
+          continue;
+        }
+#endif // LB_BOUNDARIES
+        lb_fluid_nodes.push_back(lb_fluid_node_entry(x, y, z, next));
+      }
+    }
+  }
+
+#ifdef LB_BOUNDARIES
+  lb_boundary_links.clear();
+  for (int z = 0; z < grid[2] + 2; z++) {
+    for (int y = 0; y < grid[1] + 2; y++) {
+      for (int x = 0; x < grid[0] + 2; x++) {
+        if (lbfields[get_linear_index(x, y, z, lblattice.halo_grid)]
+                .boundary) {
+          lb_add_boundary_links(lb_boundary_links, x, y, z, next);
+        }
+      }
+    }
+  }
+#endif // LB_BOUNDARIES
+}
+
 template <typename T>
 void lb_stream(LB_Fluid &lb_fluid, const std::array<T, 19> &populations,
                std::size_t index,
@@ -892,74 +1018,341 @@ void lb_stream(LB_Fluid &lb_fluid, const std::array<T, 19> &populations,
   }
 }
 
-/* Collisions and streaming (push scheme) */
-void lb_integrate() {
-  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
-  /* loop over all lattice cells (halo excluded) */
-#ifdef LB_BOUNDARIES
-  for (auto &lbboundary : LBBoundaries::lbboundaries) {
-    (*lbboundary).reset_force();
-  }
-#endif // LB_BOUNDARIES
+/** Collisions and streaming of one node at a time (push scheme) */
+static void
+lb_collide_stream_nodes(std::array<std::ptrdiff_t, 19> const &next_offsets) {
+  /* loop over the fluid nodes */
+  lb_for_each_fluid_node([&next_offsets](LBFluidNodeEntry const &node) {
+    auto const index = node.index;
 
-  auto const next_offsets = lb_next_offsets(lblattice, D3Q19::c);
+    /* calculate modes locally */
+    auto const modes = lb_calc_modes(index, lbfluid);
+
+    /* deterministic collisions */
+    auto const relaxed_modes =
+        lb_relax_modes(modes, lbfields[index].force_density, lbpar);
+
+    /* fluctuating hydrodynamics */
+    auto const thermalized_modes =
+        lb_thermalize_modes(index, relaxed_modes, lbpar, rng_counter_fluid);
+
+    /* apply forces */
+    auto const modes_with_forces = lb_apply_forces(
+        thermalized_modes, lbpar, lbfields[index].force_density);
+
+#ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
+    // Safeguard the node forces so that we can later use them for the IBM
+    // particle update
+    lbfields[index].force_density_buf = lbfields[index].force_density;
+#endif
 
-  Lattice::index_t index = lblattice.halo_offset;
-  for (int z = 1; z <= lblattice.grid[2]; z++) {
-    for (int y = 1; y <= lblattice.grid[1]; y++) {
-      for (int x = 1; x <= lblattice.grid[0]; x++) {
-        // as we only want to apply this to non-boundary nodes we can throw out
-        // the if-clause if we have a non-bounded domain
+    /* reset the force density */
+    lbfields[index].force_density = lbpar.ext_force_density;
+
+    /* transform back to populations and streaming */
+    auto const populations = lb_calc_n_from_m(modes_with_forces);
+    lb_stream(lbfluid_post, populations, index, next_offsets);
+  });
+}
+
+/** Number of consecutive nodes along x that are collided together */
+constexpr int lb_row_width = 16;
+/** Number of rows along y and z that are visited together */
+constexpr int lb_tile_size = 8;
+
+/**
+ * @brief Product of a static matrix with the values of a row of nodes.
+ *
+ * The terms are summed in the same order as in
+ * @ref Utils::matrix_vector_product, which makes the result identical
+ * to the one of the node by node transformation.
+ */
+template <const std::array<std::array<int, 19>, 19> &matrix>
+static void lb_row_transform(std::array<double const *, 19> const &in,
+                             double (&out)[19][lb_row_width], int n_nodes) {
+  for (int k = 0; k < 19; k++) {
+    for (int x = 0; x < n_nodes; x++) {
+      out[k][x] = 0.;
+    }
+    for (int i = 18; i >= 0; i--) {
+      if (matrix[k][i] == 0) {
+        continue;
+      }
+      auto const c = static_cast<double>(matrix[k][i]);
+      auto const *const in_i = in[i];
+      for (int x = 0; x < n_nodes; x++) {
+        out[k][x] = c * in_i[x] + out[k][x];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Collide and stream a row of consecutive nodes along x.
+ *
+ * Same arithmetic as @ref lb_collide_stream_nodes, with every step done
+ * for all nodes of the row in loops over x that the compiler vectorizes.
+ *
+ * @param first         Index of the first node of the row
+ * @param n_nodes       Number of nodes, at most @ref lb_row_width
+ * @param next_offsets  Relative index of the next node for each velocity
+ */
+static void
+lb_collide_stream_row(Lattice::index_t first, int n_nodes,
+                      std::array<std::ptrdiff_t, 19> const &next_offsets) {
+  auto const &par = lbpar;
+  double modes[19][lb_row_width];
+  double populations[19][lb_row_width];
+  double force[3][lb_row_width];
+  bool fluid[lb_row_width];
+  bool all_fluid = true;
+  bool any_fluid = false;
+
+  for (int x = 0; x < n_nodes; x++) {
+    auto const &field = lbfields[first + x];
 #ifdef LB_BOUNDARIES
-        if (!lbfields[index].boundary)
+    fluid[x] = !field.boundary;
+#else
+    fluid[x] = true;
 #endif // LB_BOUNDARIES
-        {
-          /* calculate modes locally */
-          auto const modes = lb_calc_modes(index, lbfluid);
+    all_fluid = all_fluid and fluid[x];
+    any_fluid = any_fluid or fluid[x];
+    for (int j = 0; j < 3; j++) {
+      force[j][x] = field.force_density[j];
+    }
+  }
+  if (!any_fluid) {
+    return;
+  }
+
+  /* calculate modes */
+  std::array<double const *, 19> in;
+  for (int i = 0; i < 19; i++) {
+    in[i] = lbfluid[i].data() + first;
+  }
+  lb_row_transform<e_ki>(in, modes, n_nodes);
+
+  /* deterministic collisions, see lb_relax_modes() */
+  for (int x = 0; x < n_nodes; x++) {
+    auto const density = modes[0][x] + par.density;
+    auto const j0 = modes[1][x] + 0.5 * force[0][x];
+    auto const j1 = modes[2][x] + 0.5 * force[1][x];
+    auto const j2 = modes[3][x] + 0.5 * force[2][x];
+    auto const j_sq = j0 * j0 + j1 * j1 + j2 * j2;
+    double const stress_eq[6] = {j_sq / density,
+                                 (j0 * j0 - j1 * j1) / density,
+                                 (j_sq - 3.0 * (j2 * j2)) / density,
+                                 j0 * j1 / density,
+                                 j0 * j2 / density,
+                                 j1 * j2 / density};
+    modes[4][x] =
+        stress_eq[0] + par.gamma_bulk * (modes[4][x] - stress_eq[0]);
+    for (int k = 5; k < 10; k++) {
+      modes[k][x] = stress_eq[k - 4] +
+                    par.gamma_shear * (modes[k][x] - stress_eq[k - 4]);
+    }
+    for (int k = 10; k < 16; k++) {
+      modes[k][x] = par.gamma_odd * modes[k][x];
+    }
+    for (int k = 16; k < 19; k++) {
+      modes[k][x] = par.gamma_even * modes[k][x];
+    }
+  }
 
-          /* deterministic collisions */
-          auto const relaxed_modes =
-              lb_relax_modes(modes, lbfields[index].force_density, lbpar);
+  /* fluctuating hydrodynamics */
+  if (par.kT > 0.0) {
+    for (int x = 0; x < n_nodes; x++) {
+      if (fluid[x]) {
+        std::array<double, 19> node_modes;
+        for (int k = 0; k < 19; k++) {
+          node_modes[k] = modes[k][x];
+        }
+        node_modes =
+            lb_thermalize_modes(first + x, node_modes, par, rng_counter_fluid);
+        for (int k = 0; k < 19; k++) {
+          modes[k][x] = node_modes[k];
+        }
+      }
+    }
+  }
 
-          /* fluctuating hydrodynamics */
-          auto const thermalized_modes = lb_thermalize_modes(
-              index, relaxed_modes, lbpar, rng_counter_fluid);
+  /* apply forces, see lb_apply_forces() */
+  auto const shear = 1. + par.gamma_shear;
+  auto const bulk = 1. / 3. * (par.gamma_bulk - par.gamma_shear);
+  for (int x = 0; x < n_nodes; x++) {
+    auto const f0 = force[0][x];
+    auto const f1 = force[1][x];
+    auto const f2 = force[2][x];
+    auto const density = modes[0][x] + par.density;
+    auto const u0 = modes[1][x] + 0.5 * f0 / density;
+    auto const u1 = modes[2][x] + 0.5 * f1 / density;
+    auto const u2 = modes[3][x] + 0.5 * f2 / density;
+    auto const uf = u0 * f0 + u1 * f1 + u2 * f2;
+    auto const C0 = shear * u0 * f0 + bulk * uf;
+    auto const C1 = 1. / 2. * shear * (u0 * f1 + u1 * f0);
+    auto const C2 = shear * u1 * f1 + bulk * uf;
+    auto const C3 = 1. / 2. * shear * (u0 * f2 + u2 * f0);
+    auto const C4 = 1. / 2. * shear * (u1 * f2 + u2 * f1);
+    auto const C5 = shear * u2 * f2 + bulk * uf;
+    modes[1][x] += f0;
+    modes[2][x] += f1;
+    modes[3][x] += f2;
+    modes[4][x] = modes[4][x] + C0 + C2 + C5;
+    modes[5][x] = modes[5][x] + C0 - C2;
+    modes[6][x] = modes[6][x] + C0 + C2 - 2. * C5;
+    modes[7][x] += C1;
+    modes[8][x] += C3;
+    modes[9][x] += C4;
+  }
 
-          /* apply forces */
-          auto const modes_with_forces = lb_apply_forces(
-              thermalized_modes, lbpar, lbfields[index].force_density);
+  /* transform back to populations, see lb_calc_n_from_m() */
+  for (int k = 0; k < 19; k++) {
+    for (int x = 0; x < n_nodes; x++) {
+      modes[k][x] /= D3Q19::w_k[k];
+    }
+    in[k] = modes[k];
+  }
+  lb_row_transform<e_ki_transposed>(in, populations, n_nodes);
+
+  /* streaming */
+  for (int i = 0; i < 19; i++) {
+    auto const w = D3Q19::w[i];
+    auto *const out = lbfluid_post[i].data() + first + next_offsets[i];
+    if (all_fluid) {
+      for (int x = 0; x < n_nodes; x++) {
+        out[x] = populations[i][x] * w;
+      }
+    } else {
+      for (int x = 0; x < n_nodes; x++) {
+        if (fluid[x]) {
+          out[x] = populations[i][x] * w;
+        }
+      }
+    }
+  }
 
+  /* reset the force density */
+  for (int x = 0; x < n_nodes; x++) {
+    if (fluid[x]) {
+      auto &field = lbfields[first + x];
 #ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
-          // Safeguard the node forces so that we can later use them for the IBM
-          // particle update
-          lbfields[index].force_density_buf = lbfields[index].force_density;
+      field.force_density_buf = field.force_density;
 #endif
+      field.force_density = par.ext_force_density;
+    }
+  }
+}
 
-          /* reset the force density */
-          lbfields[index].force_density = lbpar.ext_force_density;
-
-          /* transform back to populations and streaming */
-          auto const populations = lb_calc_n_from_m(modes_with_forces);
-          lb_stream(lbfluid_post, populations, index, next_offsets);
+/** Collisions and streaming of rows of nodes (push scheme) */
+static void
+lb_collide_stream_rows(std::array<std::ptrdiff_t, 19> const &next_offsets) {
+  auto const &grid = lblattice.grid;
+  for (int z0 = 1; z0 <= grid[2]; z0 += lb_tile_size) {
+    auto const z1 = std::min(z0 + lb_tile_size, grid[2] + 1);
+    for (int y0 = 1; y0 <= grid[1]; y0 += lb_tile_size) {
+      auto const y1 = std::min(y0 + lb_tile_size, grid[1] + 1);
+      for (int z = z0; z < z1; z++) {
+        for (int y = y0; y < y1; y++) {
+          auto const row = get_linear_index(1, y, z, lblattice.halo_grid);
+          for (int x = 0; x < grid[0]; x += lb_row_width) {
+            lb_collide_stream_row(row + x, std::min(lb_row_width, grid[0] - x),
+                                  next_offsets);
+          }
         }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Collisions and streaming in a single population array.
+ *
+ * The fluid nodes are visited in memory order. The post-collision
+ * populations of a node are stored in the slots of the opposite velocities,
+ * then each link to a node that was already visited, or that is never
+ * visited (halo and boundary nodes), is streamed by swapping the two
+ * populations it connects. Afterwards the nodes hold their
+ * streamed populations in the usual slots, like the post-collision array of
+ * the push scheme. The populations coming from the halo or from boundary
+ * nodes are set by @ref halo_push_communication and @ref lb_bounce_back.
+ */
+static void
+lb_collide_stream_in_place(std::array<std::ptrdiff_t, 19> const &next_offsets) {
+  static constexpr int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
+                                    9, 12, 11, 14, 13, 16, 15, 18, 17};
+
+  /* loop over the fluid nodes */
+  lb_for_each_fluid_node([&next_offsets](LBFluidNodeEntry const &node) {
+    auto const index = node.index;
 
-        ++index; /* next node */
+    auto const modes = lb_calc_modes(index, lbfluid);
+    auto const relaxed_modes =
+        lb_relax_modes(modes, lbfields[index].force_density, lbpar);
+    auto const thermalized_modes =
+        lb_thermalize_modes(index, relaxed_modes, lbpar, rng_counter_fluid);
+    auto const modes_with_forces = lb_apply_forces(
+        thermalized_modes, lbpar, lbfields[index].force_density);
+
+#ifdef VIRTUAL_SITES_INERTIALESS_TRACERS
+    lbfields[index].force_density_buf = lbfields[index].force_density;
+#endif
+
+    lbfields[index].force_density = lbpar.ext_force_density;
+
+    auto const populations = lb_calc_n_from_m(modes_with_forces);
+    lbfluid[0][index] = populations[0];
+    for (int i = 1; i < 19; i++) {
+      auto &local = lbfluid[reverse[i]][index];
+      if (node.swap_links & (1u << i)) {
+        auto &remote = lbfluid[i][index + next_offsets[i]];
+        local = remote;
+        remote = populations[i];
+      } else {
+        local = populations[i];
       }
-      index += 2; /* skip halo region */
     }
-    index += 2 * lblattice.halo_grid[0]; /* skip halo region */
+  });
+}
+
+/* Collisions and streaming (push scheme) */
+void lb_integrate() {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+#ifdef LB_BOUNDARIES
+  for (auto &lbboundary : LBBoundaries::lbboundaries) {
+    (*lbboundary).reset_force();
+  }
+#endif // LB_BOUNDARIES
+
+  auto const next_offsets = lb_next_offsets(lblattice, D3Q19::c);
+
+  switch (lb_kernel) {
+  case LBKernel::REFERENCE:
+    lb_collide_stream_nodes(next_offsets);
+    break;
+  case LBKernel::BLOCKED:
+    lb_collide_stream_rows(next_offsets);
+    break;
+  case LBKernel::IN_PLACE:
+    lb_collide_stream_in_place(next_offsets);
+    break;
   }
 
+  /* streamed populations */
+  auto const in_place = (lb_kernel == LBKernel::IN_PLACE);
+  auto &lb_fluid_next = in_place ? lbfluid : lbfluid_post;
+
   /* exchange halo regions */
-  halo_push_communication(lbfluid_post, lblattice);
+  halo_push_communication(lb_fluid_next, lblattice);
 
 #ifdef LB_BOUNDARIES
   /* boundary conditions for links */
-  lb_bounce_back(lbfluid_post, lbpar, lbfields);
+  lb_bounce_back(lb_fluid_next, lbpar, lbfields);
 #endif // LB_BOUNDARIES
 
   /* swap the pointers for old and new population fields */
-  std::swap(lbfluid, lbfluid_post);
+  if (!in_place) {
+    std::swap(lbfluid, lbfluid_post);
+  }
 
   halo_communication(update_halo_comm,
                      reinterpret_cast<char *>(lbfluid[0].data()));
@@ -1251,39 +1644,38 @@ void lb_bounce_back(LB_Fluid &lb_fluid, const LB_Parameters &lb_parameters,
   static constexpr int reverse[] = {0, 2,  1,  4,  3,  6,  5,  8,  7, 10,
                                     9, 12, 11, 14, 13, 16, 15, 18, 17};
 
-  /* bottom-up sweep */
-  for (int z = 0; z < lblattice.grid[2] + 2; z++) {
-    for (int y = 0; y < lblattice.grid[1] + 2; y++) {
-      for (int x = 0; x < lblattice.grid[0] + 2; x++) {
-        auto const k = get_linear_index(x, y, z, lblattice.halo_grid);
-
-        if (lb_fields[k].boundary) {
-          Utils::Vector3d boundary_force = {};
-          for (int i = 0; i < 19; i++) {
-            auto const ci = D3Q19::c[i];
-
-            if (x - ci[0] > 0 && x - ci[0] < lblattice.grid[0] + 1 &&
-                y - ci[1] > 0 && y - ci[1] < lblattice.grid[1] + 1 &&
-                z - ci[2] > 0 && z - ci[2] < lblattice.grid[2] + 1) {
-              if (!lb_fields[k - next[i]].boundary) {
-                auto const population_shift =
-                    -lb_parameters.density * 2 * D3Q19::w[i] *
-                    (ci * lb_fields[k].slip_velocity) /
-                    D3Q19::c_sound_sq<double>;
-
-                boundary_force += (2 * lb_fluid[i][k] + population_shift) * ci;
-                lb_fluid[reverse[i]][k - next[i]] =
-                    lb_fluid[i][k] + population_shift;
-              } else {
-                lb_fluid[reverse[i]][k - next[i]] = lb_fluid[i][k] = 0.0;
-              }
-            }
-          }
-          LBBoundaries::lbboundaries[lb_fields[k].boundary - 1]->force() +=
-              boundary_force;
-        }
+  using LinkIterator = std::vector<LBBoundaryLink>::const_iterator;
+  /* links of a single boundary node */
+  auto const bounce_back_links = [&](LinkIterator link, LinkIterator last) {
+    auto const k = link->boundary;
+    Utils::Vector3d boundary_force = {};
+    for (; link != last; ++link) {
+      auto const i = link->velocity;
+      auto const ci = D3Q19::c[i];
+      if (link->fluid) {
+        auto const population_shift =
+            -lb_parameters.density * 2 * D3Q19::w[i] *
+            (ci * lb_fields[k].slip_velocity) / D3Q19::c_sound_sq<double>;
+
+        boundary_force += (2 * lb_fluid[i][k] + population_shift) * ci;
+        lb_fluid[reverse[i]][k - next[i]] = lb_fluid[i][k] + population_shift;
+      } else {
+        lb_fluid[reverse[i]][k - next[i]] = lb_fluid[i][k] = 0.0;
       }
     }
+    LBBoundaries::lbboundaries[lb_fields[k].boundary - 1]->force() +=
+        boundary_force;
+  };
+
+  /* links of each boundary node, bottom-up */
+  auto link = lb_boundary_links.cbegin();
+  while (link != lb_boundary_links.cend()) {
+    auto const k = link->boundary;
+    auto const last = std::find_if(
+        link, lb_boundary_links.cend(),
+        [k](LBBoundaryLink const &other) { return other.boundary != k; });
+    bounce_back_links(link, last);
+    link = last;
   }
 }
 #endif // LB_BOUNDARIES
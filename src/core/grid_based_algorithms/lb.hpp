@@ -136,6 +136,50 @@ extern Lattice lblattice;
 /** Communicator for halo exchange between processors */
 extern HaloCommunicator update_halo_comm;
 
+/** Implementation of the collide-and-stream step */
+extern LBKernel lb_kernel;
+
+/** Select the implementation of the collide-and-stream step. The second
+ *  population array is released for @ref LBKernel::IN_PLACE and allocated
+ *  again for the other kernels, the populations are kept.
+ */
+void lb_set_kernel(LBKernel kernel);
+
+/** Collect the local fluid nodes and the links of the boundary nodes, so
+ *  that the collide-and-stream step and the bounce back only visit these.
+ *  Has to be called whenever the lattice or the boundary flags change.
+ */
+void lb_init_node_lists();
+
+/** Local fluid node (halo and boundary nodes excluded). */
+struct LBFluidNodeEntry {
+  Lattice::index_t index;
+  /** Velocities whose link is streamed by this node in the in-place
+   *  kernel, one bit per velocity.
+   */
+  std::uint32_t swap_links;
+};
+
+/** Local fluid nodes found by @ref lb_init_node_lists, in memory order. */
+std::vector<LBFluidNodeEntry> const &lb_get_fluid_nodes();
+
+#ifdef LB_BOUNDARIES
+/** Link of a boundary node to a local node, see @ref lb_bounce_back(). */
+struct LBBoundaryLink {
+  /** Boundary node, local or halo */
+  Lattice::index_t boundary;
+  /** Velocity pointing from the local node to the boundary node */
+  int velocity;
+  /** Whether the local node is a fluid node */
+  bool fluid;
+};
+
+/** Links of all boundary nodes found by @ref lb_init_node_lists, in memory
+ *  order of the boundary nodes.
+ */
+std::vector<LBBoundaryLink> const &lb_get_boundary_links();
+#endif // LB_BOUNDARIES
+
 void lb_init(const LB_Parameters &lb_parameters);
 
 void lb_reinit_fluid(std::vector<LB_FluidNode> &lb_fields,
@@ -244,6 +288,7 @@ void lb_prepare_communication(HaloCommunicator &halo_comm,
  * The populations that have propagated into a boundary node
  * are bounced back to the node they came from. This results
  * in no slip boundary conditions, cf. @cite ladd01a.
+ * Only the links found by @ref lb_init_node_lists are visited.
  */
 void lb_bounce_back(LB_Fluid &lbfluid, const LB_Parameters &lb_parameters,
                     const std::vector<LB_FluidNode> &lb_fields);
@@ -266,6 +266,7 @@ void lb_init_boundaries() {
         }
       }
     }
+    lb_init_node_lists();
 #else  // defined(LB_BOUNDARIES)
     if (not lbboundaries.empty()) {
       runtimeErrorMsg()
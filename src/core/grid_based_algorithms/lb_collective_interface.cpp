@@ -27,9 +27,15 @@
 
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
+#include <utils/mpi/gather_buffer.hpp>
 
+#include <boost/mpi/collectives/gather.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 using Utils::get_linear_index;
 
 /* LB CPU callback interface */
@@ -154,6 +160,16 @@ auto mpi_lb_get_momentum_density(Utils::Vector3i const &index) {
 
 REGISTER_CALLBACK_ONE_RANK(mpi_lb_get_momentum_density)
 
+auto mpi_lb_get_velocity(Utils::Vector3i const &index) {
+  return detail::lb_calc_fluid_kernel(
+      index, [&](auto const &modes, auto const &force_density) {
+        return lb_calc_momentum_density(modes, force_density) /
+               lb_calc_density(modes, lbpar);
+      });
+}
+
+REGISTER_CALLBACK_ONE_RANK(mpi_lb_get_velocity)
+
 auto mpi_lb_get_pressure_tensor(Utils::Vector3i const &index) {
   return detail::lb_calc_fluid_kernel(
       index, [&](auto const &modes, auto const &force_density) {
@@ -163,6 +179,114 @@ auto mpi_lb_get_pressure_tensor(Utils::Vector3i const &index) {
 
 REGISTER_CALLBACK_ONE_RANK(mpi_lb_get_pressure_tensor)
 
+void lb_append_local_node_field(LBField field, Utils::Vector3i const &index,
+                                std::vector<double> &values) {
+  auto const linear_index =
+      get_linear_index(lblattice.local_index(index), lblattice.halo_grid);
+  auto const append = [&values](auto const &vec) {
+    values.insert(values.end(), vec.begin(), vec.end());
+  };
+  auto const &force_density = lbfields[linear_index].force_density;
+  switch (field) {
+  case LBField::DENSITY:
+    values.push_back(
+        lb_calc_density(lb_calc_modes(linear_index, lbfluid), lbpar));
+    break;
+  case LBField::VELOCITY: {
+    auto const modes = lb_calc_modes(linear_index, lbfluid);
+    append(lb_calc_momentum_density(modes, force_density) /
+           lb_calc_density(modes, lbpar));
+    break;
+  }
+  case LBField::PRESSURE_TENSOR:
+  case LBField::PRESSURE_TENSOR_NEQ: {
+    auto const modes = lb_calc_modes(linear_index, lbfluid);
+    auto tensor = lb_calc_pressure_tensor(modes, force_density, lbpar);
+    if (field == LBField::PRESSURE_TENSOR) {
+      // add equilibrium pressure to the diagonal (in LB units)
+      auto const p0 = lbpar.density * D3Q19::c_sound_sq<double>;
+      tensor[0] += p0;
+      tensor[2] += p0;
+      tensor[5] += p0;
+    }
+    append(tensor);
+    break;
+  }
+  case LBField::POPULATIONS:
+    append(lb_get_population(linear_index));
+    break;
+  case LBField::BOUNDARY:
+#ifdef LB_BOUNDARIES
+    values.push_back(lbfields[linear_index].boundary);
+#else
+    values.push_back(0.);
+#endif
+    break;
+  }
+}
+
+/** @brief Extract a field on all nodes in the box [lower, upper).
+ *
+ *  Every rank visits the nodes of its part of the box in a single pass,
+ *  the parts are gathered on the head node and assembled in row-major
+ *  order (z index running fastest), with @ref lb_field_size values per
+ *  node. The other ranks return an empty vector.
+ */
+std::vector<double> mpi_lb_get_slab(LBField field, Utils::Vector3i const &lower,
+                                    Utils::Vector3i const &upper) {
+  auto const n_values = lb_field_size(field);
+
+  /* part of the box on this rank, in global coordinates */
+  Utils::Vector3i local_lower, local_upper;
+  for (unsigned int i = 0; i < 3; ++i) {
+    auto const local_end =
+        lblattice.local_index_offset[i] + lblattice.grid[i];
+    local_lower[i] = std::max(lower[i], lblattice.local_index_offset[i]);
+    local_upper[i] = std::max(local_lower[i], std::min(upper[i], local_end));
+  }
+
+  std::vector<double> values;
+  values.reserve(static_cast<std::size_t>(
+                     Utils::product(local_upper - local_lower)) *
+                 n_values);
+  Utils::Vector3i index;
+  for (index[0] = local_lower[0]; index[0] < local_upper[0]; ++index[0])
+    for (index[1] = local_lower[1]; index[1] < local_upper[1]; ++index[1])
+      for (index[2] = local_lower[2]; index[2] < local_upper[2]; ++index[2])
+        lb_append_local_node_field(field, index, values);
+
+  std::vector<Utils::Vector3i> lowers, uppers;
+  boost::mpi::gather(comm_cart, local_lower, lowers, 0);
+  boost::mpi::gather(comm_cart, local_upper, uppers, 0);
+  Utils::Mpi::gather_buffer(values, comm_cart);
+
+  if (this_node != 0) {
+    return {};
+  }
+
+  auto const shape = upper - lower;
+  std::vector<double> slab(static_cast<std::size_t>(Utils::product(shape)) *
+                           n_values);
+  auto source = values.begin();
+  for (std::size_t rank = 0; rank < lowers.size(); ++rank) {
+    for (index[0] = lowers[rank][0]; index[0] < uppers[rank][0]; ++index[0])
+      for (index[1] = lowers[rank][1]; index[1] < uppers[rank][1]; ++index[1])
+        for (index[2] = lowers[rank][2]; index[2] < uppers[rank][2];
+             ++index[2]) {
+          auto const offset = get_linear_index(index - lower, shape,
+                                               Utils::MemoryOrder::ROW_MAJOR);
+          std::copy_n(source, n_values,
+                      slab.begin() + static_cast<std::ptrdiff_t>(
+                                         static_cast<std::size_t>(offset) *
+                                         n_values));
+          source += static_cast<std::ptrdiff_t>(n_values);
+        }
+  }
+  return slab;
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_lb_get_slab)
+
 void mpi_bcast_lb_params_local(LBParam field, LB_Parameters const &params) {
   lbpar = params;
   lb_on_param_change(field);
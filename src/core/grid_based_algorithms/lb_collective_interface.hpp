@@ -24,6 +24,8 @@
 #include <boost/optional.hpp>
 #include <utils/Vector.hpp>
 
+#include <vector>
+
 /* collective getter functions */
 boost::optional<Utils::Vector3d>
 mpi_lb_get_interpolated_velocity(Utils::Vector3d const &pos);
@@ -35,8 +37,20 @@ mpi_lb_get_populations(Utils::Vector3i const &index);
 boost::optional<int> mpi_lb_get_boundary_flag(Utils::Vector3i const &index);
 boost::optional<Utils::Vector3d>
 mpi_lb_get_momentum_density(Utils::Vector3i const &index);
+boost::optional<Utils::Vector3d>
+mpi_lb_get_velocity(Utils::Vector3i const &index);
 boost::optional<Utils::Vector6d>
 mpi_lb_get_pressure_tensor(Utils::Vector3i const &index);
+std::vector<double> mpi_lb_get_slab(LBField field, Utils::Vector3i const &lower,
+                                    Utils::Vector3i const &upper);
+
+/** @brief Append the values of a field on a node of this rank to @p values.
+ *  @param field   Field to read
+ *  @param index   Global index of the node
+ *  @param values  Output buffer
+ */
+void lb_append_local_node_field(LBField field, Utils::Vector3i const &index,
+                                std::vector<double> &values);
 
 /* collective setter functions */
 void mpi_lb_set_population(Utils::Vector3i const &index,
@@ -23,6 +23,8 @@
 #ifndef LB_CONSTANTS_HPP
 #define LB_CONSTANTS_HPP
 
+#include <cstddef>
+
 /** @brief Parameter fields for lattice Boltzmann
  *
  *  Determine what actions have to take place upon change of the respective
@@ -40,4 +42,55 @@ enum class LBParam {
   TAU                /**< LB time step */
 };
 
+/** @brief Implementations of the collide-and-stream step of the CPU LB. */
+enum class LBKernel {
+  REFERENCE, /**< one node at a time */
+  BLOCKED,   /**< rows of nodes along x, in tiles of rows along y and z */
+  IN_PLACE   /**< one node at a time, in a single population array */
+};
+
+/** @brief Node fields that can be read in bulk from the fluid lattice. */
+enum class LBField {
+  DENSITY,             /**< fluid density */
+  VELOCITY,            /**< fluid velocity */
+  PRESSURE_TENSOR,     /**< pressure tensor, lower triangle */
+  PRESSURE_TENSOR_NEQ, /**< non-equilibrium part of the pressure tensor */
+  POPULATIONS,         /**< populations */
+  BOUNDARY             /**< boundary flag */
+};
+
+/** @brief Number of values per node of a fluid field. */
+inline std::size_t lb_field_size(LBField field) {
+  switch (field) {
+  case LBField::VELOCITY:
+    return 3;
+  case LBField::PRESSURE_TENSOR:
+  case LBField::PRESSURE_TENSOR_NEQ:
+    return 6;
+  case LBField::POPULATIONS:
+    return 19;
+  default:
+    return 1;
+  }
+}
+
+/** @brief Name of a fluid field in output files. */
+inline char const *lb_field_name(LBField field) {
+  switch (field) {
+  case LBField::DENSITY:
+    return "density";
+  case LBField::VELOCITY:
+    return "velocity";
+  case LBField::PRESSURE_TENSOR:
+    return "pressure_tensor";
+  case LBField::PRESSURE_TENSOR_NEQ:
+    return "pressure_tensor_neq";
+  case LBField::POPULATIONS:
+    return "population";
+  case LBField::BOUNDARY:
+    return "boundary";
+  }
+  return "";
+}
+
 #endif /* LB_CONSTANTS_HPP */
@@ -33,9 +33,18 @@
 #include "lb_interpolation.hpp"
 #include "lbgpu.hpp"
 
+#include "io/vtk/vtk_image.hpp"
+
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <mpi.h>
+
 #include <cmath>
+#include <cstddef>
 #include <fstream>
 #include <limits>
 #include <sstream>
@@ -437,6 +446,26 @@ void lb_lbfluid_set_lattice_switch(ActiveLB local_lattice_switch) {
   mpi_set_lattice_switch(local_lattice_switch);
 }
 
+static void mpi_lb_set_kernel_local(LBKernel kernel) {
+  ::lb_set_kernel(kernel);
+}
+
+REGISTER_CALLBACK(mpi_lb_set_kernel_local)
+
+LBKernel lb_lbfluid_get_kernel() { return lb_kernel; }
+
+void lb_lbfluid_set_kernel(LBKernel kernel) {
+  switch (kernel) {
+  case LBKernel::REFERENCE:
+  case LBKernel::BLOCKED:
+  case LBKernel::IN_PLACE:
+    break;
+  default:
+    throw std::invalid_argument("Invalid LB kernel.");
+  }
+  mpi_call_all(mpi_lb_set_kernel_local, kernel);
+}
+
 void lb_lbfluid_set_kT(double kT) {
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
@@ -466,6 +495,37 @@ double lb_lbfluid_get_lattice_speed() {
   return lb_lbfluid_get_agrid() / lb_lbfluid_get_tau();
 }
 
+/**
+ * @brief Visit the nodes of the box [lower, upper) in VTK order (x index
+ * running fastest). The field is read one z-plane at a time.
+ *
+ * @param field  Field to read
+ * @param lower  Lower corner of the box
+ * @param upper  Upper corner of the box (exclusive)
+ * @param f      Callable with the node index and its values
+ */
+template <class F>
+static void lb_lbfluid_for_each_node(LBField field,
+                                     Utils::Vector3i const &lower,
+                                     Utils::Vector3i const &upper, F f) {
+  auto const n_values = lb_field_size(field);
+  auto const n_y = static_cast<std::size_t>(upper[1] - lower[1]);
+  Utils::Vector3i pos;
+  for (pos[2] = lower[2]; pos[2] < upper[2]; pos[2]++) {
+    auto const plane =
+        lb_lbfluid_get_slab(field, {lower[0], lower[1], pos[2]},
+                            {upper[0], upper[1], pos[2] + 1});
+    for (pos[1] = lower[1]; pos[1] < upper[1]; pos[1]++)
+      for (pos[0] = lower[0]; pos[0] < upper[0]; pos[0]++) {
+        auto const offset =
+            (static_cast<std::size_t>(pos[0] - lower[0]) * n_y +
+             static_cast<std::size_t>(pos[1] - lower[1])) *
+            n_values;
+        f(pos, Utils::Span<const double>(plane.data() + offset, n_values));
+      }
+  }
+}
+
 void lb_lbfluid_print_vtk_boundary(const std::string &filename) {
   std::fstream cpfile;
   cpfile.open(filename, std::ios::out);
@@ -508,12 +568,11 @@ void lb_lbfluid_print_vtk_boundary(const std::string &filename) {
 #endif //  CUDA
   } else {
     vtk_writer("lbboundaries", [&]() {
-      auto const grid_size = lb_lbfluid_get_shape();
-      Utils::Vector3i pos;
-      for (pos[2] = 0; pos[2] < grid_size[2]; pos[2]++)
-        for (pos[1] = 0; pos[1] < grid_size[1]; pos[1]++)
-          for (pos[0] = 0; pos[0] < grid_size[0]; pos[0]++)
-            cpfile << lb_lbnode_get_boundary(pos) << "\n";
+      lb_lbfluid_for_each_node(
+          LBField::BOUNDARY, Utils::Vector3i{}, lb_lbfluid_get_shape(),
+          [&](Utils::Vector3i const &, Utils::Span<const double> values) {
+            cpfile << static_cast<int>(values[0]) << "\n";
+          });
     });
   }
   cpfile.close();
@@ -531,7 +590,8 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
   auto bb_low = Utils::Vector3i{};
   auto bb_high = lb_lbfluid_get_shape();
 
-  auto const vtk_writer = [&](std::string const &label, auto const &get_vel) {
+  auto const vtk_writer = [&](std::string const &label,
+                              auto const &write_velocities) {
     using Utils::Vector3d;
     cpfile.precision(6);
     cpfile << std::fixed;
@@ -550,12 +610,7 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
            << "POINT_DATA " << Utils::product(bb_dim) << "\n"
            << "SCALARS velocity float 3\n"
            << "LOOKUP_TABLE default\n";
-
-    Utils::Vector3i pos;
-    for (pos[2] = bb_low[2]; pos[2] < bb_high[2]; pos[2]++)
-      for (pos[1] = bb_low[1]; pos[1] < bb_high[1]; pos[1]++)
-        for (pos[0] = bb_low[0]; pos[0] < bb_high[0]; pos[0]++)
-          cpfile << vtk_format << get_vel(pos) * lattice_speed << "\n";
+    write_velocities(vtk_format, lattice_speed);
   };
 
   int it = 0;
@@ -582,13 +637,32 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
     host_values.resize(lbpar_gpu.number_of_nodes);
     lb_get_values_GPU(host_values.data());
     auto const box_l = lb_lbfluid_get_shape();
-    vtk_writer("lbfluid_gpu", [&box_l](Utils::Vector3i const &pos) {
-      auto const j = box_l[0] * box_l[1] * pos[2] + box_l[0] * pos[1] + pos[0];
-      return Utils::Vector3d{host_values[j].v};
+    vtk_writer("lbfluid_gpu", [&](auto const &vtk_format,
+                                  double lattice_speed) {
+      Utils::Vector3i pos;
+      for (pos[2] = bb_low[2]; pos[2] < bb_high[2]; pos[2]++)
+        for (pos[1] = bb_low[1]; pos[1] < bb_high[1]; pos[1]++)
+          for (pos[0] = bb_low[0]; pos[0] < bb_high[0]; pos[0]++) {
+            auto const j =
+                box_l[0] * box_l[1] * pos[2] + box_l[0] * pos[1] + pos[0];
+            cpfile << vtk_format << Utils::Vector3d{host_values[j].v} *
+                                        lattice_speed
+                   << "\n";
+          }
     });
 #endif //  CUDA
   } else {
-    vtk_writer("lbfluid_cpu", lb_lbnode_get_velocity);
+    vtk_writer("lbfluid_cpu", [&](auto const &vtk_format,
+                                  double lattice_speed) {
+      lb_lbfluid_for_each_node(
+          LBField::VELOCITY, bb_low, bb_high,
+          [&](Utils::Vector3i const &, Utils::Span<const double> values) {
+            cpfile << vtk_format
+                   << Utils::Vector3d(values.begin(), values.end()) *
+                          lattice_speed
+                   << "\n";
+          });
+    });
   }
   cpfile.close();
 }
@@ -624,14 +698,12 @@ void lb_lbfluid_print_boundary(const std::string &filename) {
   } else {
     auto const shift = Vector3d{{0.5, 0.5, 0.5}};
     auto const agrid = lb_lbfluid_get_agrid();
-    auto const grid_size = lb_lbfluid_get_shape();
-    Utils::Vector3i pos;
-    for (pos[2] = 0; pos[2] < grid_size[2]; pos[2]++)
-      for (pos[1] = 0; pos[1] < grid_size[1]; pos[1]++)
-        for (pos[0] = 0; pos[0] < grid_size[0]; pos[0]++) {
-          auto const flag = (lb_lbnode_get_boundary(pos) != 0) ? 1 : 0;
+    lb_lbfluid_for_each_node(
+        LBField::BOUNDARY, Utils::Vector3i{}, lb_lbfluid_get_shape(),
+        [&](Utils::Vector3i const &pos, Utils::Span<const double> values) {
+          auto const flag = (values[0] != 0.) ? 1 : 0;
           cpfile << vtk_format << (pos + shift) * agrid << " " << flag << "\n";
-        }
+        });
   }
   cpfile.close();
 }
@@ -669,14 +741,14 @@ void lb_lbfluid_print_velocity(const std::string &filename) {
   } else {
     auto const shift = Vector3d{{0.5, 0.5, 0.5}};
     auto const agrid = lb_lbfluid_get_agrid();
-    auto const grid_size = lb_lbfluid_get_shape();
     auto const lattice_speed = lb_lbfluid_get_lattice_speed();
-    Utils::Vector3i pos;
-    for (pos[2] = 0; pos[2] < grid_size[2]; pos[2]++)
-      for (pos[1] = 0; pos[1] < grid_size[1]; pos[1]++)
-        for (pos[0] = 0; pos[0] < grid_size[0]; pos[0]++)
+    lb_lbfluid_for_each_node(
+        LBField::VELOCITY, Utils::Vector3i{}, lb_lbfluid_get_shape(),
+        [&](Utils::Vector3i const &pos, Utils::Span<const double> values) {
           cpfile << vtk_format << (pos + shift) * agrid << " " << vtk_format
-                 << lb_lbnode_get_velocity(pos) * lattice_speed << "\n";
+                 << Vector3d(values.begin(), values.end()) * lattice_speed
+                 << "\n";
+        });
   }
 
   cpfile.close();
@@ -779,14 +851,13 @@ void lb_lbfluid_save_checkpoint(const std::string &filename, bool binary) {
       auto const grid_size = lb_lbfluid_get_shape();
       cpfile.write(grid_size);
 
+      // read one x-plane at a time, the nodes are written with z fastest
       for (int i = 0; i < grid_size[0]; i++) {
-        for (int j = 0; j < grid_size[1]; j++) {
-          for (int k = 0; k < grid_size[2]; k++) {
-            auto const ind = Utils::Vector3i{{i, j, k}};
-            auto const pop = mpi_call(::Communication::Result::one_rank,
-                                      mpi_lb_get_populations, ind);
-            cpfile.write(pop);
-          }
+        auto const plane =
+            lb_lbfluid_get_slab(LBField::POPULATIONS, {i, 0, 0},
+                                {i + 1, grid_size[1], grid_size[2]});
+        for (auto it = plane.begin(); it != plane.end(); it += D3Q19::n_vel) {
+          cpfile.write(Utils::Vector19d(it, it + D3Q19::n_vel));
         }
       }
     }
@@ -922,11 +993,8 @@ const Utils::Vector3d lb_lbnode_get_velocity(const Utils::Vector3i &ind) {
 #endif
   }
   if (lattice_switch == ActiveLB::CPU) {
-    auto const density = ::Communication::mpiCallbacks().call(
-        ::Communication::Result::one_rank, mpi_lb_get_density, ind);
-    auto const momentum_density = ::Communication::mpiCallbacks().call(
-        ::Communication::Result::one_rank, mpi_lb_get_momentum_density, ind);
-    return momentum_density / density;
+    return ::Communication::mpiCallbacks().call(
+        ::Communication::Result::one_rank, mpi_lb_get_velocity, ind);
   }
   throw NoLBActive();
 }
@@ -986,14 +1054,11 @@ const Utils::Vector6d lb_lbfluid_get_pressure_tensor() {
   if (lattice_switch == ActiveLB::CPU) {
     auto const grid_size = lb_lbfluid_get_shape();
     Utils::Vector6d tensor{};
-    for (int i = 0; i < grid_size[0]; i++) {
-      for (int j = 0; j < grid_size[1]; j++) {
-        for (int k = 0; k < grid_size[2]; k++) {
-          const Utils::Vector3i node{{i, j, k}};
-          tensor += lb_lbnode_get_pressure_tensor(node);
-        }
-      }
-    }
+    lb_lbfluid_for_each_node(
+        LBField::PRESSURE_TENSOR, Utils::Vector3i{}, grid_size,
+        [&tensor](Utils::Vector3i const &, Utils::Span<const double> values) {
+          tensor += Utils::Vector6d(values.begin(), values.end());
+        });
 
     tensor /= static_cast<double>(Utils::product(grid_size));
     return tensor;
@@ -1036,6 +1101,175 @@ const Utils::Vector19d lb_lbnode_get_pop(const Utils::Vector3i &ind) {
   throw NoLBActive();
 }
 
+/** @brief Append the values of a field on a single node to @p values. */
+static void lb_lbnode_append_field(LBField field, Utils::Vector3i const &ind,
+                                   std::vector<double> &values) {
+  auto const append = [&values](auto const &vec) {
+    values.insert(values.end(), vec.begin(), vec.end());
+  };
+  switch (field) {
+  case LBField::DENSITY:
+    values.push_back(lb_lbnode_get_density(ind));
+    break;
+  case LBField::VELOCITY:
+    append(lb_lbnode_get_velocity(ind));
+    break;
+  case LBField::PRESSURE_TENSOR:
+    append(lb_lbnode_get_pressure_tensor(ind));
+    break;
+  case LBField::PRESSURE_TENSOR_NEQ:
+    append(lb_lbnode_get_pressure_tensor_neq(ind));
+    break;
+  case LBField::POPULATIONS:
+    append(lb_lbnode_get_pop(ind));
+    break;
+  case LBField::BOUNDARY:
+    values.push_back(lb_lbnode_get_boundary(ind));
+    break;
+  }
+}
+
+std::vector<double> lb_lbfluid_get_slab(LBField field,
+                                        Utils::Vector3i const &lower,
+                                        Utils::Vector3i const &upper) {
+  auto const grid_size = lb_lbfluid_get_shape();
+  if (not(lower >= Utils::Vector3i{} and upper >= lower and
+          grid_size >= upper)) {
+    std::stringstream message;
+    message << "LB slab [" << lower << "], [" << upper
+            << "] is outside of the lattice of shape [" << grid_size << "]";
+    throw std::runtime_error(message.str());
+  }
+  if (lattice_switch == ActiveLB::GPU) {
+    std::vector<double> values;
+    values.reserve(static_cast<std::size_t>(Utils::product(upper - lower)) *
+                   lb_field_size(field));
+    Utils::Vector3i ind;
+    for (ind[0] = lower[0]; ind[0] < upper[0]; ind[0]++)
+      for (ind[1] = lower[1]; ind[1] < upper[1]; ind[1]++)
+        for (ind[2] = lower[2]; ind[2] < upper[2]; ind[2]++)
+          lb_lbnode_append_field(field, ind, values);
+    return values;
+  }
+  return mpi_call(::Communication::Result::main_rank, mpi_lb_get_slab, field,
+                  lower, upper);
+}
+
+/** @brief Index on the lattice that keeps every @p stride-th node. */
+static Utils::Vector3i lb_strided_index(Utils::Vector3i const &index,
+                                        int stride) {
+  return {(index[0] + stride - 1) / stride, (index[1] + stride - 1) / stride,
+          (index[2] + stride - 1) / stride};
+}
+
+/**
+ * @brief Write the nodes in the box [lower, upper) of the strided lattice
+ * to a VTK image file.
+ *
+ * @param filename          Path of the output file
+ * @param comm              Communicator of the ranks that write a block
+ * @param fields            Fields to write
+ * @param unit_conversions  Factor to apply to the values of each field
+ * @param stride            Write every @p stride-th node in each direction
+ * @param lower             Lower corner of the block on the strided lattice
+ * @param upper             Upper corner of the block on the strided lattice
+ * @param node_field        Append the values of a field on a node (global
+ *                          index) to a buffer
+ */
+template <class NodeField>
+static void lb_write_vtk_block(std::string const &filename, MPI_Comm comm,
+                               std::vector<LBField> const &fields,
+                               std::vector<double> const &unit_conversions,
+                               int stride, Utils::Vector3i const &lower,
+                               Utils::Vector3i const &upper,
+                               NodeField node_field) {
+  auto const n_nodes = static_cast<std::size_t>(Utils::product(upper - lower));
+  std::vector<Vtk::ImageField> images;
+  std::vector<double> node_values;
+  for (std::size_t i = 0; i < fields.size(); ++i) {
+    Vtk::ImageField image{lb_field_name(fields[i]), lb_field_size(fields[i]),
+                          {}};
+    image.values.reserve(n_nodes * image.n_components);
+    Utils::Vector3i ind;
+    for (ind[2] = lower[2]; ind[2] < upper[2]; ind[2]++)
+      for (ind[1] = lower[1]; ind[1] < upper[1]; ind[1]++)
+        for (ind[0] = lower[0]; ind[0] < upper[0]; ind[0]++) {
+          node_values.clear();
+          node_field(fields[i], ind * stride, node_values);
+          if (image.n_components == 6u) {
+            // VTK symmetric tensors are stored as XX, YY, ZZ, XY, YZ, XZ
+            for (auto const j : {0u, 2u, 5u, 1u, 4u, 3u}) {
+              image.values.emplace_back(
+                  static_cast<float>(node_values[j] * unit_conversions[i]));
+            }
+            continue;
+          }
+          for (auto const value : node_values) {
+            image.values.emplace_back(
+                static_cast<float>(value * unit_conversions[i]));
+          }
+        }
+    images.emplace_back(std::move(image));
+  }
+
+  auto const agrid = lb_lbfluid_get_agrid();
+  auto const shape = lb_strided_index(lb_lbfluid_get_shape(), stride);
+  Vtk::write_image(filename, comm, shape, lower, upper,
+                   Utils::Vector3d::broadcast(0.5 * agrid), stride * agrid,
+                   images);
+}
+
+static void mpi_lb_write_vtk_local(std::string const &filename,
+                                   std::vector<LBField> const &fields,
+                                   std::vector<double> const &unit_conversions,
+                                   int stride) {
+  auto const lower = lblattice.local_index_offset;
+  auto const upper = lblattice.local_index_offset + lblattice.grid;
+  lb_write_vtk_block(filename, comm_cart, fields, unit_conversions, stride,
+                     lb_strided_index(lower, stride),
+                     lb_strided_index(upper, stride),
+                     lb_append_local_node_field);
+}
+
+REGISTER_CALLBACK(mpi_lb_write_vtk_local)
+
+void lb_lbfluid_write_vtk(std::string const &filename,
+                          std::vector<LBField> const &fields, int stride) {
+  if (stride < 1) {
+    throw std::invalid_argument("VTK output stride has to be >= 1");
+  }
+  auto const agrid = lb_lbfluid_get_agrid();
+  auto const tau = lb_lbfluid_get_tau();
+  std::vector<double> unit_conversions;
+  for (auto const field : fields) {
+    switch (field) {
+    case LBField::DENSITY:
+      unit_conversions.emplace_back(1. / (agrid * agrid * agrid));
+      break;
+    case LBField::VELOCITY:
+      unit_conversions.emplace_back(agrid / tau);
+      break;
+    case LBField::PRESSURE_TENSOR:
+    case LBField::PRESSURE_TENSOR_NEQ:
+      unit_conversions.emplace_back(1. / (tau * tau * agrid));
+      break;
+    default:
+      unit_conversions.emplace_back(1.);
+    }
+  }
+
+  if (lattice_switch == ActiveLB::GPU) {
+    // the fluid lives on the head node
+    lb_write_vtk_block(filename, MPI_COMM_SELF, fields, unit_conversions,
+                       stride, Utils::Vector3i{},
+                       lb_strided_index(lb_lbfluid_get_shape(), stride),
+                       lb_lbnode_append_field);
+  } else {
+    mpi_call_all(mpi_lb_write_vtk_local, filename, fields, unit_conversions,
+                 stride);
+  }
+}
+
 void lb_lbnode_set_density(const Utils::Vector3i &ind, double p_density) {
   if (lattice_switch == ActiveLB::GPU) {
 #ifdef CUDA
@@ -21,6 +21,7 @@
 
 #include "config.hpp"
 #include "grid_based_algorithms/lattice.hpp"
+#include "grid_based_algorithms/lb_constants.hpp"
 
 #include <utils/Vector.hpp>
 
@@ -76,6 +77,16 @@ ActiveLB lb_lbfluid_get_lattice_switch();
  */
 void lb_lbfluid_set_lattice_switch(ActiveLB local_lattice_switch);
 
+/**
+ * @brief Get the collide-and-stream implementation of the CPU LB.
+ */
+LBKernel lb_lbfluid_get_kernel();
+
+/**
+ * @brief Set the collide-and-stream implementation of the CPU LB.
+ */
+void lb_lbfluid_set_kernel(LBKernel kernel);
+
 /**
  * @brief Set the LB time step.
  */
@@ -226,6 +237,18 @@ int lb_lbnode_get_boundary(const Utils::Vector3i &ind);
  */
 const Utils::Vector19d lb_lbnode_get_pop(const Utils::Vector3i &ind);
 
+/**
+ * @brief Get a field of the LB fluid on all nodes in the box [lower, upper).
+ *
+ * The values are in LB units and in row-major order (z index running
+ * fastest), with @ref lb_field_size values per node. For the CPU fluid,
+ * every rank extracts its part of the box in a single pass and the parts
+ * are gathered on the head node.
+ */
+std::vector<double> lb_lbfluid_get_slab(LBField field,
+                                        Utils::Vector3i const &lower,
+                                        Utils::Vector3i const &upper);
+
 /* IO routines */
 void lb_lbfluid_print_vtk_boundary(const std::string &filename);
 void lb_lbfluid_print_vtk_velocity(const std::string &filename,
@@ -235,6 +258,20 @@ void lb_lbfluid_print_vtk_velocity(const std::string &filename,
 void lb_lbfluid_print_boundary(const std::string &filename);
 void lb_lbfluid_print_velocity(const std::string &filename);
 
+/**
+ * @brief Write fluid fields to a binary VTK XML image file (<tt>.vti</tt>).
+ *
+ * The values are in MD units. For the CPU fluid, every rank writes its own
+ * part of the lattice with MPI-IO. Errors are reported with
+ * @ref runtimeErrorMsg.
+ *
+ * @param filename  Path of the output file
+ * @param fields    Fields to write
+ * @param stride    Write every @p stride-th node in each direction
+ */
+void lb_lbfluid_write_vtk(std::string const &filename,
+                          std::vector<LBField> const &fields, int stride = 1);
+
 void lb_lbfluid_save_checkpoint(const std::string &filename, bool binary);
 void lb_lbfluid_load_checkpoint(const std::string &filename, bool binary);
 
@@ -34,6 +34,9 @@ public:
   }
   void init_volume_conservation(CellStructure &cs);
   void volume_conservation(CellStructure &cs);
+  /** Whether @ref volume_conservation adds forces, as found by
+   *  @ref init_volume_conservation. */
+  bool volume_conservation_active() const { return BoundariesFound; }
   void register_softID(int softID) {
     assert(softID >= 0);
     auto const new_size = static_cast<std::size_t>(softID) + 1;
@@ -54,6 +54,7 @@
 #include "rotation.hpp"
 #include "signalhandling.hpp"
 #include "thermostat.hpp"
+#include "threads.hpp"
 #include "virtual_sites.hpp"
 
 #include <profiler/profiler.hpp>
@@ -136,9 +137,8 @@ void unset_protocol() {
 template <class Kernel> void run_kernel() {
   if (box_geo.type() == BoxType::LEES_EDWARDS) {
     auto const kernel = Kernel{box_geo};
-    auto const particles = cell_structure.local_particles();
-    std::for_each(particles.begin(), particles.end(),
-                  [&kernel](auto &p) { kernel(p); });
+    for_each_particle(cell_structure.local_particles(),
+                      [&kernel](Particle &p) { kernel(p); });
   }
 }
 } // namespace LeesEdwards
@@ -167,7 +167,7 @@ void integrator_sanity_checks() {
     break;
 #endif
   case INTEG_METHOD_BD:
-    if (thermo_switch != THERMO_BROWNIAN)
+    if ((thermo_switch & ~THERMO_GLE) != THERMO_BROWNIAN)
       runtimeErrorMsg() << "The BD integrator requires the BD thermostat";
     break;
 #ifdef STOKESIAN_DYNAMICS
@@ -250,7 +250,21 @@ static void integrator_step_2(ParticleRange const &particles, double kT) {
   }
 }
 
-int integrate(int n_steps, int reuse_forces) {
+/** Update the accumulators that are due after @p steps more steps.
+ *  Errors are reported as runtime errors, since this is called by all
+ *  ranks inside the integration loop.
+ */
+static void auto_update_accumulators(int steps) {
+  try {
+    Accumulators::auto_update(comm_cart, steps);
+  } catch (std::exception const &err) {
+    if (comm_cart.rank() == 0) {
+      runtimeErrorMsg() << err.what();
+    }
+  }
+}
+
+int integrate(int n_steps, int reuse_forces, bool update_accumulators) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   // Prepare particle structure and run sanity checks of all active algorithms
@@ -269,9 +283,6 @@ int integrate(int n_steps, int reuse_forces) {
     virtual_sites()->update();
 #endif
 
-    // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
-
     force_calc(cell_structure, time_step, temperature);
 
     if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
@@ -291,6 +302,9 @@ int integrate(int n_steps, int reuse_forces) {
   // Keep track of the number of Verlet updates (i.e. particle resorts)
   int n_verlet_updates = 0;
 
+  // Steps since the last accumulator update
+  int accumulator_steps = 0;
+
 #ifdef VALGRIND_INSTRUMENTATION
   CALLGRIND_START_INSTRUMENTATION;
 #endif
@@ -338,13 +352,10 @@ int integrate(int n_steps, int reuse_forces) {
     if (cell_structure.get_resort_particles() >= Cells::RESORT_LOCAL)
       n_verlet_updates++;
 
-    // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
+    force_calc(cell_structure, time_step, temperature);
 
     particles = cell_structure.local_particles();
 
-    force_calc(cell_structure, time_step, temperature);
-
 #ifdef VIRTUAL_SITES
     virtual_sites()->after_force_calc();
 #endif
@@ -383,9 +394,18 @@ int integrate(int n_steps, int reuse_forces) {
 
     integrated_steps++;
 
+    // the step is not counted towards the accumulator updates
     if (check_runtime_errors(comm_cart))
       break;
 
+    if (update_accumulators and
+        ++accumulator_steps == Accumulators::auto_update_next_update()) {
+      auto_update_accumulators(accumulator_steps);
+      accumulator_steps = 0;
+      if (check_runtime_errors(comm_cart))
+        break;
+    }
+
     // Check if SIGINT has been caught.
     if (ctrl_C == 1) {
       notify_sig_int();
@@ -394,6 +414,10 @@ int integrate(int n_steps, int reuse_forces) {
 
   } // for-loop over integration steps
   LeesEdwards::update_box_params();
+  if (accumulator_steps > 0) {
+    // advance the counters, no accumulator is due
+    Accumulators::auto_update(comm_cart, accumulator_steps);
+  }
   ESPRESSO_PROFILER_CXX_MARK_LOOP_END(integration_loop);
 
 #ifdef VALGRIND_INSTRUMENTATION
@@ -418,6 +442,15 @@ int integrate(int n_steps, int reuse_forces) {
   return integrated_steps;
 }
 
+static int mpi_integrate_local(int n_steps, int reuse_forces,
+                               bool update_accumulators) {
+  integrate(n_steps, reuse_forces, update_accumulators);
+
+  return check_runtime_errors_local();
+}
+
+REGISTER_CALLBACK_REDUCTION(mpi_integrate_local, std::plus<int>())
+
 int python_integrate(int n_steps, bool recalc_forces_par,
                      bool reuse_forces_par) {
 
@@ -451,27 +484,10 @@ int python_integrate(int n_steps, bool recalc_forces_par,
     mpi_set_skin(new_skin);
   }
 
-  using Accumulators::auto_update;
-  using Accumulators::auto_update_next_update;
-
-  for (int i = 0; i < n_steps;) {
-    /* Integrate to either the next accumulator update, or the
-     * end, depending on what comes first. */
-    auto const steps = std::min((n_steps - i), auto_update_next_update());
-    if (mpi_integrate(steps, reuse_forces))
-      return ES_ERROR;
-
-    reuse_forces = 1;
-
-    auto_update(steps);
-
-    i += steps;
-  }
-
-  if (n_steps == 0) {
-    if (mpi_integrate(0, reuse_forces))
-      return ES_ERROR;
-  }
+  /* The accumulators are updated inside the integration loop */
+  if (mpi_call(Communication::Result::reduction, std::plus<int>(),
+               mpi_integrate_local, n_steps, reuse_forces, true))
+    return ES_ERROR;
 
   return ES_OK;
 }
@@ -487,17 +503,9 @@ int mpi_steepest_descent(int steps) {
                   steps);
 }
 
-static int mpi_integrate_local(int n_steps, int reuse_forces) {
-  integrate(n_steps, reuse_forces);
-
-  return check_runtime_errors_local();
-}
-
-REGISTER_CALLBACK_REDUCTION(mpi_integrate_local, std::plus<int>())
-
 int mpi_integrate(int n_steps, int reuse_forces) {
   return mpi_call(Communication::Result::reduction, std::plus<int>(),
-                  mpi_integrate_local, n_steps, reuse_forces);
+                  mpi_integrate_local, n_steps, reuse_forces, false);
 }
 
 void integrate_set_steepest_descent(const double f_max, const double gamma,
@@ -64,6 +64,10 @@ void integrator_sanity_checks();
  *                         meaning it is probably necessary
  *                       - 1: do not recalculate forces (mostly when reading
  *                         checkpoints with forces)
+ *  @param update_accumulators  Whether to update the auto-update
+ *                       accumulators when they are due. A step that ends
+ *                       with a runtime error is not counted towards the
+ *                       next update, since the integration stops there.
  *
  *  @details This function calls two hooks for propagation kernels such as
  *  velocity verlet, velocity verlet + npt box changes, and steepest_descent.
@@ -85,6 +89,9 @@ void integrator_sanity_checks();
  *    -# Update dependent properties (Virtual sites, RATTLE)
  *    -# Run single step algorithms (Lattice-Boltzmann propagation, collision
  *       detection, NpT update)
+ *    -# Update the accumulators that are due; the observables are
+ *       evaluated by all ranks, those calculated on the head node (energy,
+ *       pressure) run their MPI callbacks from within the loop
  *  - Final update of dependent properties and statistics/counters
  *
  *  High-level documentation of the integration and thermostatting schemes
@@ -92,7 +99,7 @@ void integrator_sanity_checks();
  *
  *  @return number of steps that have been integrated
  */
-int integrate(int n_steps, int reuse_forces);
+int integrate(int n_steps, int reuse_forces, bool update_accumulators = false);
 
 /** @brief Run the integration loop. Can be interrupted with Ctrl+C.
  *
@@ -29,6 +29,7 @@
 #include "rotation.hpp"
 #include "thermostat.hpp"
 #include "thermostats/brownian_inline.hpp"
+#include "threads.hpp"
 
 #include <utils/math/sqr.hpp>
 #include <utils/Vector.hpp>
@@ -37,13 +38,12 @@ inline void brownian_dynamics_propagator(BrownianThermostat const &brownian,
                                          const ParticleRange &particles,
                                          double time_step, double kT) {
 
-  Utils::Vector3d pos_random_walk = {0., 0., 0.};
-  for (auto &p : particles) {
+  for_each_particle(particles, [&brownian, time_step, kT](Particle &p) {
     // Don't propagate translational degrees of freedom of vs
     if (!p.is_virtual() or thermo_virtual) {
       p.pos() += bd_drag(brownian.gamma, p, time_step);
       p.v() = bd_drag_vel(brownian.gamma, p);
-      pos_random_walk = bd_random_walk(brownian, p, time_step, kT);
+      auto const pos_random_walk = bd_random_walk(brownian, p, time_step, kT);
       p.pos() += pos_random_walk;
       p.v() += pos_random_walk / time_step;
       /*
@@ -51,7 +51,7 @@ inline void brownian_dynamics_propagator(BrownianThermostat const &brownian,
       */
 #ifdef ROTATION
       if (!p.can_rotate())
-        continue;
+        return;
       convert_torque_to_body_frame_apply_fix(p);
       p.quat() = bd_drag_rot(brownian.gamma_rotation, p, time_step);
       p.omega() = bd_drag_vel_rot(brownian.gamma_rotation, p);
@@ -62,7 +62,7 @@ inline void brownian_dynamics_propagator(BrownianThermostat const &brownian,
       */
 #endif // ROTATION
     }
-  }
+  });
   increment_sim_time(time_step);
 }
 
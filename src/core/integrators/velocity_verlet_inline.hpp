@@ -26,6 +26,8 @@
 #include "cell_system/CellStructure.hpp"
 #include "integrate.hpp"
 #include "rotation.hpp"
+#include "threads.hpp"
+
 #include <cmath>
 
 /** Propagate the velocities and positions. Integration steps before force
@@ -36,14 +38,14 @@
 inline void velocity_verlet_propagate_vel_pos(const ParticleRange &particles,
                                               double time_step) {
 
-  for (auto &p : particles) {
+  for_each_particle(particles, [time_step](Particle &p) {
 #ifdef ROTATION
     propagate_omega_quat_particle(p, time_step);
 #endif
 
     // Don't propagate translational degrees of freedom of vs
     if (p.is_virtual())
-      continue;
+      return;
     for (int j = 0; j < 3; j++) {
       if (!p.is_fixed_along(j)) {
         /* Propagate velocities: v(t+0.5*dt) = v(t) + 0.5 * dt * a(t) */
@@ -55,7 +57,7 @@ inline void velocity_verlet_propagate_vel_pos(const ParticleRange &particles,
 
       }
     }
-  }
+  });
 }
 
 /** Final integration step of the Velocity Verlet integrator
@@ -64,10 +66,10 @@ inline void velocity_verlet_propagate_vel_pos(const ParticleRange &particles,
 inline void velocity_verlet_propagate_vel_final(const ParticleRange &particles,
                                                 double time_step) {
 
-  for (auto &p : particles) {
+  for_each_particle(particles, [time_step](Particle &p) {
     // Virtual sites are not propagated during integration
     if (p.is_virtual())
-      continue;
+      return;
 
     for (int j = 0; j < 3; j++) {
       if (!p.is_fixed_along(j)) {
@@ -75,7 +77,7 @@ inline void velocity_verlet_propagate_vel_final(const ParticleRange &particles,
         p.v()[j] += 0.5 * time_step * p.force()[j] / p.mass();
       }
     }
-  }
+  });
 }
 
 inline void velocity_verlet_step_1(const ParticleRange &particles,
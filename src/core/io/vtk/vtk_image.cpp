@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vtk_image.hpp"
+
+#include "errorhandling.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <mpi.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Vtk {
+
+static bool is_little_endian() {
+  std::uint16_t const one = 1u;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &one, 1u);
+  return first_byte == 1u;
+}
+
+/** @brief Number of bytes of the binary block of a field. */
+static std::uint64_t block_size(Utils::Vector3i const &shape,
+                                ImageField const &field) {
+  return static_cast<std::uint64_t>(Utils::product(shape)) *
+         field.n_components * sizeof(float);
+}
+
+/** @brief XML markup up to the start of the appended data. */
+static std::string xml_header(Utils::Vector3i const &shape,
+                              Utils::Vector3d const &origin, double spacing,
+                              std::vector<ImageField> const &fields) {
+  std::stringstream extent;
+  extent << "0 " << shape[0] - 1 << " 0 " << shape[1] - 1 << " 0 "
+         << shape[2] - 1;
+  std::stringstream xml;
+  xml.precision(17);
+  xml << "<?xml version=\"1.0\"?>\n"
+      << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\""
+      << (is_little_endian() ? "LittleEndian" : "BigEndian")
+      << "\" header_type=\"UInt64\">\n"
+      << "  <ImageData WholeExtent=\"" << extent.str() << "\" Origin=\""
+      << origin[0] << " " << origin[1] << " " << origin[2] << "\" Spacing=\""
+      << spacing << " " << spacing << " " << spacing << "\">\n"
+      << "    <Piece Extent=\"" << extent.str() << "\">\n"
+      << "      <PointData>\n";
+  // offsets are counted from the first byte after the underscore
+  std::uint64_t offset = 0u;
+  for (auto const &field : fields) {
+    xml << "        <DataArray type=\"Float32\" Name=\"" << field.name
+        << "\" NumberOfComponents=\"" << field.n_components
+        << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+    offset += sizeof(std::uint64_t) + block_size(shape, field);
+  }
+  xml << "      </PointData>\n"
+      << "    </Piece>\n"
+      << "  </ImageData>\n"
+      << "  <AppendedData encoding=\"raw\">\n"
+      << "_";
+  return xml.str();
+}
+
+/**
+ * @brief First failure of the MPI-IO calls of a rank.
+ *
+ * The ranks agree on the failure after every stage of the write, so that
+ * they stop together instead of waiting for each other in collective calls.
+ */
+class WriteStatus {
+  MPI_Comm m_comm;
+  int m_error = MPI_SUCCESS;
+
+public:
+  explicit WriteStatus(MPI_Comm comm) : m_comm(comm) {}
+
+  /** @brief Record the return code of an MPI call. */
+  void check(int ret) {
+    if (m_error == MPI_SUCCESS and ret != MPI_SUCCESS) {
+      m_error = ret;
+    }
+  }
+
+  /** @brief Whether all ranks succeeded so far. Collective call. */
+  bool all_succeeded() const {
+    int const failed = (m_error != MPI_SUCCESS) ? 1 : 0;
+    int any_failed;
+    MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_LOR, m_comm);
+    return any_failed == 0;
+  }
+
+  /** @brief Report the failure of this rank, if any. */
+  void report(std::string const &filename) const {
+    if (m_error == MPI_SUCCESS) {
+      return;
+    }
+    char buf[MPI_MAX_ERROR_STRING];
+    int buf_len;
+    MPI_Error_string(m_error, buf, &buf_len);
+    runtimeErrorMsg() << "Could not write VTK file \"" << filename
+                      << "\": " << std::string(buf, buf + buf_len);
+  }
+};
+
+void write_image(std::string const &filename, MPI_Comm comm,
+                 Utils::Vector3i const &shape, Utils::Vector3i const &lower,
+                 Utils::Vector3i const &upper, Utils::Vector3d const &origin,
+                 double spacing, std::vector<ImageField> const &fields) {
+  auto const header = xml_header(shape, origin, spacing, fields);
+  auto const footer = std::string("\n  </AppendedData>\n</VTKFile>\n");
+  auto const local_shape = upper - lower;
+  auto const n_local = Utils::product(local_shape);
+
+  /* file offsets of the binary blocks */
+  std::vector<MPI_Offset> block_offsets;
+  auto offset = static_cast<MPI_Offset>(header.size());
+  for (auto const &field : fields) {
+    offset += static_cast<MPI_Offset>(sizeof(std::uint64_t));
+    block_offsets.emplace_back(offset);
+    offset += static_cast<MPI_Offset>(block_size(shape, field));
+  }
+  auto const file_size = offset + static_cast<MPI_Offset>(footer.size());
+
+  WriteStatus status(comm);
+  MPI_File f;
+  auto const ret = MPI_File_open(comm, const_cast<char *>(filename.c_str()),
+                                 MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                                 MPI_INFO_NULL, &f);
+  status.check(ret);
+  if (not status.all_succeeded()) {
+    if (ret == MPI_SUCCESS) {
+      MPI_File_close(&f);
+    }
+    status.report(filename);
+    return;
+  }
+
+  auto const close_on_failure = [&]() {
+    if (status.all_succeeded()) {
+      return false;
+    }
+    MPI_File_close(&f);
+    status.report(filename);
+    return true;
+  };
+
+  // discard the contents of a previous file
+  status.check(MPI_File_set_size(f, file_size));
+
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+  if (rank == 0) {
+    status.check(MPI_File_write_at(f, 0, header.data(),
+                                   static_cast<int>(header.size()), MPI_CHAR,
+                                   MPI_STATUS_IGNORE));
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+      auto const n_bytes = block_size(shape, fields[i]);
+      status.check(MPI_File_write_at(
+          f, block_offsets[i] - static_cast<MPI_Offset>(sizeof(n_bytes)),
+          &n_bytes, static_cast<int>(sizeof(n_bytes)), MPI_BYTE,
+          MPI_STATUS_IGNORE));
+    }
+    status.check(MPI_File_write_at(
+        f, file_size - static_cast<MPI_Offset>(footer.size()), footer.data(),
+        static_cast<int>(footer.size()), MPI_CHAR, MPI_STATUS_IGNORE));
+  }
+  if (close_on_failure()) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < fields.size(); ++i) {
+    auto const &field = fields[i];
+    assert(field.values.size() ==
+           static_cast<std::size_t>(n_local) * field.n_components);
+    MPI_Datatype node_type;
+    MPI_Type_contiguous(static_cast<int>(field.n_components), MPI_FLOAT,
+                        &node_type);
+    MPI_Type_commit(&node_type);
+    // the local block is a subarray of the lattice, z index running slowest
+    MPI_Datatype block_type = node_type;
+    if (n_local > 0) {
+      int const sizes[3] = {shape[2], shape[1], shape[0]};
+      int const subsizes[3] = {local_shape[2], local_shape[1], local_shape[0]};
+      int const starts[3] = {lower[2], lower[1], lower[0]};
+      MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_C,
+                               node_type, &block_type);
+      MPI_Type_commit(&block_type);
+    }
+    status.check(MPI_File_set_view(f, block_offsets[i], node_type, block_type,
+                                   const_cast<char *>("native"),
+                                   MPI_INFO_NULL));
+    // a failed view has to be agreed on before the collective write
+    auto const view_failed = close_on_failure();
+    if (not view_failed) {
+      status.check(MPI_File_write_all(f, field.values.data(), n_local,
+                                      node_type, MPI_STATUS_IGNORE));
+    }
+    if (n_local > 0) {
+      MPI_Type_free(&block_type);
+    }
+    MPI_Type_free(&node_type);
+    if (view_failed or close_on_failure()) {
+      return;
+    }
+  }
+
+  status.check(MPI_File_close(&f));
+  if (not status.all_succeeded()) {
+    status.report(filename);
+  }
+}
+
+} // namespace Vtk
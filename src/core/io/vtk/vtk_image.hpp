@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_IO_VTK_VTK_IMAGE_HPP
+#define CORE_IO_VTK_VTK_IMAGE_HPP
+
+/** @file
+ *  Parallel binary output of lattice fields to VTK XML image files.
+ *
+ *  The file is a VTK XML @c ImageData file (<tt>.vti</tt>) with the values
+ *  of every field stored as raw 32-bit floats in the appended data section,
+ *  x index running fastest. Every rank writes the values of its own block
+ *  of the lattice with collective MPI-IO, the head rank of the communicator
+ *  writes the XML markup.
+ */
+
+#include <utils/Vector.hpp>
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Vtk {
+
+/** @brief Values of a lattice field on the local block. */
+struct ImageField {
+  /** Name of the data array */
+  std::string name;
+  /** Number of values per node */
+  std::size_t n_components;
+  /** Values on the nodes of the local block, x index running fastest */
+  std::vector<float> values;
+};
+
+/**
+ * @brief Write lattice fields to a VTK XML image file.
+ * To be called by all ranks of @p comm. The blocks of the ranks must not
+ * overlap and have to cover the lattice. Errors are reported with
+ * @ref runtimeErrorMsg.
+ *
+ * @param filename  Path of the output file, overwritten if it exists
+ * @param comm      Communicator of the ranks that write a block
+ * @param shape     Number of nodes of the lattice
+ * @param lower     Lower corner of the local block
+ * @param upper     Upper corner of the local block (exclusive)
+ * @param origin    Position of the first node
+ * @param spacing   Distance between nodes
+ * @param fields    Fields to write
+ */
+void write_image(std::string const &filename, MPI_Comm comm,
+                 Utils::Vector3i const &shape, Utils::Vector3i const &lower,
+                 Utils::Vector3i const &upper, Utils::Vector3d const &origin,
+                 double spacing, std::vector<ImageField> const &fields);
+
+} // namespace Vtk
+
+#endif
@@ -106,7 +106,10 @@ double DipolarP3M::calc_average_self_energy_k_space() const {
   auto const size = Utils::Vector3i{dp3m.fft.plan[3].new_mesh};
 
   auto const node_phi = grid_influence_function_self_energy(
-      dp3m.params, start, start + size, dp3m.g_energy);
+      dp3m.params, start, start + size, dp3m.g_energy,
+      [this](Utils::Vector3i const &n) {
+        return fft_ks_multiplicity(dp3m.fft, n[dp3m.fft.ks_half_dim]);
+      });
 
   double phi = 0.;
   boost::mpi::reduce(comm_cart, node_phi, phi, std::plus<>(), 0);
@@ -282,10 +285,13 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
       ind = 0;
       i = 0;
       double node_k_space_energy_dip = 0.0;
+      auto const half_dim = dp3m.fft.ks_half_dim;
+      auto const half_start = dp3m.fft.plan[3].start[half_dim];
       for (j[0] = 0; j[0] < dp3m.fft.plan[3].new_mesh[0]; j[0]++) {
         for (j[1] = 0; j[1] < dp3m.fft.plan[3].new_mesh[1]; j[1]++) {
           for (j[2] = 0; j[2] < dp3m.fft.plan[3].new_mesh[2]; j[2]++) {
             node_k_space_energy_dip +=
+                fft_ks_multiplicity(dp3m.fft, j[half_dim] + half_start) *
                 dp3m.g_energy[i] *
                 (Utils::sqr(
                      dp3m.rs_mesh_dip[0][ind] *
@@ -389,7 +395,7 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
         }
 
         /* Back FFT force component mesh */
-        fft_perform_back(dp3m.rs_mesh.data(), false, dp3m.fft, comm_cart);
+        fft_perform_back(dp3m.rs_mesh.data(), dp3m.fft, comm_cart);
         /* redistribute force component mesh */
         dp3m.sm.spread_grid(dp3m.rs_mesh.data(), comm_cart,
                             dp3m.local_mesh.dim);
@@ -467,17 +473,11 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
           }
         }
         /* Back FFT force component mesh */
-        fft_perform_back(dp3m.rs_mesh_dip[0].data(), false, dp3m.fft,
-                         comm_cart);
-        fft_perform_back(dp3m.rs_mesh_dip[1].data(), false, dp3m.fft,
-                         comm_cart);
-        fft_perform_back(dp3m.rs_mesh_dip[2].data(), false, dp3m.fft,
-                         comm_cart);
-        /* redistribute force component mesh */
         std::array<double *, 3> meshes = {{dp3m.rs_mesh_dip[0].data(),
                                            dp3m.rs_mesh_dip[1].data(),
                                            dp3m.rs_mesh_dip[2].data()}};
-
+        fft_perform_back(Utils::make_span(meshes), dp3m.fft, comm_cart);
+        /* redistribute force component mesh */
         dp3m.sm.spread_grid(Utils::make_span(meshes), comm_cart,
                             dp3m.local_mesh.dim);
         /* Assign force component from mesh to particle */
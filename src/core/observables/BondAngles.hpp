@@ -23,9 +23,11 @@
 #include "PidObservable.hpp"
 #include "grid.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <boost/algorithm/clamp.hpp>
+#include <boost/mpi/communicator.hpp>
 
 #include <cassert>
 #include <cmath>
@@ -49,15 +51,20 @@ public:
   }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const override {
+    auto const positions = detail::gather_positions(
+        comm, local_particles, local_slots, ids().size(), traits);
+    if (comm.rank() != 0) {
+      return {};
+    }
     std::vector<double> res(n_values());
-    auto v1 = box_geo.get_mi_vector(traits.position(particles[1]),
-                                    traits.position(particles[0]));
+    auto v1 = box_geo.get_mi_vector(positions[1], positions[0]);
     auto n1 = v1.norm();
     for (std::size_t i = 0, end = n_values(); i < end; i++) {
-      auto v2 = box_geo.get_mi_vector(traits.position(particles[i + 2]),
-                                      traits.position(particles[i + 1]));
+      auto v2 = box_geo.get_mi_vector(positions[i + 2], positions[i + 1]);
       auto const n2 = v2.norm();
       auto const cosine = boost::algorithm::clamp(
           (v1 * v2) / (n1 * n2), -TINY_COS_VALUE, TINY_COS_VALUE);
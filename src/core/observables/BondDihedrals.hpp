@@ -26,6 +26,8 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -53,17 +55,21 @@ public:
   }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const override {
+    auto const positions = detail::gather_positions(
+        comm, local_particles, local_slots, ids().size(), traits);
+    if (comm.rank() != 0) {
+      return {};
+    }
     std::vector<double> res(n_values());
-    auto v1 = box_geo.get_mi_vector(traits.position(particles[1]),
-                                    traits.position(particles[0]));
-    auto v2 = box_geo.get_mi_vector(traits.position(particles[2]),
-                                    traits.position(particles[1]));
+    auto v1 = box_geo.get_mi_vector(positions[1], positions[0]);
+    auto v2 = box_geo.get_mi_vector(positions[2], positions[1]);
     auto c1 = Utils::vector_product(v1, v2);
     for (std::size_t i = 0, end = n_values(); i < end; i++) {
-      auto v3 = box_geo.get_mi_vector(traits.position(particles[i + 3]),
-                                      traits.position(particles[i + 2]));
+      auto v3 = box_geo.get_mi_vector(positions[i + 3], positions[i + 2]);
       auto c2 = vector_product(v2, v3);
       /* the 2-argument arctangent returns an angle in the range [-pi, pi] that
        * allows for an unambiguous determination of the 4th particle position */
@@ -26,6 +26,8 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -49,15 +51,21 @@ public:
   }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const override {
+    auto const positions = detail::gather_positions(
+        comm, local_particles, local_slots, ids().size(), traits);
+    if (comm.rank() != 0) {
+      return {};
+    }
     auto const no_of_angles = n_values();
     auto const no_of_bonds = no_of_angles + 1;
     std::vector<double> angles(no_of_angles);
     std::vector<Utils::Vector3d> bond_vectors(no_of_bonds);
     auto get_bond_vector = [&](auto index) {
-      return box_geo.get_mi_vector(traits.position(particles[index + 1]),
-                                   traits.position(particles[index]));
+      return box_geo.get_mi_vector(positions[index + 1], positions[index]);
     };
     for (std::size_t i = 0; i < no_of_bonds; ++i) {
       auto const tmp = get_bond_vector(i);
@@ -25,8 +25,11 @@
 #include "grid.hpp"
 
 #include <utils/Histogram.hpp>
+#include <utils/Span.hpp>
 #include <utils/math/coordinate_transformation.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -35,11 +38,13 @@ class CylindricalDensityProfile : public CylindricalPidProfileObservable {
 public:
   using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &traits) const override {
     Utils::CylindricalHistogram<double, 1> histogram(n_bins(), limits());
 
-    for (auto const &p : particles) {
+    for (auto const &p : local_particles) {
       histogram.update(Utils::transform_coordinate_cartesian_to_cylinder(
           folded_position(traits.position(p), box_geo) -
               transform_params->center(),
@@ -47,7 +52,7 @@ public:
     }
 
     histogram.normalize();
-    return histogram.get_histogram();
+    return detail::reduce_sum(comm, histogram.get_histogram());
   }
 };
 
@@ -24,8 +24,11 @@
 #include "grid.hpp"
 
 #include <utils/Histogram.hpp>
+#include <utils/Span.hpp>
 #include <utils/math/coordinate_transformation.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <array>
 #include <cstddef>
 #include <utility>
@@ -37,12 +40,14 @@ public:
   using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
 
   std::vector<double>
-  evaluate(Utils::Span<std::reference_wrapper<const Particle>> particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &traits) const override {
     Utils::CylindricalHistogram<double, 3> histogram(n_bins(), limits());
 
     // Write data to the histogram
-    for (auto p : particles) {
+    for (auto p : local_particles) {
       auto const pos = folded_position(traits.position(p), box_geo) -
                        transform_params->center();
       histogram.update(
@@ -52,7 +57,7 @@ public:
               traits.velocity(p), transform_params->axis(), pos));
     }
     histogram.normalize();
-    return histogram.get_histogram();
+    return detail::reduce_sum(comm, histogram.get_histogram());
   }
   std::vector<std::size_t> shape() const override {
     auto const b = n_bins();
@@ -26,39 +26,49 @@
 #include <utils/Span.hpp>
 #include <utils/math/coordinate_transformation.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
+#include <algorithm>
 #include <vector>
 
 namespace Observables {
 std::vector<double>
 CylindricalLBFluxDensityProfileAtParticlePositions::evaluate(
-    Utils::Span<std::reference_wrapper<const Particle>> particles,
+    boost::mpi::communicator const &comm,
+    ParticleReferenceRange local_particles,
+    Utils::Span<const std::size_t> local_slots,
     const ParticleObservables::traits<Particle> &traits) const {
-  Utils::CylindricalHistogram<double, 3> histogram(n_bins(), limits());
-  // First collect all positions (since we want to call the LB function to
-  // get the fluid velocities only once).
+  // The fluid is interpolated by the head node at the particle positions.
+  auto const positions = detail::gather_positions(
+      comm, local_particles, local_slots, ids().size(), traits);
+  return calculate_on_head_node(comm, [&]() {
+    Utils::CylindricalHistogram<double, 3> histogram(n_bins(), limits());
+    // First collect all positions (since we want to call the LB function to
+    // get the fluid velocities only once).
 
-  for (auto p : particles) {
-    auto const pos = folded_position(traits.position(p), box_geo);
-    auto const v = lb_lbfluid_get_interpolated_velocity(pos) *
-                   lb_lbfluid_get_lattice_speed();
-    auto const flux_dens = lb_lbfluid_get_interpolated_density(pos) * v;
+    for (auto const &unfolded_pos : positions) {
+      auto const pos = folded_position(unfolded_pos, box_geo);
+      auto const v = lb_lbfluid_get_interpolated_velocity(pos) *
+                     lb_lbfluid_get_lattice_speed();
+      auto const flux_dens = lb_lbfluid_get_interpolated_density(pos) * v;
 
-    histogram.update(Utils::transform_coordinate_cartesian_to_cylinder(
-                         pos - transform_params->center(),
-                         transform_params->axis(),
-                         transform_params->orientation()),
-                     Utils::transform_vector_cartesian_to_cylinder(
-                         flux_dens, transform_params->axis(),
-                         pos - transform_params->center()));
-  }
+      histogram.update(Utils::transform_coordinate_cartesian_to_cylinder(
+                           pos - transform_params->center(),
+                           transform_params->axis(),
+                           transform_params->orientation()),
+                       Utils::transform_vector_cartesian_to_cylinder(
+                           flux_dens, transform_params->axis(),
+                           pos - transform_params->center()));
+    }
 
-  // normalize by number of hits per bin
-  auto hist_tmp = histogram.get_histogram();
-  auto tot_count = histogram.get_tot_count();
-  std::transform(hist_tmp.begin(), hist_tmp.end(), tot_count.begin(),
-                 hist_tmp.begin(), [](auto hi, auto ci) {
-                   return ci > 0 ? hi / static_cast<double>(ci) : 0.;
-                 });
-  return hist_tmp;
+    // normalize by number of hits per bin
+    auto hist_tmp = histogram.get_histogram();
+    auto tot_count = histogram.get_tot_count();
+    std::transform(hist_tmp.begin(), hist_tmp.end(), tot_count.begin(),
+                   hist_tmp.begin(), [](auto hi, auto ci) {
+                     return ci > 0 ? hi / static_cast<double>(ci) : 0.;
+                   });
+    return hist_tmp;
+  });
 }
 } // namespace Observables
@@ -26,6 +26,8 @@
 
 #include <utils/Span.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <functional>
 #include <vector>
@@ -37,7 +39,9 @@ public:
   using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
 
   std::vector<double>
-  evaluate(Utils::Span<std::reference_wrapper<const Particle>> particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const override;
 
   std::vector<std::size_t> shape() const override {
@@ -27,6 +27,8 @@
 #include <utils/Span.hpp>
 #include <utils/math/coordinate_transformation.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <array>
 #include <cstddef>
 #include <utility>
@@ -38,11 +40,13 @@ public:
   using CylindricalPidProfileObservable::CylindricalPidProfileObservable;
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &traits) const override {
     Utils::CylindricalHistogram<double, 3> histogram(n_bins(), limits());
 
-    for (auto p : particles) {
+    for (auto p : local_particles) {
       auto const pos = folded_position(traits.position(p), box_geo) -
                        transform_params->center();
       histogram.update(
@@ -52,8 +56,8 @@ public:
               traits.velocity(p), transform_params->axis(), pos));
     }
 
-    auto hist_tmp = histogram.get_histogram();
-    auto tot_count = histogram.get_tot_count();
+    auto hist_tmp = detail::reduce_sum(comm, histogram.get_histogram());
+    auto const tot_count = detail::reduce_sum(comm, histogram.get_tot_count());
     for (std::size_t ind = 0; ind < hist_tmp.size(); ++ind) {
       if (tot_count[ind] > 0) {
         hist_tmp[ind] /= static_cast<double>(tot_count[ind]);
@@ -22,6 +22,8 @@
 #include "Observable.hpp"
 #include "dpd.hpp"
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -30,7 +32,10 @@ namespace Observables {
 class DPDStress : public Observable {
 public:
   std::vector<std::size_t> shape() const override { return {3, 3}; }
-  std::vector<double> operator()() const override { return dpd_stress(); }
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const override {
+    return calculate_on_head_node(comm, []() { return dpd_stress(); });
+  }
 };
 
 } // Namespace Observables
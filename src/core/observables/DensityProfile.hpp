@@ -27,6 +27,9 @@
 #include <utils/Histogram.hpp>
 #include <utils/Span.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
+#include <cstddef>
 #include <vector>
 
 namespace Observables {
@@ -36,15 +39,17 @@ public:
   using PidProfileObservable::PidProfileObservable;
 
   std::vector<double>
-  evaluate(Utils::Span<std::reference_wrapper<const Particle>> particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &traits) const override {
     Utils::Histogram<double, 1> histogram(n_bins(), limits());
 
-    for (auto p : particles) {
+    for (auto p : local_particles) {
       histogram.update(folded_position(traits.position(p), box_geo));
     }
     histogram.normalize();
-    return histogram.get_histogram();
+    return detail::reduce_sum(comm, histogram.get_histogram());
   }
 };
 } // Namespace Observables
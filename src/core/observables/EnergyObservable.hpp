@@ -22,6 +22,8 @@
 #include "Observable.hpp"
 #include "energy.hpp"
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -30,10 +32,13 @@ namespace Observables {
 class Energy : public Observable {
 public:
   std::vector<std::size_t> shape() const override { return {1}; }
-  std::vector<double> operator()() const override {
-    std::vector<double> res{1};
-    res[0] = observable_compute_energy();
-    return res;
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const override {
+    return calculate_on_head_node(comm, []() {
+      std::vector<double> res{1};
+      res[0] = observable_compute_energy();
+      return res;
+    });
   }
 };
 
@@ -27,6 +27,8 @@
 #include <utils/Histogram.hpp>
 #include <utils/Span.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -40,16 +42,18 @@ public:
   }
 
   std::vector<double>
-  evaluate(Utils::Span<std::reference_wrapper<const Particle>> particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &traits) const override {
     Utils::Histogram<double, 3> histogram(n_bins(), limits());
 
-    for (auto p : particles) {
+    for (auto p : local_particles) {
       auto const ppos = folded_position(traits.position(p), box_geo);
       histogram.update(ppos, traits.velocity(p));
     }
     histogram.normalize();
-    return histogram.get_histogram();
+    return detail::reduce_sum(comm, histogram.get_histogram());
   }
 };
 
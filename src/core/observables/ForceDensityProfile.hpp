@@ -25,6 +25,9 @@
 #include "grid.hpp"
 
 #include <utils/Histogram.hpp>
+#include <utils/Span.hpp>
+
+#include <boost/mpi/communicator.hpp>
 
 #include <array>
 #include <cstddef>
@@ -41,15 +44,17 @@ public:
   }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &) const override {
     Utils::Histogram<double, 3> histogram(n_bins(), limits());
-    for (auto const &p : particles) {
+    for (auto const &p : local_particles) {
       histogram.update(folded_position(p.get().pos(), box_geo),
                        p.get().force());
     }
     histogram.normalize();
-    return histogram.get_histogram();
+    return detail::reduce_sum(comm, histogram.get_histogram());
   }
 };
 
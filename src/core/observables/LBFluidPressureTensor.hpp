@@ -24,6 +24,8 @@
 
 #include <utils/math/sqr.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -31,14 +33,17 @@ namespace Observables {
 class LBFluidPressureTensor : public Observable {
 public:
   std::vector<std::size_t> shape() const override { return {3, 3}; }
-  std::vector<double> operator()() const override {
-    auto const unit_conversion =
-        1. / (lb_lbfluid_get_agrid() * Utils::sqr(lb_lbfluid_get_tau()));
-    auto const lower_triangle =
-        lb_lbfluid_get_pressure_tensor() * unit_conversion;
-    return {lower_triangle[0], lower_triangle[1], lower_triangle[3],
-            lower_triangle[1], lower_triangle[2], lower_triangle[4],
-            lower_triangle[3], lower_triangle[4], lower_triangle[5]};
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const override {
+    return calculate_on_head_node(comm, []() -> std::vector<double> {
+      auto const unit_conversion =
+          1. / (lb_lbfluid_get_agrid() * Utils::sqr(lb_lbfluid_get_tau()));
+      auto const lower_triangle =
+          lb_lbfluid_get_pressure_tensor() * unit_conversion;
+      return {lower_triangle[0], lower_triangle[1], lower_triangle[3],
+              lower_triangle[1], lower_triangle[2], lower_triangle[4],
+              lower_triangle[3], lower_triangle[4], lower_triangle[5]};
+    });
   }
 };
 
@@ -22,6 +22,8 @@
 
 #include <utils/Histogram.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <stdexcept>
 #include <string>
@@ -29,26 +31,29 @@
 
 namespace Observables {
 
-std::vector<double> LBVelocityProfile::operator()() const {
-  Utils::Histogram<double, 3> histogram(n_bins(), limits());
-  for (auto const &p : sampling_positions) {
-    const auto v = lb_lbfluid_get_interpolated_velocity(p) *
-                   lb_lbfluid_get_lattice_speed();
-    histogram.update(p, v);
-  }
-  auto hist_tmp = histogram.get_histogram();
-  auto const tot_count = histogram.get_tot_count();
-  for (std::size_t ind = 0; ind < hist_tmp.size(); ++ind) {
-    if (tot_count[ind] == 0 and not allow_empty_bins) {
-      auto const error = "Decrease sampling delta(s), bin " +
-                         std::to_string(ind) + " has no hit";
-      throw std::runtime_error(error);
+std::vector<double>
+LBVelocityProfile::operator()(boost::mpi::communicator const &comm) const {
+  return calculate_on_head_node(comm, [this]() {
+    Utils::Histogram<double, 3> histogram(n_bins(), limits());
+    for (auto const &p : sampling_positions) {
+      const auto v = lb_lbfluid_get_interpolated_velocity(p) *
+                     lb_lbfluid_get_lattice_speed();
+      histogram.update(p, v);
     }
-    if (tot_count[ind] > 0) {
-      hist_tmp[ind] /= static_cast<double>(tot_count[ind]);
+    auto hist_tmp = histogram.get_histogram();
+    auto const tot_count = histogram.get_tot_count();
+    for (std::size_t ind = 0; ind < hist_tmp.size(); ++ind) {
+      if (tot_count[ind] == 0 and not allow_empty_bins) {
+        auto const error = "Decrease sampling delta(s), bin " +
+                           std::to_string(ind) + " has no hit";
+        throw std::runtime_error(error);
+      }
+      if (tot_count[ind] > 0) {
+        hist_tmp[ind] /= static_cast<double>(tot_count[ind]);
+      }
     }
-  }
-  return hist_tmp;
+    return hist_tmp;
+  });
 }
 
 } // namespace Observables
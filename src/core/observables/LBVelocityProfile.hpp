@@ -21,6 +21,8 @@
 
 #include "LBProfileObservable.hpp"
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -33,7 +35,8 @@ public:
     auto const b = n_bins();
     return {b[0], b[1], b[2], 3};
   }
-  std::vector<double> operator()() const override;
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const override;
 };
 
 } // Namespace Observables
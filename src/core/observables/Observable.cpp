@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Observable.hpp"
+
+#include "communication.hpp"
+
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/communicator.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace Observables {
+std::vector<double>
+calculate_on_head_node(boost::mpi::communicator const &comm,
+                       std::function<std::vector<double>()> const &kernel) {
+  auto &callbacks = Communication::mpiCallbacks();
+  if (comm.rank() != 0) {
+    callbacks.loop();
+    auto failed = false;
+    boost::mpi::broadcast(comm, failed, 0);
+    if (failed) {
+      throw std::runtime_error("Observable evaluation failed on rank 0");
+    }
+    return {};
+  }
+
+  std::vector<double> result;
+  try {
+    result = kernel();
+  } catch (...) {
+    callbacks.abort_loop();
+    auto failed = true;
+    boost::mpi::broadcast(comm, failed, 0);
+    throw;
+  }
+  callbacks.abort_loop();
+  auto failed = false;
+  boost::mpi::broadcast(comm, failed, 0);
+  return result;
+}
+} // namespace Observables
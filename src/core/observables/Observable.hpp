@@ -20,6 +20,8 @@
 #ifndef OBSERVABLES_OBSERVABLE_HPP
 #define OBSERVABLES_OBSERVABLE_HPP
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <functional>
 #include <numeric>
@@ -41,8 +43,13 @@ class Observable {
 public:
   Observable() = default;
   virtual ~Observable() = default;
-  /** Calculate the set of values measured by the observable */
-  virtual std::vector<double> operator()() const = 0;
+  /** Calculate the set of values measured by the observable.
+   *  This is a collective call that has to be made on all ranks of
+   *  @p comm, the values are only returned on rank 0. Errors are thrown
+   *  on all ranks.
+   */
+  virtual std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const = 0;
 
   /** Size of the flat array returned by the observable */
   std::size_t n_values() const {
@@ -54,5 +61,19 @@ public:
   virtual std::vector<std::size_t> shape() const = 0;
 };
 
+/** Calculate the values of an observable on the head node.
+ *  For observables that are calculated by the head node with the help of
+ *  callbacks: this is a collective call, during which the other ranks
+ *  serve the callbacks of the head node.
+ *  @param comm      Communicator, the head node is rank 0
+ *  @param kernel    Calculation on the head node
+ *  @return The values on rank 0, an empty vector on the other ranks.
+ *  @throw The exception of the kernel on rank 0, a @c std::runtime_error
+ *         on the other ranks.
+ */
+std::vector<double>
+calculate_on_head_node(boost::mpi::communicator const &comm,
+                       std::function<std::vector<double>()> const &kernel);
+
 } // Namespace Observables
 #endif
@@ -23,7 +23,10 @@
 
 #include <utils/Span.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace Observables {
@@ -33,20 +36,23 @@ public:
   using PidObservable::PidObservable;
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &) const override {
-    std::vector<double> res(n_values());
+    std::vector<double> local(3 * local_particles.size());
 #ifdef ROTATION
     std::size_t i = 0;
-    for (auto const &p : particles) {
+    for (auto const &p : local_particles) {
       auto const &omega = p.get().omega();
-      res[3 * i + 0] = omega[0];
-      res[3 * i + 1] = omega[1];
-      res[3 * i + 2] = omega[2];
+      local[3 * i + 0] = omega[0];
+      local[3 * i + 1] = omega[1];
+      local[3 * i + 2] = omega[2];
       i++;
     }
 #endif
-    return res;
+    return detail::gather_slots(comm, std::move(local), 3, local_slots,
+                                ids().size());
   }
 
   std::vector<std::size_t> shape() const override { return {ids().size(), 3}; }
@@ -25,7 +25,10 @@
 
 #include <utils/Span.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace Observables {
@@ -35,20 +38,23 @@ public:
   using PidObservable::PidObservable;
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const override {
-    std::vector<double> res(n_values());
-    for (std::size_t i = 0; i < particles.size(); i++) {
+    std::vector<double> local(3 * local_particles.size());
+    for (std::size_t i = 0; i < local_particles.size(); i++) {
 #ifdef ROTATION
       const Utils::Vector3d vel_body = convert_vector_space_to_body(
-          particles[i].get(), traits.velocity(particles[i]));
+          local_particles[i].get(), traits.velocity(local_particles[i]));
 
-      res[3 * i + 0] = vel_body[0];
-      res[3 * i + 1] = vel_body[1];
-      res[3 * i + 2] = vel_body[2];
+      local[3 * i + 0] = vel_body[0];
+      local[3 * i + 1] = vel_body[1];
+      local[3 * i + 2] = vel_body[2];
 #endif
     }
-    return res;
+    return detail::gather_slots(comm, std::move(local), 3, local_slots,
+                                ids().size());
   }
   std::vector<std::size_t> shape() const override { return {ids().size(), 3}; }
 };
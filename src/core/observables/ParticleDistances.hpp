@@ -26,6 +26,8 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/mpi/communicator.hpp>
+
 #include <cassert>
 #include <cstddef>
 #include <stdexcept>
@@ -48,13 +50,19 @@ public:
   }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const override {
+    auto const positions = detail::gather_positions(
+        comm, local_particles, local_slots, ids().size(), traits);
+    if (comm.rank() != 0) {
+      return {};
+    }
     std::vector<double> res(n_values());
 
     for (std::size_t i = 0, end = n_values(); i < end; i++) {
-      auto const v = box_geo.get_mi_vector(traits.position(particles[i]),
-                                           traits.position(particles[i + 1]));
+      auto const v = box_geo.get_mi_vector(positions[i], positions[i + 1]);
       res[i] = v.norm();
     }
     return res;
@@ -22,7 +22,12 @@
 #include "Particle.hpp"
 #include "PidObservable.hpp"
 
+#include <utils/Span.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
+#include <utility>
 #include <vector>
 
 namespace Observables {
@@ -36,18 +41,21 @@ public:
   using PidObservable::PidObservable;
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &) const override {
-    std::vector<double> res(n_values());
+    std::vector<double> local(3 * local_particles.size());
     std::size_t i = 0;
-    for (auto const &p : particles) {
+    for (auto const &p : local_particles) {
       auto const &f = p.get().f.f;
-      res[3 * i + 0] = f[0];
-      res[3 * i + 1] = f[1];
-      res[3 * i + 2] = f[2];
+      local[3 * i + 0] = f[0];
+      local[3 * i + 1] = f[1];
+      local[3 * i + 2] = f[2];
       i++;
     }
-    return res;
+    return detail::gather_slots(comm, std::move(local), 3, local_slots,
+                                ids().size());
   };
   std::vector<std::size_t> shape() const override { return {ids().size(), 3}; }
 };
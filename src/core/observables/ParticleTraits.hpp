@@ -21,6 +21,7 @@
 
 #include "Particle.hpp"
 #include "config.hpp"
+#include "grid.hpp"
 
 namespace ParticleObservables {
 /**
@@ -29,7 +30,9 @@ namespace ParticleObservables {
  * of observables independent of the particle type.
  */
 template <> struct traits<Particle> {
-  auto position(Particle const &p) const { return p.pos(); }
+  auto position(Particle const &p) const {
+    return unfolded_position(p.pos(), p.image_box(), box_geo.length());
+  }
   auto velocity(Particle const &p) const { return p.v(); }
   auto mass(Particle const &p) const {
 #ifdef VIRTUAL_SITES
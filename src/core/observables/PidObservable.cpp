@@ -18,19 +18,54 @@
  */
 #include "PidObservable.hpp"
 
+#include "Particle.hpp"
 #include "ParticleTraits.hpp"
-#include "fetch_particles.hpp"
+#include "cells.hpp"
 
+#include <utils/Span.hpp>
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/communicator.hpp>
+
+#include <cstddef>
 #include <functional>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace Observables {
-std::vector<double> PidObservable::operator()() const {
-  std::vector<Particle> particles = fetch_particles(ids());
+std::vector<double>
+PidObservable::operator()(boost::mpi::communicator const &comm) const {
+  std::vector<std::reference_wrapper<const Particle>> local_particles;
+  std::vector<std::size_t> local_slots;
+  for (std::size_t i = 0; i < m_ids.size(); ++i) {
+    auto const p = cell_structure.get_local_particle(m_ids[i]);
+    if (p and not p->is_ghost()) {
+      local_particles.emplace_back(*p);
+      local_slots.emplace_back(i);
+    }
+  }
+
+  auto const n_found = boost::mpi::all_reduce(comm, local_slots.size(),
+                                              std::plus<std::size_t>());
+  if (n_found != m_ids.size()) {
+    std::vector<int> found(m_ids.size(), 0);
+    for (auto const i : local_slots) {
+      found[i] = 1;
+    }
+    std::vector<int> found_anywhere(found.size());
+    boost::mpi::all_reduce(comm, found.data(), static_cast<int>(found.size()),
+                           found_anywhere.data(), std::plus<int>());
+    for (std::size_t i = 0; i < m_ids.size(); ++i) {
+      if (not found_anywhere[i]) {
+        throw std::runtime_error("Particle with id " +
+                                 std::to_string(m_ids[i]) + " not found");
+      }
+    }
+  }
 
-  std::vector<std::reference_wrapper<const Particle>> particle_refs(
-      particles.begin(), particles.end());
-  return this->evaluate(ParticleReferenceRange(particle_refs),
+  return this->evaluate(comm, ParticleReferenceRange(local_particles),
+                        Utils::make_const_span(local_slots),
                         ParticleObservables::traits<Particle>{});
 }
 } // namespace Observables
@@ -29,9 +29,15 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 #include <utils/flatten.hpp>
+#include <utils/mpi/gather_buffer.hpp>
 
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/communicator.hpp>
 #include <boost/range/algorithm/copy.hpp>
+#include <boost/serialization/utility.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
 #include <functional>
 #include <iterator>
@@ -48,18 +54,33 @@ using ParticleReferenceRange =
  *
  *  Base class for observables extracting raw data from particle subsets and
  *  returning either the data or a statistic derived from it.
+ *
+ *  The observable is evaluated by all ranks together: each rank evaluates
+ *  the particles it owns, and only the local result (a partial sum, a
+ *  histogram or the values of the particles) is sent to the head node.
  */
 class PidObservable : virtual public Observable {
   /** Identifiers of particles measured by this observable */
   std::vector<int> m_ids;
 
+  /** Evaluate the observable on the particles of this rank.
+   *  @param comm             Communicator
+   *  @param local_particles  The particles of @ref ids() on this rank
+   *  @param local_slots      The position of each of these particles
+   *                          in @ref ids()
+   *  @param traits           %Particle traits
+   *  @return The values on rank 0.
+   */
   virtual std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &traits) const = 0;
 
 public:
   explicit PidObservable(std::vector<int> ids) : m_ids(std::move(ids)) {}
-  std::vector<double> operator()() const final;
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const final;
   std::vector<int> const &ids() const { return m_ids; }
 };
 
@@ -85,6 +106,82 @@ template <class T> struct shape_impl<std::vector<T>> {
     return ret;
   }
 };
+
+template <class T> struct is_map : std::false_type {};
+template <class ValueOp>
+struct is_map<ParticleObservables::Map<ValueOp>> : std::true_type {};
+
+/** Collect the values of the particles on rank 0.
+ *  @param comm       Communicator
+ *  @param values     Values of the local particles, @p width per particle
+ *  @param width      Number of values per particle
+ *  @param slots      Position of each local particle in the output
+ *  @param n_slots    Number of particles in the output
+ *  @return The values of all particles in the order of the slots on
+ *          rank 0, an empty vector on the other ranks.
+ */
+inline std::vector<double> gather_slots(boost::mpi::communicator const &comm,
+                                        std::vector<double> values,
+                                        std::size_t width,
+                                        Utils::Span<const std::size_t> slots,
+                                        std::size_t n_slots) {
+  assert(values.size() == width * slots.size());
+  std::vector<std::size_t> all_slots(slots.begin(), slots.end());
+  Utils::Mpi::gather_buffer(values, comm);
+  Utils::Mpi::gather_buffer(all_slots, comm);
+  if (comm.rank() != 0) {
+    return {};
+  }
+
+  std::vector<double> res(width * n_slots);
+  for (std::size_t i = 0; i < all_slots.size(); ++i) {
+    auto const src = static_cast<std::ptrdiff_t>(width * i);
+    auto const dst = static_cast<std::ptrdiff_t>(width * all_slots[i]);
+    std::copy_n(values.begin() + src, width, res.begin() + dst);
+  }
+  return res;
+}
+
+/** Collect the unfolded positions of the particles on rank 0.
+ *  @return The positions in the order of the slots on rank 0,
+ *          an empty vector on the other ranks.
+ */
+inline std::vector<Utils::Vector3d>
+gather_positions(boost::mpi::communicator const &comm,
+                 ParticleReferenceRange local_particles,
+                 Utils::Span<const std::size_t> local_slots,
+                 std::size_t n_slots,
+                 ParticleObservables::traits<Particle> const &traits) {
+  std::vector<double> local;
+  local.reserve(3 * local_particles.size());
+  for (auto const &p : local_particles) {
+    auto const pos = traits.position(p);
+    local.insert(local.end(), pos.begin(), pos.end());
+  }
+  auto const flat =
+      gather_slots(comm, std::move(local), 3, local_slots, n_slots);
+  std::vector<Utils::Vector3d> res(flat.size() / 3);
+  for (std::size_t i = 0; i < res.size(); ++i) {
+    res[i] = {flat[3 * i + 0], flat[3 * i + 1], flat[3 * i + 2]};
+  }
+  return res;
+}
+
+/** Sum arrays element-wise over all ranks.
+ *  @return The sum on rank 0, an empty vector on the other ranks.
+ */
+template <class T>
+std::vector<T> reduce_sum(boost::mpi::communicator const &comm,
+                          std::vector<T> const &local) {
+  auto const n = static_cast<int>(local.size());
+  if (comm.rank() != 0) {
+    boost::mpi::reduce(comm, local.data(), n, std::plus<T>(), 0);
+    return {};
+  }
+  std::vector<T> res(local.size());
+  boost::mpi::reduce(comm, local.data(), n, res.data(), std::plus<T>(), 0);
+  return res;
+}
 } // namespace detail
 
 /**
@@ -112,10 +209,44 @@ public:
   }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t> local_slots,
            const ParticleObservables::traits<Particle> &) const override {
+    return evaluate(comm, local_particles, local_slots,
+                    detail::is_map<ObsType>{});
+  }
+
+private:
+  /** Values of individual particles, collected on the head node. */
+  std::vector<double> evaluate(boost::mpi::communicator const &comm,
+                               ParticleReferenceRange local_particles,
+                               Utils::Span<const std::size_t> local_slots,
+                               std::true_type) const {
+    std::vector<double> local_values;
+    Utils::flatten(ObsType{}(local_particles),
+                   std::back_inserter(local_values));
+    auto const width = ids().empty() ? 0u : n_values() / ids().size();
+    return detail::gather_slots(comm, std::move(local_values), width,
+                                local_slots, ids().size());
+  }
+
+  /** Reduction over the particles, from the partial results of the ranks. */
+  std::vector<double> evaluate(boost::mpi::communicator const &comm,
+                               ParticleReferenceRange local_particles,
+                               Utils::Span<const std::size_t>,
+                               std::false_type) const {
+    auto const algorithm = ObsType{};
+    auto const local = algorithm.partial(local_particles);
+    if (comm.rank() != 0) {
+      boost::mpi::reduce(comm, local, ParticleObservables::PartialSum{}, 0);
+      return {};
+    }
+    auto total = local;
+    boost::mpi::reduce(comm, local, total, ParticleObservables::PartialSum{},
+                       0);
     std::vector<double> res;
-    Utils::flatten(ObsType{}(particles), std::back_inserter(res));
+    Utils::flatten(algorithm.finalize(total), std::back_inserter(res));
     return res;
   }
 };
@@ -21,6 +21,9 @@
 
 #include "Observable.hpp"
 #include "pressure.hpp"
+
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -29,11 +32,14 @@ namespace Observables {
 class Pressure : public Observable {
 public:
   std::vector<std::size_t> shape() const override { return {1}; }
-  std::vector<double> operator()() const override {
-    auto const ptensor = observable_compute_pressure_tensor();
-    std::vector<double> res{1};
-    res[0] = (ptensor[0] + ptensor[4] + ptensor[8]) / 3.;
-    return res;
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const override {
+    return calculate_on_head_node(comm, []() {
+      auto const ptensor = observable_compute_pressure_tensor();
+      std::vector<double> res{1};
+      res[0] = (ptensor[0] + ptensor[4] + ptensor[8]) / 3.;
+      return res;
+    });
   }
 };
 
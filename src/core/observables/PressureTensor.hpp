@@ -21,6 +21,9 @@
 
 #include "Observable.hpp"
 #include "pressure.hpp"
+
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -29,8 +32,11 @@ namespace Observables {
 class PressureTensor : public Observable {
 public:
   std::vector<std::size_t> shape() const override { return {3, 3}; }
-  std::vector<double> operator()() const override {
-    return observable_compute_pressure_tensor().as_vector();
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const override {
+    return calculate_on_head_node(comm, []() {
+      return observable_compute_pressure_tensor().as_vector();
+    });
   }
 };
 
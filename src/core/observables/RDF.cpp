@@ -19,74 +19,121 @@
 #include "RDF.hpp"
 
 #include "BoxGeometry.hpp"
-#include "fetch_particles.hpp"
+#include "Particle.hpp"
+#include "analysis_pair_loop.hpp"
+#include "cells.hpp"
 #include "grid.hpp"
 
-#include <utils/Span.hpp>
-#include <utils/Vector.hpp>
 #include <utils/constants.hpp>
-#include <utils/for_each_pair.hpp>
 #include <utils/math/int_pow.hpp>
 
-#include <boost/range/algorithm/transform.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/collectives/reduce.hpp>
+#include <boost/mpi/communicator.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <functional>
-#include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace Observables {
-std::vector<double> RDF::operator()() const {
-  std::vector<Particle> particles1 = fetch_particles(ids1());
-  std::vector<const Particle *> particles_ptrs1(particles1.size());
-  boost::transform(particles1, particles_ptrs1.begin(),
-                   [](auto const &p) { return std::addressof(p); });
-
-  if (ids2().empty()) {
-    return this->evaluate(particles_ptrs1, {});
+namespace {
+/** Number of occurrences of each particle id in @p ids. */
+std::vector<int> multiplicities(std::vector<int> const &ids,
+                                std::size_t size) {
+  std::vector<int> res(size, 0);
+  for (auto const id : ids) {
+    res[static_cast<std::size_t>(id)]++;
   }
+  return res;
+}
 
-  std::vector<Particle> particles2 = fetch_particles(ids2());
-  std::vector<const Particle *> particles_ptrs2(particles2.size());
-  boost::transform(particles2, particles_ptrs2.begin(),
-                   [](auto const &p) { return std::addressof(p); });
-  return this->evaluate(particles_ptrs1, particles_ptrs2);
+/** Throw on all ranks if a particle of @p ids exists on no rank. */
+void check_particles_exist(boost::mpi::communicator const &comm,
+                           std::vector<int> const &ids) {
+  std::vector<int> found(ids.size(), 0);
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    auto const p = cell_structure.get_local_particle(ids[i]);
+    found[i] = (p and not p->is_ghost()) ? 1 : 0;
+  }
+  std::vector<int> found_anywhere(found.size());
+  boost::mpi::all_reduce(comm, found.data(), static_cast<int>(found.size()),
+                         found_anywhere.data(), std::plus<int>());
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    if (not found_anywhere[i]) {
+      throw std::runtime_error("Particle with id " + std::to_string(ids[i]) +
+                               " not found");
+    }
+  }
 }
+} // namespace
 
 std::vector<double>
-RDF::evaluate(Utils::Span<const Particle *const> particles1,
-              Utils::Span<const Particle *const> particles2) const {
+RDF::operator()(boost::mpi::communicator const &comm) const {
+  check_particles_exist(comm, ids1());
+  check_particles_exist(comm, ids2());
+
+  auto const self_rdf = ids2().empty();
+  auto max_id = -1;
+  for (auto const ids : {&ids1(), &ids2()}) {
+    if (not ids->empty()) {
+      max_id = std::max(max_id, *std::max_element(ids->begin(), ids->end()));
+    }
+  }
+  auto const size = static_cast<std::size_t>(max_id + 1);
+  auto const m1 = multiplicities(ids1(), size);
+  auto const m2 = multiplicities(ids2(), size);
+
   auto const bin_width = (max_r - min_r) / static_cast<double>(n_r_bins);
   auto const inv_bin_width = 1.0 / bin_width;
-  std::vector<double> res(n_values(), 0.0);
-  long int cnt = 0;
-  auto op = [=, &cnt, &res](const Particle *const p1,
-                            const Particle *const p2) {
-    auto const dist = box_geo.get_mi_vector(p1->pos(), p2->pos()).norm();
-    if (dist > min_r && dist < max_r) {
+  std::vector<double> local(n_values(), 0.0);
+  auto const select = [&](Particle const &p) {
+    auto const id = static_cast<std::size_t>(p.id());
+    return id < size and (m1[id] or m2[id]);
+  };
+  /* every pair of distinct particles is visited once, and counts as often
+   * as it appears in the pairs of the id lists */
+  auto const kernel = [&](Analysis::PairParticle const &p1,
+                          Analysis::PairParticle const &p2, double dist2) {
+    auto const a = static_cast<std::size_t>(p1.id);
+    auto const b = static_cast<std::size_t>(p2.id);
+    auto const weight =
+        self_rdf ? m1[a] * m1[b] : m1[a] * m2[b] + m1[b] * m2[a];
+    auto const dist = std::sqrt(dist2);
+    if (weight != 0 and dist > min_r and dist < max_r) {
       auto const ind =
-          static_cast<int>(std::floor((dist - min_r) * inv_bin_width));
-      res[ind]++;
+          static_cast<std::size_t>(std::floor((dist - min_r) * inv_bin_width));
+      local[std::min(ind, n_r_bins - 1)] += weight;
     }
-    cnt++;
   };
-  if (particles2.empty()) {
-    Utils::for_each_pair(particles1, op);
-  } else {
-    auto cmp = std::not_equal_to<const Particle *const>();
-    Utils::for_each_cartesian_pair_if(particles1, particles2, op, cmp);
+  Analysis::analysis_pair_loop(comm, max_r, select, kernel);
+
+  auto const n_values = static_cast<int>(local.size());
+  if (comm.rank() != 0) {
+    boost::mpi::reduce(comm, local.data(), n_values, std::plus<double>(), 0);
+    return {};
   }
-  if (cnt == 0)
+  std::vector<double> res(local.size());
+  boost::mpi::reduce(comm, local.data(), n_values, res.data(),
+                     std::plus<double>(), 0);
+
+  auto const n1 = static_cast<double>(ids1().size());
+  auto const n2 = static_cast<double>(ids2().size());
+  auto const cnt = self_rdf ? n1 * (n1 - 1.) / 2. : n1 * n2;
+  if (cnt == 0.)
     return res;
   // normalization
   auto const volume = box_geo.volume();
-  for (int i = 0; i < n_r_bins; ++i) {
-    auto const r_in = i * bin_width + min_r;
+  for (std::size_t i = 0; i < n_r_bins; ++i) {
+    auto const r_in = static_cast<double>(i) * bin_width + min_r;
     auto const r_out = r_in + bin_width;
     auto const bin_volume =
         (4.0 / 3.0) * Utils::pi() *
         (Utils::int_pow<3>(r_out) - Utils::int_pow<3>(r_in));
-    res[i] *= volume / (bin_volume * static_cast<double>(cnt));
+    res[i] *= volume / (bin_volume * cnt);
   }
 
   return res;
@@ -21,9 +21,8 @@
 #define OBSERVABLES_RDF_HPP
 
 #include "Observable.hpp"
-#include "Particle.hpp"
 
-#include <utils/Span.hpp>
+#include <boost/mpi/communicator.hpp>
 
 #include <cstddef>
 #include <stdexcept>
@@ -33,6 +32,10 @@
 namespace Observables {
 
 /** Radial distribution function.
+ *
+ *  The pairs are histogrammed by each rank on the particles it owns, with
+ *  the pair search of @ref Analysis::analysis_pair_loop, and the histograms
+ *  are summed on the head node.
  */
 class RDF : public Observable {
   /** Identifiers of the reference particles */
@@ -40,10 +43,6 @@ class RDF : public Observable {
   /** Identifiers of the distant particles */
   std::vector<int> m_ids2;
 
-  virtual std::vector<double>
-  evaluate(Utils::Span<const Particle *const> particles1,
-           Utils::Span<const Particle *const> particles2) const;
-
 public:
   // Range of the profile.
   double min_r, max_r;
@@ -61,7 +60,8 @@ public:
     if (n_r_bins <= 0)
       throw std::domain_error("n_r_bins has to be >= 1");
   }
-  std::vector<double> operator()() const final;
+  std::vector<double>
+  operator()(boost::mpi::communicator const &comm) const final;
 
   std::vector<int> &ids1() { return m_ids1; }
   std::vector<int> &ids2() { return m_ids2; }
@@ -21,6 +21,11 @@
 
 #include "PidObservable.hpp"
 
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/communicator.hpp>
+
 #include <cstddef>
 #include <vector>
 
@@ -31,15 +36,17 @@ public:
   std::vector<std::size_t> shape() const override { return {3}; }
 
   std::vector<double>
-  evaluate(ParticleReferenceRange particles,
+  evaluate(boost::mpi::communicator const &comm,
+           ParticleReferenceRange local_particles,
+           Utils::Span<const std::size_t>,
            const ParticleObservables::traits<Particle> &) const override {
     Utils::Vector3d res{};
-    for (auto const &p : particles) {
+    for (auto const &p : local_particles) {
       if (p.get().is_virtual())
         continue;
       res += p.get().force();
     }
-    return res.as_vector();
+    return detail::reduce_sum(comm, res.as_vector());
   }
 };
 } // Namespace Observables
@@ -31,6 +31,8 @@
 
 #include "p3m/fft.hpp"
 
+#include "threads.hpp"
+
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
@@ -42,9 +44,11 @@
 #include <fftw3.h>
 #include <mpi.h>
 
+#include <algorithm>
 #include <cmath>
-#include <cstdio>
+#include <cstddef>
 #include <cstring>
+#include <numeric>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -52,14 +56,6 @@
 using Utils::get_linear_index;
 using Utils::permute_ifield;
 
-/** @name MPI tags for FFT communication */
-/**@{*/
-/** Tag for communication in forw_grid_comm() */
-#define REQ_FFT_FORW 301
-/** Tag for communication in back_grid_comm() */
-#define REQ_FFT_BACK 302
-/**@}*/
-
 namespace {
 /** This ugly function does the bookkeeping: which nodes have to
  *  communicate to each other, when you change the node grid.
@@ -351,67 +347,199 @@ void pack_block_permute2(double const *const in, double *const out,
   }
 }
 
+/** Redistribute meshes between two node grids.
+ *  The blocks of all meshes for a node are sent in one message and the
+ *  messages of the group are exchanged with one non-blocking all-to-all
+ *  communication. The block which stays on this node is copied while the
+ *  messages are in flight.
+ *  \param pack        packing function for the send blocks.
+ *  \param group       nodes of the communication group.
+ *  \param send_block  send block specifications.
+ *  \param send_size   send block sizes.
+ *  \param send_dim    size of the input meshes.
+ *  \param recv_block  recv block specifications.
+ *  \param recv_size   recv block sizes.
+ *  \param recv_dim    size of the output meshes.
+ *  \param element     size of a mesh element.
+ *  \param in          input meshes.
+ *  \param out         output meshes.
+ *  \param fft         FFT communication plan.
+ *  \param comm        MPI communicator.
+ */
+void grid_comm(void (*pack)(double const *const, double *const, int const *,
+                            int const *, int const *, int),
+               std::vector<int> const &group,
+               std::vector<int> const &send_block,
+               std::vector<int> const &send_size, int const *send_dim,
+               std::vector<int> const &recv_block,
+               std::vector<int> const &recv_size, int const *recv_dim,
+               int element, Utils::Span<double *> in, Utils::Span<double *> out,
+               fft_data_struct &fft, const boost::mpi::communicator &comm) {
+  auto const n_fields = static_cast<int>(in.size());
+  auto const buf_size = in.size() * static_cast<std::size_t>(fft.max_comm_size);
+  if (fft.send_buf.size() < buf_size) {
+    fft.send_buf.resize(buf_size);
+    fft.recv_buf.resize(buf_size);
+  }
+
+  auto const n_nodes = static_cast<std::size_t>(comm.size());
+  std::vector<int> send_counts(n_nodes, 0), send_displs(n_nodes, 0);
+  std::vector<int> recv_counts(n_nodes, 0), recv_displs(n_nodes, 0);
+
+  /* pack the blocks of all meshes, those for the same node are adjacent */
+  int self = -1;
+  int self_offset = 0;
+  int send_offset = 0;
+  int recv_offset = 0;
+  for (int i = 0; i < group.size(); i++) {
+    for (int f = 0; f < n_fields; f++) {
+      pack(in[f], fft.send_buf.data() + send_offset + f * send_size[i],
+           &(send_block[6 * i]), &(send_block[6 * i + 3]), send_dim, element);
+    }
+    if (group[i] == comm.rank()) {
+      self = i;
+      self_offset = send_offset;
+    } else {
+      send_counts[group[i]] = n_fields * send_size[i];
+      send_displs[group[i]] = send_offset;
+      recv_counts[group[i]] = n_fields * recv_size[i];
+      recv_displs[group[i]] = recv_offset;
+    }
+    send_offset += n_fields * send_size[i];
+    recv_offset += n_fields * recv_size[i];
+  }
+
+  MPI_Request request;
+  MPI_Ialltoallv(fft.send_buf.data(), send_counts.data(), send_displs.data(),
+                 MPI_DOUBLE, fft.recv_buf.data(), recv_counts.data(),
+                 recv_displs.data(), MPI_DOUBLE, comm, &request);
+
+  /* Self communication... */
+  if (self != -1) {
+    for (int f = 0; f < n_fields; f++) {
+      fft_unpack_block(fft.send_buf.data() + self_offset + f * send_size[self],
+                       out[f], &(recv_block[6 * self]),
+                       &(recv_block[6 * self + 3]), recv_dim, element);
+    }
+  }
+
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+  for (int i = 0; i < group.size(); i++) {
+    if (i == self)
+      continue;
+    for (int f = 0; f < n_fields; f++) {
+      fft_unpack_block(fft.recv_buf.data() + recv_displs[group[i]] +
+                           f * recv_size[i],
+                       out[f], &(recv_block[6 * i]), &(recv_block[6 * i + 3]),
+                       recv_dim, element);
+    }
+  }
+}
+
 /** Communicate the grid data according to the given forward FFT plan.
  *  \param plan   FFT communication plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
+ *  \param in     input meshes.
+ *  \param out    output meshes.
  *  \param fft    FFT communication plan.
  *  \param comm   MPI communicator.
  */
-void forw_grid_comm(fft_forw_plan plan, const double *in, double *out,
-                    fft_data_struct &fft,
+void forw_grid_comm(fft_forw_plan const &plan, Utils::Span<double *> in,
+                    Utils::Span<double *> out, fft_data_struct &fft,
                     const boost::mpi::communicator &comm) {
-  for (int i = 0; i < plan.group.size(); i++) {
-    plan.pack_function(in, fft.send_buf.data(), &(plan.send_block[6 * i]),
-                       &(plan.send_block[6 * i + 3]), plan.old_mesh,
-                       plan.element);
-
-    if (plan.group[i] != comm.rank()) {
-      MPI_Sendrecv(fft.send_buf.data(), plan.send_size[i], MPI_DOUBLE,
-                   plan.group[i], REQ_FFT_FORW, fft.recv_buf.data(),
-                   plan.recv_size[i], MPI_DOUBLE, plan.group[i], REQ_FFT_FORW,
-                   comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
-    }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan.recv_block[6 * i]),
-                     &(plan.recv_block[6 * i + 3]), plan.new_mesh,
-                     plan.element);
-  }
+  grid_comm(plan.pack_function, plan.group, plan.send_block, plan.send_size,
+            plan.old_mesh, plan.recv_block, plan.recv_size, plan.new_mesh,
+            plan.element, in, out, fft, comm);
 }
 
 /** Communicate the grid data according to the given backward FFT plan.
  *  \param plan_f Forward FFT plan.
  *  \param plan_b Backward FFT plan.
- *  \param in     input mesh.
- *  \param out    output mesh.
+ *  \param in     input meshes.
+ *  \param out    output meshes.
  *  \param fft    FFT communication plan.
  *  \param comm   MPI communicator.
  */
-void back_grid_comm(fft_forw_plan plan_f, fft_back_plan plan_b,
-                    const double *in, double *out, fft_data_struct &fft,
+void back_grid_comm(fft_forw_plan const &plan_f, fft_back_plan const &plan_b,
+                    Utils::Span<double *> in, Utils::Span<double *> out,
+                    fft_data_struct &fft,
                     const boost::mpi::communicator &comm) {
   /* Back means: Use the send/receive stuff from the forward plan but
      replace the receive blocks by the send blocks and vice
      versa. Attention then also new_mesh and old_mesh are exchanged */
+  grid_comm(plan_b.pack_function, plan_f.group, plan_f.recv_block,
+            plan_f.recv_size, plan_f.new_mesh, plan_f.send_block,
+            plan_f.send_size, plan_f.old_mesh, plan_f.element, in, out, fft,
+            comm);
+}
 
-  for (int i = 0; i < plan_f.group.size(); i++) {
-    plan_b.pack_function(in, fft.send_buf.data(), &(plan_f.recv_block[6 * i]),
-                         &(plan_f.recv_block[6 * i + 3]), plan_f.new_mesh,
-                         plan_f.element);
-
-    if (plan_f.group[i] != comm.rank()) { /* send first, receive second */
-      MPI_Sendrecv(fft.send_buf.data(), plan_f.recv_size[i], MPI_DOUBLE,
-                   plan_f.group[i], REQ_FFT_BACK, fft.recv_buf.data(),
-                   plan_f.send_size[i], MPI_DOUBLE, plan_f.group[i],
-                   REQ_FFT_BACK, comm, MPI_STATUS_IGNORE);
-    } else { /* Self communication... */
-      std::swap(fft.send_buf, fft.recv_buf);
-    }
-    fft_unpack_block(fft.recv_buf.data(), out, &(plan_f.send_block[6 * i]),
-                     &(plan_f.send_block[6 * i + 3]), plan_f.old_mesh,
-                     plan_f.element);
+/** Offset between the meshes of a batched transform in @c fft.data_buf.
+ *  Rounded up to keep the alignment the FFTW plans were created with.
+ */
+std::size_t data_buf_stride(fft_data_struct const &fft) {
+  return (static_cast<std::size_t>(fft.max_mesh_size) + 7u) / 8u * 8u;
+}
+
+/** Create the FFTW plans for the three directions. With threaded FFTW,
+ *  the plans use as many threads as the particle loops.
+ *  \warning The content of @c fft.data_buf is overwritten.
+ */
+void create_plans(fft_data_struct &fft) {
+  auto *r_data = fft.data_buf.data();
+  auto *c_data = (fftw_complex *)(fft.data_buf.data());
+  /* the real-to-complex transforms are planned out of place */
+  fft_vector<double> out(data_buf_stride(fft));
+  auto *c_out = (fftw_complex *)(out.data());
+#ifdef FFTW_THREADS
+  static auto const threads_initialized = fftw_init_threads();
+  if (threads_initialized) {
+    fftw_plan_with_nthreads(get_n_threads());
   }
+#endif
+  fft.n_threads = get_n_threads();
+
+  auto const n = fft.plan[1].new_mesh[2];
+  auto const n_ks = n / 2 + 1;
+  if (fft.init_tag) {
+    fftw_destroy_plan(fft.plan[1].our_fftw_plan);
+    fftw_destroy_plan(fft.back[1].our_fftw_plan);
+  }
+  fft.plan[1].our_fftw_plan =
+      fftw_plan_many_dft_r2c(1, &n, fft.plan[1].n_ffts, r_data, nullptr, 1, n,
+                             c_out, nullptr, 1, n_ks, FFTW_PATIENT);
+  fft.back[1].our_fftw_plan =
+      fftw_plan_many_dft_c2r(1, &n, fft.plan[1].n_ffts, c_out, nullptr, 1,
+                             n_ks, r_data, nullptr, 1, n, FFTW_PATIENT);
+
+  for (int i = 2; i < 4; i++) {
+    /* FFT plan creation.*/
+    if (fft.init_tag)
+      fftw_destroy_plan(fft.plan[i].our_fftw_plan);
+    fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
+        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+        fft.plan[i].dir, FFTW_PATIENT);
+
+    if (fft.init_tag)
+      fftw_destroy_plan(fft.back[i].our_fftw_plan);
+    fft.back[i].our_fftw_plan = fftw_plan_many_dft(
+        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+        fft.back[i].dir, FFTW_PATIENT);
+  }
+
+  fft.init_tag = true;
+}
+
+/** Re-plan if the number of threads changed since the plans were made.
+ *  The plans are kept for the lifetime of the FFT otherwise.
+ */
+void update_plans(fft_data_struct &fft) {
+#ifdef FFTW_THREADS
+  if (fft.n_threads != get_n_threads()) {
+    create_plans(fft);
+  }
+#endif
 }
 
 /** Calculate 'best' mapping between a 2D and 3D grid.
@@ -529,12 +657,20 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
   fft.plan[2].row_dir = (fft.plan[1].row_dir - 1) % 3;
   fft.plan[3].row_dir = (fft.plan[1].row_dir - 2) % 3;
 
+  /* The first FFT is real-to-complex and only keeps the non-negative
+     frequencies of its row direction, the other FFTs work on this half
+     spectrum. */
+  auto ks_mesh_dim = global_mesh_dim;
+  ks_mesh_dim[fft.plan[1].row_dir] /= 2;
+  ks_mesh_dim[fft.plan[1].row_dir] += 1;
+
   /* === communication groups === */
   /* copy local mesh off real space charge assignment grid */
   for (int i = 0; i < 3; i++)
     fft.plan[0].new_mesh[i] = ca_mesh_dim[i];
 
   for (int i = 1; i < 4; i++) {
+    auto const &mesh_dim = (i == 1) ? global_mesh_dim : ks_mesh_dim;
     using Utils::make_span;
     auto group = find_comm_groups(
         {n_grid[i - 1][0], n_grid[i - 1][1], n_grid[i - 1][2]},
@@ -563,7 +699,7 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     fft.plan[i].recv_size.resize(fft.plan[i].group.size());
 
     fft.plan[i].new_size = calc_local_mesh(
-        my_pos[i], n_grid[i], global_mesh_dim.data(), global_mesh_off.data(),
+        my_pos[i], n_grid[i], mesh_dim.data(), global_mesh_off.data(),
         fft.plan[i].new_mesh, fft.plan[i].start);
     permute_ifield(fft.plan[i].new_mesh, 3, -(fft.plan[i].n_permute));
     permute_ifield(fft.plan[i].start, 3, -(fft.plan[i].n_permute));
@@ -575,14 +711,12 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
       int node = fft.plan[i].group[j];
       fft.plan[i].send_size[j] = calc_send_block(
           my_pos[i - 1], n_grid[i - 1], &(n_pos[i][3 * node]), n_grid[i],
-          global_mesh_dim.data(), global_mesh_off.data(),
+          mesh_dim.data(), global_mesh_off.data(),
           &(fft.plan[i].send_block[6 * j]));
       permute_ifield(&(fft.plan[i].send_block[6 * j]), 3,
                      -(fft.plan[i - 1].n_permute));
       permute_ifield(&(fft.plan[i].send_block[6 * j + 3]), 3,
                      -(fft.plan[i - 1].n_permute));
-      if (fft.plan[i].send_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].send_size[j];
       /* First plan send blocks have to be adjusted, since the CA grid
          may have an additional margin outside the actual domain of the
          node */
@@ -593,18 +727,19 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
       /* recv block: comm.rank() from comm-group-node i (identity: node) */
       fft.plan[i].recv_size[j] = calc_send_block(
           my_pos[i], n_grid[i], &(n_pos[i - 1][3 * node]), n_grid[i - 1],
-          global_mesh_dim.data(), global_mesh_off.data(),
+          mesh_dim.data(), global_mesh_off.data(),
           &(fft.plan[i].recv_block[6 * j]));
       permute_ifield(&(fft.plan[i].recv_block[6 * j]), 3,
                      -(fft.plan[i].n_permute));
       permute_ifield(&(fft.plan[i].recv_block[6 * j + 3]), 3,
                      -(fft.plan[i].n_permute));
-      if (fft.plan[i].recv_size[j] > fft.max_comm_size)
-        fft.max_comm_size = fft.plan[i].recv_size[j];
     }
 
     for (int j = 0; j < 3; j++)
       fft.plan[i].old_mesh[j] = fft.plan[i - 1].new_mesh[j];
+    /* rows of the first FFT hold the half spectrum after the transform */
+    if (i == 2)
+      fft.plan[i].old_mesh[2] = fft.plan[1].new_mesh[2] / 2 + 1;
     if (i == 1) {
       fft.plan[i].element = 1;
     } else {
@@ -614,12 +749,18 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
         fft.plan[i].recv_size[j] *= 2;
       }
     }
+    /* all blocks of a redistribution are in flight at the same time */
+    auto const send_total = std::accumulate(fft.plan[i].send_size.begin(),
+                                            fft.plan[i].send_size.end(), 0);
+    auto const recv_total = std::accumulate(fft.plan[i].recv_size.begin(),
+                                            fft.plan[i].recv_size.end(), 0);
+    fft.max_comm_size = std::max({fft.max_comm_size, send_total, recv_total});
   }
 
-  /* Factor 2 for complex fields */
-  fft.max_comm_size *= 2;
-  fft.max_mesh_size = Utils::product(ca_mesh_dim);
-  for (int i = 1; i < 4; i++)
+  fft.max_mesh_size = std::max(
+      Utils::product(ca_mesh_dim),
+      2 * fft.plan[1].n_ffts * (fft.plan[1].new_mesh[2] / 2 + 1));
+  for (int i = 2; i < 4; i++)
     if (2 * fft.plan[i].new_size > fft.max_mesh_size)
       fft.max_mesh_size = 2 * fft.plan[i].new_size;
 
@@ -635,37 +776,20 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     fft.plan[1].pack_function = pack_block_permute1;
     ks_pnum = 5;
   }
+  /* k-space direction d is the real space direction (d + ks_pnum) % 3 */
+  fft.ks_half_dim = (fft.plan[1].row_dir - ks_pnum % 3 + 3) % 3;
+  fft.ks_half_mesh = global_mesh_dim[fft.plan[1].row_dir];
 
   fft.send_buf.resize(fft.max_comm_size);
   fft.recv_buf.resize(fft.max_comm_size);
-  fft.data_buf.resize(fft.max_mesh_size);
-  auto *c_data = (fftw_complex *)(fft.data_buf.data());
+  fft.data_buf.resize(data_buf_stride(fft));
 
   /* === FFT Routines (Using FFTW / RFFTW package)=== */
   for (int i = 1; i < 4; i++) {
     fft.plan[i].dir = FFTW_FORWARD;
-    /* FFT plan creation.*/
-
-    if (fft.init_tag)
-      fftw_destroy_plan(fft.plan[i].our_fftw_plan);
-    fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.plan[i].dir, FFTW_PATIENT);
-  }
-
-  /* === The BACK Direction === */
-  /* this is needed because slightly different functions are used */
-  for (int i = 1; i < 4; i++) {
+    /* === The BACK Direction === */
+    /* this is needed because slightly different functions are used */
     fft.back[i].dir = FFTW_BACKWARD;
-
-    if (fft.init_tag)
-      fftw_destroy_plan(fft.back[i].our_fftw_plan);
-    fft.back[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.back[i].dir, FFTW_PATIENT);
-
     fft.back[i].pack_function = pack_block_permute1;
   }
   if (fft.plan[1].row_dir == 2) {
@@ -674,84 +798,92 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     fft.back[1].pack_function = pack_block_permute2;
   }
 
-  fft.init_tag = true;
+  create_plans(fft);
 
   return fft.max_mesh_size;
 }
 
 void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm) {
+  update_plans(fft);
+
   /* ===== first direction  ===== */
 
+  auto *data_buf = fft.data_buf.data();
   auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
+  auto *c_data_buf = (fftw_complex *)data_buf;
+  auto const data_span = Utils::make_span(&data, 1);
+  auto const data_buf_span = Utils::make_span(&data_buf, 1);
 
   /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[1], data, fft.data_buf.data(), fft, comm);
-
-  /* complexify the real data array (in is fft.data_buf) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    data[2 * i + 0] = fft.data_buf[i]; /* real value */
-    data[2 * i + 1] = 0;               /* complex value */
-  }
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[1].our_fftw_plan, c_data, c_data);
+  forw_grid_comm(fft.plan[1], data_span, data_buf_span, fft, comm);
+  /* perform real-to-complex FFT (in is fft.data_buf, out is data) */
+  fftw_execute_dft_r2c(fft.plan[1].our_fftw_plan, data_buf, c_data);
   /* ===== second direction ===== */
   /* communication to current dir row format (in is data) */
-  forw_grid_comm(fft.plan[2], data, fft.data_buf.data(), fft, comm);
+  forw_grid_comm(fft.plan[2], data_span, data_buf_span, fft, comm);
   /* perform FFT (in/out is fft.data_buf) */
   fftw_execute_dft(fft.plan[2].our_fftw_plan, c_data_buf, c_data_buf);
   /* ===== third direction  ===== */
   /* communication to current dir row format (in is fft.data_buf) */
-  forw_grid_comm(fft.plan[3], fft.data_buf.data(), data, fft, comm);
+  forw_grid_comm(fft.plan[3], data_buf_span, data_span, fft, comm);
   /* perform FFT (in/out is data)*/
   fftw_execute_dft(fft.plan[3].our_fftw_plan, c_data, c_data);
 
   /* REMARK: Result has to be in data. */
 }
 
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
+void fft_perform_back(Utils::Span<double *> data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm) {
+  /* each mesh gets its own section of fft.data_buf */
+  auto const stride = data_buf_stride(fft);
+  if (fft.data_buf.size() < data.size() * stride) {
+    fft.data_buf.resize(data.size() * stride);
+  }
+  update_plans(fft);
 
-  auto *c_data = (fftw_complex *)data;
-  auto *c_data_buf = (fftw_complex *)fft.data_buf.data();
+  std::vector<double *> data_buf(data.size());
+  for (std::size_t f = 0; f < data.size(); f++) {
+    data_buf[f] = fft.data_buf.data() + f * stride;
+  }
+  auto const data_buf_span = Utils::make_span(data_buf);
 
   /* ===== third direction  ===== */
 
   /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[3].our_fftw_plan, c_data, c_data);
+  for (auto *mesh : data) {
+    auto *c_mesh = (fftw_complex *)mesh;
+    fftw_execute_dft(fft.back[3].our_fftw_plan, c_mesh, c_mesh);
+  }
   /* communicate (in is data)*/
-  back_grid_comm(fft.plan[3], fft.back[3], data, fft.data_buf.data(), fft,
-                 comm);
+  back_grid_comm(fft.plan[3], fft.back[3], data, data_buf_span, fft, comm);
 
   /* ===== second direction ===== */
   /* perform FFT (in is fft.data_buf) */
-  fftw_execute_dft(fft.back[2].our_fftw_plan, c_data_buf, c_data_buf);
+  for (auto *mesh : data_buf) {
+    auto *c_mesh = (fftw_complex *)mesh;
+    fftw_execute_dft(fft.back[2].our_fftw_plan, c_mesh, c_mesh);
+  }
   /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[2], fft.back[2], fft.data_buf.data(), data, fft,
-                 comm);
+  back_grid_comm(fft.plan[2], fft.back[2], data_buf_span, data, fft, comm);
 
   /* ===== first direction  ===== */
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[1].our_fftw_plan, c_data, c_data);
-  /* throw away the (hopefully) empty complex component (in is data) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    fft.data_buf[i] = data[2 * i]; /* real value */
-    // Vincent:
-    if (check_complex and std::abs(data[2 * i + 1]) > 1e-5) {
-      printf("Complex value is not zero (i=%d,data=%g)!!!\n", i,
-             data[2 * i + 1]);
-      if (i > 100)
-        throw std::runtime_error("Complex value is not zero");
-    }
+  /* perform complex-to-real FFT (in is data, out is fft.data_buf) */
+  for (std::size_t f = 0; f < data.size(); f++) {
+    fftw_execute_dft_c2r(fft.back[1].our_fftw_plan, (fftw_complex *)data[f],
+                         data_buf[f]);
   }
   /* communicate (in is fft.data_buf) */
-  back_grid_comm(fft.plan[1], fft.back[1], fft.data_buf.data(), data, fft,
-                 comm);
+  back_grid_comm(fft.plan[1], fft.back[1], data_buf_span, data, fft, comm);
 
   /* REMARK: Result has to be in data. */
 }
 
+void fft_perform_back(double *data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm) {
+  fft_perform_back(Utils::make_span(&data, 1), fft, comm);
+}
+
 void fft_pack_block(double const *const in, double *const out,
                     int const start[3], int const size[3], int const dim[3],
                     int element) {
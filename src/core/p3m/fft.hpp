@@ -31,9 +31,10 @@
  *  1D-FFT. After performing the FFT on that direction the data is
  *  redistributed.
  *
- *  For simplicity at the moment I have implemented a full complex to
- *  complex FFT (even though a real to complex FFT would be
- *  sufficient)
+ *  The first 1D-FFT is a real to complex FFT, which only keeps the
+ *  non-negative frequencies of its row direction. The other two
+ *  1D-FFTs and the k-space mesh work on this half spectrum, see
+ *  \ref fft_ks_multiplicity for sums over the full spectrum.
  *
  *  \todo Combine the forward and backward structures.
  *  \todo The packing routines could be moved to utils.hpp when they are needed
@@ -46,6 +47,7 @@
 
 #if defined(P3M) || defined(DP3M)
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <boost/mpi/communicator.hpp>
@@ -158,12 +160,20 @@ struct fft_data_struct { // NOLINT(bugprone-reserved-identifier)
   /** Whether FFT is initialized or not. */
   bool init_tag = false;
 
-  /** Maximal size of the communication buffers. */
+  /** Number of threads the FFTW plans were created for. */
+  int n_threads = 1;
+
+  /** Maximal size of the communication buffers for a single mesh. */
   int max_comm_size = 0;
 
   /** Maximal local mesh size. */
   int max_mesh_size = 0;
 
+  /** k-space mesh direction of the half spectrum. */
+  int ks_half_dim = 0;
+  /** Global mesh size of the half spectrum direction in real space. */
+  int ks_half_mesh = 0;
+
   /** send buffer. */
   std::vector<double> send_buf;
   /** receive buffer. */
@@ -200,16 +210,36 @@ void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
 /** Perform an in-place backward 3D FFT.
+ *  The k-space mesh has to be Hermitian, the result is real.
  *  \warning The content of \a data is overwritten.
- *  \param[in,out] data           Mesh.
- *  \param[in]     check_complex  Throw an error if the complex component is
- *                                non-zero.
- *  \param[in,out] fft            FFT plan.
- *  \param[in]     comm           MPI communicator.
+ *  \param[in,out] data  Mesh.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator.
+ */
+void fft_perform_back(double *data, fft_data_struct &fft,
+                      const boost::mpi::communicator &comm);
+
+/** Perform in-place backward 3D FFTs of several meshes at once.
+ *  The meshes share the redistribution messages between the 1D FFTs.
+ *  \warning The contents of \a data are overwritten.
+ *  \param[in,out] data  Meshes.
+ *  \param[in,out] fft   FFT plan.
+ *  \param[in]     comm  MPI communicator.
  */
-void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
+void fft_perform_back(Utils::Span<double *> data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
+/** Number of modes of the full spectrum that a k-space mesh point stands
+ *  for. The zero and Nyquist frequencies of the half spectrum direction
+ *  are their own complex conjugates, all other points also represent
+ *  their conjugate partner.
+ *  \param[in] fft  FFT plan.
+ *  \param[in] n    Global k-space index in the half spectrum direction.
+ */
+inline int fft_ks_multiplicity(fft_data_struct const &fft, int n) {
+  return (n == 0 or 2 * n == fft.ks_half_mesh) ? 1 : 2;
+}
+
 /** Pack a block (<tt>size[3]</tt> starting at <tt>start[3]</tt>) of an input
  *  3d-grid with dimension <tt>dim[3]</tt> into an output 3d-block with
  *  dimension <tt>size[3]</tt>.
@@ -136,16 +136,16 @@ std::vector<double> grid_influence_function(P3MParameters const &params,
       for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
         auto const ind = Utils::get_linear_index(n - n_start, size,
                                                  Utils::MemoryOrder::ROW_MAJOR);
+        auto const d_op =
+            Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
 
-        if (((n[0] % (params.mesh[0] / 2) == 0) &&
-             (n[1] % (params.mesh[0] / 2) == 0) &&
-             (n[2] % (params.mesh[0] / 2) == 0))) {
+        /* the differential operator vanishes at k = 0 and at the Nyquist
+           frequencies; with an odd mesh, n = mesh - 1 is not one of them */
+        if (d_op.norm2() == 0) {
           g[ind] = 0.0;
         } else {
           auto const shift = Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]],
                                              shifts[0][n[2]]};
-          auto const d_op =
-              Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
           auto const fak2 = G_opt_dipolar<S>(params, shift, d_op);
           g[ind] = fak1 * fak2;
         }
@@ -188,11 +188,16 @@ inline double G_opt_dipolar_self_energy(P3MParameters const &params,
  * @param n_start Lower left corner of the grid
  * @param n_end Upper right corner of the grid.
  * @param g Energies on the grid.
+ * @param multiplicity Number of modes of the full spectrum which a grid
+ *        point stands for.
  * @return Total self-energy.
  */
-inline double grid_influence_function_self_energy(
-    P3MParameters const &params, Utils::Vector3i const &n_start,
-    Utils::Vector3i const &n_end, std::vector<double> const &g) {
+template <typename Multiplicity>
+double grid_influence_function_self_energy(P3MParameters const &params,
+                                           Utils::Vector3i const &n_start,
+                                           Utils::Vector3i const &n_end,
+                                           std::vector<double> const &g,
+                                           Multiplicity multiplicity) {
   auto const size = n_end - n_start;
 
   auto const shifts = detail::calc_meshift(params.mesh, false);
@@ -203,19 +208,15 @@ inline double grid_influence_function_self_energy(
   for (n[0] = n_start[0]; n[0] < n_end[0]; n[0]++) {
     for (n[1] = n_start[1]; n[1] < n_end[1]; n[1]++) {
       for (n[2] = n_start[2]; n[2] < n_end[2]; n[2]++) {
-        if (((n[0] % (params.mesh[0] / 2) == 0) &&
-             (n[1] % (params.mesh[0] / 2) == 0) &&
-             (n[2] % (params.mesh[0] / 2) == 0))) {
-          energy += 0.0;
-        } else {
+        auto const d_op =
+            Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
+        if (d_op.norm2() != 0) {
           auto const ind = Utils::get_linear_index(
               n - n_start, size, Utils::MemoryOrder::ROW_MAJOR);
           auto const shift = Utils::Vector3i{shifts[0][n[0]], shifts[0][n[1]],
                                              shifts[0][n[2]]};
-          auto const d_op =
-              Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
           auto const U2 = G_opt_dipolar_self_energy(params, shift);
-          energy += g[ind] * U2 * d_op.norm2();
+          energy += multiplicity(n) * g[ind] * U2 * d_op.norm2();
         }
       }
     }
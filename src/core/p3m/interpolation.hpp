@@ -27,6 +27,7 @@
 
 #include <boost/range/algorithm/copy.hpp>
 
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <tuple>
@@ -177,6 +178,69 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
   return ret;
 }
 
+/**
+ * @brief Calculate the P-th order interpolation weights of several points.
+ *
+ * Same as the single-point version, but each step is carried out for all
+ * points of the batch before the next one, so that the loops over the
+ * points can be vectorized.
+ *
+ * @tparam cao Interpolation order.
+ * @tparam N Maximal number of points in a batch.
+ * @param positions Positions of the points, at most @p N.
+ * @param ai Inverse mesh spacing.
+ * @param local_mesh Mesh info.
+ * @param[out] weights Interpolation weights, one per position.
+ */
+template <int cao, std::size_t N>
+void p3m_calculate_interpolation_weights(
+    Utils::Span<const Utils::Vector3d> positions, const Utils::Vector3d &ai,
+    P3MLocalMesh const &local_mesh,
+    Utils::Span<InterpolationWeights<cao>> weights) {
+  /** position shift for calc. of first assignment mesh point. */
+  static auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
+
+  assert(positions.size() <= N);
+  assert(weights.size() == positions.size());
+  auto const n = positions.size();
+
+  /* nearest mesh point and distance to it, per direction */
+  std::array<std::array<int, N>, 3> nmp;
+  std::array<std::array<double, N>, 3> dist;
+  for (int d = 0; d < 3; d++) {
+    auto const ld_pos = local_mesh.ld_pos[d];
+    auto const ai_d = ai[d];
+    for (std::size_t j = 0; j < n; j++) {
+      auto const pos = ((positions[j][d] - ld_pos) * ai_d) - pos_shift;
+      nmp[d][j] = static_cast<int>(pos);
+      dist[d][j] = (pos - nmp[d][j]) - 0.5;
+    }
+  }
+
+  for (std::size_t j = 0; j < n; j++) {
+    Utils::Vector3i const ind{nmp[0][j], nmp[1][j], nmp[2][j]};
+    assert((ind + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
+    weights[j].ind = Utils::get_linear_index(ind, local_mesh.dim,
+                                             Utils::MemoryOrder::ROW_MAJOR);
+  }
+
+  std::array<double, N> w;
+  for (int i = 0; i < cao; i++) {
+    using Utils::bspline;
+
+    for (int d = 0; d < 3; d++) {
+      for (std::size_t j = 0; j < n; j++) {
+        w[j] = bspline<cao>(i, dist[d][j]);
+      }
+      for (std::size_t j = 0; j < n; j++) {
+        auto &w_d = (d == 0) ? weights[j].w_x
+                             : ((d == 1) ? weights[j].w_y : weights[j].w_z);
+        w_d[i] = w[j];
+      }
+    }
+  }
+}
+
 /**
  * @brief P3M grid interpolation.
  *
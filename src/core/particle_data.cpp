@@ -136,21 +136,8 @@ using UpdatePropertyMessage = boost::variant
 #ifdef EXTERNAL_FORCES
         , UpdateProperty<uint8_t, &Prop::ext_flag>
         , UpdateProperty<Utils::Vector3d, &Prop::ext_force>
-        , UpdateProperty<Utils::Vector3d, &Prop::visc_force>
-        , UpdateProperty<Utils::Matrix<double,20,3>, &Prop::visc_force_mat>
-        , UpdateProperty<Utils::Vector3d, &Prop::visc_gamma_vec>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::visc_gamma>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::taum>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::vcrit>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::aexp>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::bexp>
-        , UpdateProperty<int, &Prop::Nm>
 #ifdef ROTATION
         , UpdateProperty<Utils::Vector3d, &Prop::ext_torque>
-        , UpdateProperty<Utils::Vector3d, &Prop::visc_torque>
-        , UpdateProperty<Utils::Matrix<double,20,3>, &Prop::visc_torque_mat>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::omegacrit>
-        , UpdateProperty<Utils::Vector<double,20>, &Prop::visc_gamma_rot>
 #endif
 #endif
         >;
@@ -251,6 +238,21 @@ using UpdateBondMessage = boost::variant
         >;
 // clang-format on
 
+#ifdef EXTERNAL_FORCES
+/**
+ * @brief Set the extended variables of the Prony modes.
+ */
+struct UpdateGLEState {
+  std::vector<double> state;
+
+  void operator()(Particle &p) const { p.gle().set_state(state); }
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &state;
+  }
+};
+#endif // EXTERNAL_FORCES
+
 #ifdef ROTATION
 struct UpdateOrientation {
   Utils::Vector3d axis;
@@ -284,6 +286,9 @@ using UpdateMessage = boost::variant
         , UpdateMomentumMessage
         , UpdateForceMessage
         , UpdateBondMessage
+#ifdef EXTERNAL_FORCES
+        , UpdateGLEState
+#endif
 #ifdef ROTATION
         , UpdateOrientation
 #endif
@@ -613,36 +618,6 @@ void set_particle_ext_torque(int part, const Utils::Vector3d &torque) {
   mpi_update_particle_property<Utils::Vector3d,
                                &ParticleProperties::ext_torque>(part, torque);
 }
-
-// VISCOELASTIC TORQUE
-void set_particle_visc_torque(int part, const Utils::Vector3d &torque) {
-  mpi_update_particle_property<Utils::Vector3d, &ParticleProperties::visc_torque>(
-      part, torque);
-}
-
-// VISCOELASTIC TORQUE MATRIX
-void set_particle_visc_torque_mat(int part, const Utils::Matrix<double,20,3> &torque_mat) {
-  mpi_update_particle_property<Utils::Matrix<double,20,3>, &ParticleProperties::visc_torque_mat>(
-      part, torque_mat);
-}
-
-// VISCOELASTIC PARAMETER omegacrit
-void set_particle_omegacrit(int part, const std::vector<double> &omegacrit) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = omegacrit[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::omegacrit>(part, utilsVector);
-}
-
-// VISCOELASTIC PARAMETER visc_gamma_rot
-void set_particle_visc_gamma_rot(int part, const std::vector<double> &visc_gamma_rot) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = visc_gamma_rot[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::visc_gamma_rot>(part, utilsVector);
-}
 #endif // ROTATION
 
 void set_particle_ext_force(int part, const Utils::Vector3d &force) {
@@ -650,72 +625,8 @@ void set_particle_ext_force(int part, const Utils::Vector3d &force) {
       part, force);
 }
 
-// VISCOELASTIC FORCE
-void set_particle_visc_force(int part, const Utils::Vector3d &force) {
-  mpi_update_particle_property<Utils::Vector3d, &ParticleProperties::visc_force>(
-      part, force);
-}
-
-// VISCOELASTIC FORCE MATRIX
-void set_particle_visc_force_mat(int part, const Utils::Matrix<double,20,3> &force_mat) {
-  mpi_update_particle_property<Utils::Matrix<double,20,3>, &ParticleProperties::visc_force_mat>(
-      part, force_mat);
-}
-
-// VISCOELASTIC GAMMA
-void set_particle_visc_gamma_vec(int part, const Utils::Vector3d &visc_gamma_vec) {
-  mpi_update_particle_property<Utils::Vector3d, &ParticleProperties::visc_gamma_vec>(
-      part, visc_gamma_vec);
-}
-
-// VISCOELASTIC PARAMETER q
-void set_particle_visc_gamma(int part, const std::vector<double> &visc_gamma) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = visc_gamma[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::visc_gamma>(part, utilsVector);
-}
-
-// VISCOELASTIC PARAMETER taum
-void set_particle_taum(int part, const std::vector<double> &taum) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = taum[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::taum>(part, utilsVector);
-}
-
-// VISCOELASTIC PARAMETER vcrit
-void set_particle_vcrit(int part, const std::vector<double> &vcrit) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = vcrit[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::vcrit>(part, utilsVector);
-}
-
-// VISCOELASTIC PARAMETER aexp
-void set_particle_aexp(int part, const std::vector<double> &aexp) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = aexp[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::aexp>(part, utilsVector);
-}
-
-// VISCOELASTIC PARAMETER bexp
-void set_particle_bexp(int part, const std::vector<double> &bexp) {
-  Utils::Vector<double,20> utilsVector;
-  for (std::size_t i = 0; i < 20; ++i) {
-    utilsVector[i] = bexp[i];
-  }
-  mpi_update_particle_property<Utils::Vector<double,20>, &ParticleProperties::bexp>(part, utilsVector);
-}
-
-// NUMBER OF PRONY MODES
-void set_particle_Nm(int part, int Nm) {
-  mpi_update_particle_property<int, &ParticleProperties::Nm>(part, Nm);
+void set_particle_gle_state(int part, std::vector<double> const &state) {
+  mpi_send_update_message(part, UpdateGLEState{state});
 }
 
 void set_particle_fix(int part, Utils::Vector3i const &flag) {
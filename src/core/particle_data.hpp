@@ -210,50 +210,18 @@ void set_particle_gamma_rot(int part, Utils::Vector3d const &gamma_rot);
  *  @param torque new value for ext_torque.
  */
 void set_particle_ext_torque(int part, const Utils::Vector3d &torque);
-/** Call only on the head node: set particle viscoelastic torque.
- *  @param part  the particle.
- *  @param torque new value for visc_torque.
- */
-void set_particle_visc_torque(int part, const Utils::Vector3d &torque);
-/** Call only on the head node: set particle viscoelastic torque matrix.
- *  @param part  the particle.
- *  @param torque_mat new value for visc_torque_mat.
- */
-void set_particle_visc_torque_mat(int part, const Utils::Matrix<double,20,3> &torque_mat);
-
-void set_particle_omegacrit(int part, const std::vector<double> &omegacrit);
-
-void set_particle_visc_gamma_rot(int part, const std::vector<double> &visc_gamma_rot);
 #endif
 /** Call only on the head node: set particle external force.
  *  @param part  the particle.
  *  @param force new value for ext_force.
  */
 void set_particle_ext_force(int part, const Utils::Vector3d &force);
-/** Call only on the head node: set particle viscoelastic force.
- *  @param part  the particle.
- *  @param force new value for visc_force.
- */
-void set_particle_visc_force(int part, const Utils::Vector3d &force);
-/** Call only on the head node: set particle viscoelastic force matrix.
+/** Call only on the head node: set the extended variables of the
+ *  Prony modes of the generalized Langevin equation.
  *  @param part  the particle.
- *  @param force_mat new value for visc_force_mat.
+ *  @param state new values, component-major, see @ref ParticleGLE.
  */
-void set_particle_visc_force_mat(int part, const Utils::Matrix<double,20,3> &force_mat);
-
-void set_particle_visc_gamma_vec(int part, const Utils::Vector3d &visc_gamma_vec);
-
-void set_particle_visc_gamma(int part, const std::vector<double> &visc_gamma);
-
-void set_particle_taum(int part, const std::vector<double> &taum);
-
-void set_particle_vcrit(int part, const std::vector<double> &vcrit);
-
-void set_particle_aexp(int part, const std::vector<double> &aexp);
-
-void set_particle_bexp(int part, const std::vector<double> &bexp);
-
-void set_particle_Nm(int part, int Nm);
+void set_particle_gle_state(int part, std::vector<double> const &state);
 
 /** Call only on the head node: set coordinate axes for which the particles
  *  motion is fixed.
@@ -354,6 +322,9 @@ inline Utils::Vector3i get_particle_fix(Particle const *p) {
   return Utils::Vector3i{
       {p->is_fixed_along(0), p->is_fixed_along(1), p->is_fixed_along(2)}};
 }
+inline std::vector<double> get_particle_gle_state(Particle const *p) {
+  return p->gle().state();
+}
 #endif // EXTERNAL_FORCES
 
 #ifdef THERMOSTAT_PER_PARTICLE
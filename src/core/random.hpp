@@ -57,7 +57,9 @@ enum class RNGSalt : uint32_t {
   NPTISO0_HALF_STEP2,
   NPTISOV,
   SALT_DPD,
-  THERMALIZED_BOND
+  THERMALIZED_BOND,
+  GLE,
+  GLE_ROT
 };
 
 namespace Random {
@@ -134,7 +134,10 @@ static void apply_positional_correction(const ParticleRange &particles) {
 }
 
 void correct_position_shake(CellStructure &cs) {
-  cells_update_ghosts(Cells::DATA_PART_POSITION | Cells::DATA_PART_PROPERTIES);
+  /* the last positions of the ghosts are only needed after a resort,
+     otherwise they were saved at the beginning of the time step */
+  cells_update_ghosts(Cells::DATA_PART_POSITION | Cells::DATA_PART_PROPERTIES |
+                      Cells::DATA_PART_POS_LAST);
 
   auto particles = cs.local_particles();
   auto ghost_particles = cs.ghost_particles();
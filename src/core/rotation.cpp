@@ -35,6 +35,8 @@
 
 #ifdef ROTATION
 
+#include "threads.hpp"
+
 #include <utils/Vector.hpp>
 #include <utils/mask.hpp>
 
@@ -161,10 +163,10 @@ void propagate_omega_quat_particle(Particle &p, double time_step) {
 
 void convert_torques_propagate_omega(const ParticleRange &particles,
                                      double time_step) {
-  for (auto &p : particles) {
+  for_each_particle(particles, [time_step](Particle &p) {
     // Skip particle if rotation is turned off entirely for it.
     if (!p.can_rotate())
-      continue;
+      return;
 
     convert_torque_to_body_frame_apply_fix(p);
 
@@ -191,7 +193,7 @@ void convert_torques_propagate_omega(const ParticleRange &particles,
 
       p.omega() = omega_0 + (0.5 * time_step) * Wd;
     }
-  }
+  });
 }
 
 void convert_initial_torques(const ParticleRange &particles) {
@@ -24,6 +24,8 @@
 #include <profiler/profiler.hpp>
 
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 
 namespace detail {
 /**
@@ -35,21 +37,60 @@ struct True {
 };
 } // namespace detail
 
+/**
+ * @brief Run the bonded and non-bonded kernels over the local particles.
+ *
+ * The pairs of the interior cells, which do not involve ghost particles,
+ * are computed first, during the update of the ghosts with @p ghost_parts,
+ * then the bonds and the pairs of the boundary cells.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param pair_kernel       Non-bonded kernel
+ * @param pair_cutoff       Non-bonded cutoff, the pair loop is skipped if <= 0
+ * @param bond_cutoff       Bonded cutoff, the bond loop is skipped if < 0
+ * @param verlet_criterion  Filter for verlet lists
+ * @param threaded_pairs    Distribute the pair loop over the threads; the
+ *                          pair kernel may then only modify the two particles
+ * @param ghost_parts       Ghost data parts to update, combination of
+ *                          @ref Cells::DataPart
+ */
 template <class BondKernel, class PairKernel,
           class VerletCriterion = detail::True>
 void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
                       double pair_cutoff, double bond_cutoff,
-                      const VerletCriterion &verlet_criterion = {}) {
+                      const VerletCriterion &verlet_criterion = {},
+                      bool threaded_pairs = false,
+                      unsigned ghost_parts = Cells::DATA_PART_NONE) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
 
+  auto const threaded = threaded_pairs and cell_structure.threaded_pair_loop();
+  auto const &steps = cell_structure.pair_loop_steps(threaded);
+  auto step = steps.cells.begin();
+  auto const interior_end = std::next(
+      step, (pair_cutoff > 0.) ? static_cast<std::ptrdiff_t>(steps.n_interior)
+                               : 0);
+  auto const run_step = [&]() {
+    cell_structure.non_bonded_loop_step(pair_kernel, verlet_criterion,
+                                        *step++, threaded);
+  };
+
+  cell_structure.ghosts_update(ghost_parts, [&]() {
+    if (step != interior_end) {
+      run_step();
+    }
+    return step != interior_end;
+  });
+
   if (bond_cutoff >= 0.) {
     cell_structure.bond_loop(bond_kernel);
   }
 
   if (pair_cutoff > 0.) {
-    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    while (step != steps.cells.end()) {
+      run_step();
+    }
   }
 }
 #endif
@@ -32,23 +32,25 @@
 
 /** Calculate the minimal distance of two particles with types in set1 resp.
  *  set2.
- *  @param partCfg particle collection.
+ *
+ *  The pairs are searched on the particles of each rank within the range of
+ *  the cell system, and within a growing range if there is none. Has to be
+ *  called on the head node.
+ *
  *  @param set1 types of particles
  *  @param set2 types of particles
  *  @return the minimal distance of two particles
  */
-double mindist(PartCfg &partCfg, const std::vector<int> &set1,
-               const std::vector<int> &set2);
+double mindist(const std::vector<int> &set1, const std::vector<int> &set2);
 
 /** Find all particles within a given radius @p r_catch around a position.
- *  @param partCfg    @copybrief PartCfg
+ *  Has to be called on the head node.
  *  @param pos        position of sphere center
  *  @param dist       the sphere radius
  *
- *  @return List of ids close to @p pos.
+ *  @return List of ids close to @p pos, in ascending order.
  */
-std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
-                        double dist);
+std::vector<int> nbhood(const Utils::Vector3d &pos, double dist);
 
 /** Calculate the distribution of particles around others.
  *
@@ -58,7 +60,10 @@ std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
  *  into @p r_bins bins which are either equidistant (@p log_flag==false) or
  *  logarithmically equidistant (@p log_flag==true). The result is stored
  *  in the @p array dist.
- *  @param partCfg  particle collection.
+ *
+ *  The closest distances are found by the pair search on the particles of
+ *  each rank up to @p r_max. Has to be called on the head node.
+ *
  *  @param p1_types list with types of particles to find the distribution for.
  *  @param p2_types list with types of particles the others are distributed
  *                  around.
@@ -69,7 +74,7 @@ std::vector<int> nbhood(PartCfg &partCfg, const Utils::Vector3d &pos,
  *  @param low      particles closer than @p r_min
  *  @param dist     Array to store the result (size: @p r_bins).
  */
-void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
+void calc_part_distribution(std::vector<int> const &p1_types,
                             std::vector<int> const &p2_types, double r_min,
                             double r_max, int r_bins, bool log_flag,
                             double *low, double *dist);
@@ -79,22 +84,24 @@ void calc_part_distribution(PartCfg &partCfg, std::vector<int> const &p1_types,
  *  Calculates the spherically averaged structure factor of particles of a
  *  given type. The possible wave vectors are given by q = 2PI/L sqrt(nx^2 +
  *  ny^2 + nz^2).
- *  The S(q) is calculated up to a given length measured in 2PI/L (the
- *  recommended order of the wave vector is less than 20).
- *  The data is stored starting with q=1, and contains alternatingly S(q-1) and
- *  the number of wave vectors l with l^2=q. Only if the second number is
- *  nonzero, the first is meaningful. This means the q=1 entries are sf[0]=S(1)
- *  and sf[1]=1. For q=7, there are no possible wave vectors, so
- *  sf[2*(7-1)]=sf[2*(7-1)+1]=0.
+ *  The S(q) is calculated up to a given length measured in 2PI/L.
+ *  Only the wave vector magnitudes for which at least one wave vector
+ *  exists are returned.
+ *
+ *  The density modes are summed over the local particles of each rank and
+ *  reduced on the head node. They are either evaluated directly, which costs
+ *  O(order^3 N) operations, or, for large orders, from the FFT of the density
+ *  assigned to a mesh, which is approximate and requires FFTW and a cubic
+ *  box. Has to be called on the head node.
  *
- *  @param[in]  partCfg   particle collection
  *  @param[in]  p_types   list with types of particles to be analyzed
  *  @param[in]  order     the maximum wave vector length in units of 2PI/L
+ *  @param[in]  use_fft   evaluate the density modes on a mesh
  *  @param[out] wavevectors  the scattering vectors q
  *  @param[out] intensities  the structure factor S(q)
  */
-void calc_structurefactor(PartCfg &partCfg, std::vector<int> const &p_types,
-                          int order, std::vector<double> &wavevectors,
+void calc_structurefactor(std::vector<int> const &p_types, int order,
+                          bool use_fft, std::vector<double> &wavevectors,
                           std::vector<double> &intensities);
 
 /** Calculate the center of mass of a special type of the current configuration.
@@ -34,6 +34,7 @@
 #include "thermostat.hpp"
 
 #include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <algorithm>
 #include <cstdint>
@@ -76,6 +77,7 @@ BrownianThermostat brownian = {};
 IsotropicNptThermostat npt_iso = {};
 #endif
 ThermalizedBondThermostat thermalized_bond = {};
+GLEThermostat gle = {};
 #ifdef DPD
 DPDThermostat dpd = {};
 #endif
@@ -89,6 +91,7 @@ REGISTER_THERMOSTAT_CALLBACKS(brownian)
 REGISTER_THERMOSTAT_CALLBACKS(npt_iso)
 #endif
 REGISTER_THERMOSTAT_CALLBACKS(thermalized_bond)
+REGISTER_THERMOSTAT_CALLBACKS(gle)
 #ifdef DPD
 REGISTER_THERMOSTAT_CALLBACKS(dpd)
 #endif
@@ -117,6 +120,8 @@ void thermo_init(double time_step) {
 #endif
   if (thermo_switch & THERMO_BROWNIAN)
     brownian.recalc_prefactors(temperature);
+  if (thermo_switch & THERMO_GLE)
+    gle.recalc_prefactors(temperature, time_step);
 }
 
 void philox_counter_increment() {
@@ -141,6 +146,9 @@ void philox_counter_increment() {
     stokesian.rng_increment();
   }
 #endif
+  if (thermo_switch & THERMO_GLE) {
+    gle.rng_increment();
+  }
   if (n_thermalized_bonds) {
     thermalized_bond.rng_increment();
   }
@@ -194,6 +202,31 @@ void mpi_set_thermo_virtual(bool thermo_virtual) {
   mpi_call_all(mpi_set_thermo_virtual_local, thermo_virtual);
 }
 
+void mpi_set_gle_kernel_local(int type, GLEKernel const &kernel) {
+  if (type >= static_cast<int>(gle.kernels.size())) {
+    gle.kernels.resize(type + 1);
+  }
+  gle.kernels[type] = kernel;
+  on_thermostat_param_change();
+}
+
+REGISTER_CALLBACK(mpi_set_gle_kernel_local)
+
+void mpi_set_gle_kernel(int type, GLEKernel const &kernel) {
+  mpi_call_all(mpi_set_gle_kernel_local, type, kernel);
+}
+
+void mpi_set_gle_exact_propagator_local(bool exact) {
+  gle.exact_propagator = exact;
+  on_thermostat_param_change();
+}
+
+REGISTER_CALLBACK(mpi_set_gle_exact_propagator_local)
+
+void mpi_set_gle_exact_propagator(bool exact) {
+  mpi_call_all(mpi_set_gle_exact_propagator_local, exact);
+}
+
 void mpi_set_temperature_local(double temperature) {
   ::temperature = temperature;
   on_temperature_change();
@@ -31,9 +31,11 @@
 
 #include <boost/optional.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
+#include <vector>
 
 /** \name Thermostat switches */
 /**@{*/
@@ -44,6 +46,7 @@
 #define THERMO_LB 8
 #define THERMO_BROWNIAN 16
 #define THERMO_SD 32
+#define THERMO_GLE 64
 /**@}*/
 
 namespace Thermostat {
@@ -73,7 +76,8 @@ constexpr Utils::Vector3d sentinel(Utils::Vector3d) {
 
 /** Switch determining which thermostat(s) to use. This is a or'd value
  *  of the different possible thermostats (defines: \ref THERMO_OFF,
- *  \ref THERMO_LANGEVIN, \ref THERMO_DPD \ref THERMO_NPT_ISO). If it
+ *  \ref THERMO_LANGEVIN, \ref THERMO_DPD \ref THERMO_NPT_ISO,
+ *  \ref THERMO_GLE). If it
  *  is zero all thermostats are switched off and the temperature is
  *  set to zero.
  */
@@ -314,6 +318,205 @@ struct ThermalizedBondThermostat : public BaseThermostat {};
 struct DPDThermostat : public BaseThermostat {};
 #endif
 
+/** Power function for the exponents of the non-linear GLE viscosity.
+ *  Non-negative integer and half-integer exponents, which cover the
+ *  common Carreau-Yasuda models, are evaluated with multiplications and
+ *  at most one square root instead of a call to @c std::pow.
+ */
+class GLEExponent {
+public:
+  GLEExponent() = default;
+  explicit GLEExponent(double exponent) : m_exponent(exponent) {
+    auto const twice = 2. * exponent;
+    m_fast = exponent >= 0. and exponent <= max_fast_exponent and
+             twice == std::round(twice);
+    if (m_fast) {
+      m_int = static_cast<int>(exponent);
+      m_half = static_cast<int>(twice) % 2 == 1;
+    }
+  }
+
+  double operator()(double x) const {
+    if (not m_fast) {
+      return std::pow(x, m_exponent);
+    }
+    auto result = (m_half) ? std::sqrt(x) : 1.;
+    auto base = x;
+    for (auto n = m_int; n != 0; n >>= 1, base *= base) {
+      if (n & 1) {
+        result *= base;
+      }
+    }
+    return result;
+  }
+
+  double value() const { return m_exponent; }
+  bool is_fast() const { return m_fast; }
+
+private:
+  static constexpr double max_fast_exponent = 16.;
+  double m_exponent = 0.;
+  int m_int = 0;
+  bool m_half = false;
+  bool m_fast = true;
+};
+
+/** Prony mode of a memory kernel of the generalized Langevin equation. */
+struct GLEMode {
+  /** @name Parameters */
+  /**@{*/
+  /** Zero-shear friction coefficient @f$ \zeta_{m0} @f$. */
+  double gamma = 0.;
+  /** Relaxation time @f$ \tau_m @f$. */
+  double tau = 1.;
+  /** Critical velocity @f$ v_c @f$. */
+  double vcrit = 1.;
+  /** Exponent @f$ a @f$ of the viscosity. */
+  double aexp = 0.;
+  /** Exponent @f$ b @f$ of the viscosity. */
+  double bexp = 2.;
+  /** Zero-shear rotational friction coefficient @f$ \zeta_{mR} @f$. */
+  double gamma_rot = 0.;
+  /** Critical angular velocity. */
+  double omegacrit = 1.;
+  /**@}*/
+  /** @name Prefactors */
+  /**@{*/
+  /** Stores @f$ 1 / \tau_m @f$. */
+  double nu;
+  /** Damping of the auxiliary variable over one time step.
+   *  Stores @f$ 1 - dt / \tau_m @f$, or @f$ e^{-dt / \tau_m} @f$ for the
+   *  exact propagator.
+   */
+  double decay;
+  /** Coupling of the auxiliary variable to the velocity over one time step.
+   *  Stores @f$ dt @f$, or @f$ \tau_m (1 - e^{-dt / \tau_m}) @f$ for the
+   *  exact propagator.
+   */
+  double drift;
+  /** Stores @f$ v_c^{-b} @f$. */
+  double inv_vcrit_b;
+  /** Stores @f$ \omega_c^{-b} @f$. */
+  double inv_omegacrit_b;
+  /** Exponent @f$ b / 2 @f$ of the squared velocity. */
+  GLEExponent half_bexp;
+  /** Exponent @f$ a @f$ of the shear-thinning factor. */
+  GLEExponent aexp_pow;
+  /** Translational noise at zero shear.
+   *  Stores @f$ \sqrt{2 k_B T dt / \zeta_{m0}} @f$, or
+   *  @f$ \sqrt{k_B T \tau_m (1 - e^{-2 dt / \tau_m}) / \zeta_{m0}} @f$
+   *  for the exact propagator.
+   */
+  double pref_noise;
+  /** Rotational noise at zero shear, same as @ref pref_noise with
+   *  @f$ \zeta_{mR} @f$.
+   */
+  double pref_noise_rot;
+  /**@}*/
+
+  /** Recalculate the prefactors.
+   *  The explicit Euler scheme needs @f$ dt \ll \tau_m @f$. The exact
+   *  propagator integrates the Ornstein-Uhlenbeck process of the auxiliary
+   *  variable analytically for a velocity constant over the time step,
+   *  hence it is stable for any @f$ dt / \tau_m @f$ and keeps the
+   *  stationary variance @f$ k_B T \tau_m / \zeta_m @f$ exact
+   *  (@cite baczewski13a).
+   */
+  void recalc_prefactors(double kT, double time_step, bool exact) {
+    nu = 1. / tau;
+    half_bexp = GLEExponent(bexp / 2.);
+    aexp_pow = GLEExponent(aexp);
+    inv_vcrit_b = half_bexp(1. / (vcrit * vcrit));
+    inv_omegacrit_b = half_bexp(1. / (omegacrit * omegacrit));
+    double variance;
+    if (exact) {
+      decay = std::exp(-time_step * nu);
+      drift = -tau * std::expm1(-time_step * nu);
+      variance = -kT * tau * std::expm1(-2. * time_step * nu);
+    } else {
+      decay = 1. - time_step * nu;
+      drift = time_step;
+      variance = 2. * kT * time_step;
+    }
+    pref_noise = std::sqrt(variance / gamma);
+    pref_noise_rot = std::sqrt(variance / gamma_rot);
+  }
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &gamma &tau &vcrit &aexp &bexp &gamma_rot &omegacrit;
+  }
+};
+
+/** Memory kernel of the generalized Langevin equation, shared by all
+ *  particles of a type.
+ */
+struct GLEKernel {
+  /** Prony modes. */
+  std::vector<GLEMode> modes;
+  /** Anisotropic scaling of the friction of all modes. */
+  Utils::Vector3d gamma_vec = {1., 1., 1.};
+  /** Stores @f$ 1 / \sqrt{\gamma_{vec}} @f$ for the noise. */
+  Utils::Vector3d inv_sqrt_gamma_vec = {1., 1., 1.};
+  /** All modes have @f$ a = 0 @f$, i.e. the kernel is linear. */
+  bool linear = true;
+  /** All modes have the same exponent @f$ b @f$, so that
+   *  @f$ v^b @f$ is shared by all modes.
+   */
+  bool shared_bexp = true;
+
+  int n_modes() const { return static_cast<int>(modes.size()); }
+
+  void recalc_prefactors(double kT, double time_step, bool exact) {
+    for (auto &mode : modes) {
+      mode.recalc_prefactors(kT, time_step, exact);
+    }
+    linear = std::all_of(modes.begin(), modes.end(),
+                         [](GLEMode const &mode) { return mode.aexp == 0.; });
+    shared_bexp = std::all_of(
+        modes.begin(), modes.end(), [this](GLEMode const &mode) {
+          return mode.bexp == modes.front().bexp;
+        });
+    for (unsigned int j = 0u; j < 3u; ++j) {
+      inv_sqrt_gamma_vec[j] = 1. / std::sqrt(gamma_vec[j]);
+    }
+  }
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &modes &gamma_vec;
+  }
+};
+
+/** %Thermostat for the Prony modes of the generalized Langevin equation.
+ *  The noise of each auxiliary variable is keyed by particle id and Prony
+ *  mode, so that trajectories don't depend on the MPI decomposition nor on
+ *  the particle iteration order. The memory kernels are stored per
+ *  particle type, only the auxiliary variables are stored per particle.
+ */
+struct GLEThermostat : public BaseThermostat {
+  /** Recalculate the prefactors of all kernels.
+   *  Needs to be called every time the parameters are changed.
+   */
+  void recalc_prefactors(double kT, double time_step) {
+    for (auto &kernel : kernels) {
+      kernel.recalc_prefactors(kT, time_step, exact_propagator);
+    }
+  }
+  /** Kernel of a particle type, @c nullptr if the type has no Prony modes. */
+  GLEKernel const *kernel(int type) const {
+    if (type < 0 or type >= static_cast<int>(kernels.size()) or
+        kernels[type].modes.empty()) {
+      return nullptr;
+    }
+    return &kernels[type];
+  }
+  /** Memory kernels, indexed by particle type. */
+  std::vector<GLEKernel> kernels;
+  /** Propagate the auxiliary variables with the exact Ornstein-Uhlenbeck
+   *  solution instead of the explicit Euler scheme.
+   */
+  bool exact_propagator = false;
+};
+
 #ifdef STOKESIAN_DYNAMICS
 /** %Thermostat for Stokesian dynamics. */
 struct StokesianThermostat : public BaseThermostat {
@@ -340,6 +543,7 @@ NEW_THERMOSTAT(brownian)
 NEW_THERMOSTAT(npt_iso)
 #endif
 NEW_THERMOSTAT(thermalized_bond)
+NEW_THERMOSTAT(gle)
 #ifdef DPD
 NEW_THERMOSTAT(dpd)
 #endif
@@ -354,6 +558,7 @@ extern BrownianThermostat brownian;
 extern IsotropicNptThermostat npt_iso;
 #endif
 extern ThermalizedBondThermostat thermalized_bond;
+extern GLEThermostat gle;
 #ifdef DPD
 extern DPDThermostat dpd;
 #endif
@@ -375,6 +580,14 @@ void mpi_set_langevin_gamma_rot(Thermostat::GammaType const &gamma);
 
 void mpi_set_thermo_virtual(bool thermo_virtual);
 
+/** Set the memory kernel of the Prony modes of a particle type.
+ *  An empty kernel removes the viscoelastic friction of the type.
+ */
+void mpi_set_gle_kernel(int type, GLEKernel const &kernel);
+
+/** Select the propagator of the auxiliary variables of the Prony modes. */
+void mpi_set_gle_exact_propagator(bool exact);
+
 void mpi_set_temperature(double temperature);
 
 void mpi_set_thermo_switch(int thermo_switch);
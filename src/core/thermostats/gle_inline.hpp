@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THERMOSTATS_GLE_INLINE_HPP
+#define THERMOSTATS_GLE_INLINE_HPP
+
+#include "config.hpp"
+
+#include "Particle.hpp"
+#include "random.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/** Gaussian noise of the translational auxiliary variables of a Prony mode.
+ *  The Philox stream is keyed by particle id and mode index, hence the
+ *  noise doesn't depend on the MPI decomposition or on the iteration order.
+ *  @param[in]     gle            Parameters
+ *  @param[in]     p              %Particle
+ *  @param[in]     mode           Prony mode index
+ */
+inline Utils::Vector3d gle_noise(GLEThermostat const &gle, Particle const &p,
+                                 int mode) {
+  return Random::noise_gaussian<RNGSalt::GLE>(gle.rng_counter(),
+                                              gle.rng_seed(), p.id(), mode);
+}
+
+#ifdef ROTATION
+/** Gaussian noise of the rotational auxiliary variables of a Prony mode.
+ *  @param[in]     gle            Parameters
+ *  @param[in]     p              %Particle
+ *  @param[in]     mode           Prony mode index
+ */
+inline Utils::Vector3d gle_noise_rotation(GLEThermostat const &gle,
+                                          Particle const &p, int mode) {
+  return Random::noise_gaussian<RNGSalt::GLE_ROT>(
+      gle.rng_counter(), gle.rng_seed(), p.id(), mode);
+}
+#endif // ROTATION
+
+/** Shear-thinning factors of all Prony modes of a kernel.
+ *  Evaluates @f$ (1 + (v^2/v_c^2)^{b/2})^a @f$ for each mode, i.e. the
+ *  ratio of the zero-shear friction @f$ \zeta_{m0} @f$ to the non-linear
+ *  friction. The modes are processed in batches: linear kernels skip the
+ *  evaluation, @f$ (v^2)^{b/2} @f$ is computed once when all modes share
+ *  the exponent @f$ b @f$, and integer or half-integer exponents avoid
+ *  calls to @c std::pow.
+ *  @param[in]     kernel         Memory kernel
+ *  @param[in]     v2             Squared (angular) velocity
+ *  @param[in]     rotation       Use the critical angular velocities
+ *  @param[out]    factors        Factors of the modes
+ */
+inline void gle_shear_factors(GLEKernel const &kernel, double v2,
+                              bool rotation, Utils::Span<double> factors) {
+  auto const &modes = kernel.modes;
+  auto const n_modes = modes.size();
+  assert(factors.size() == n_modes);
+  if (kernel.linear) {
+    std::fill(factors.begin(), factors.end(), 1.);
+    return;
+  }
+  if (kernel.shared_bexp) {
+    auto const v2_b = modes.front().half_bexp(v2);
+    for (std::size_t k = 0; k < n_modes; ++k) {
+      auto const &mode = modes[k];
+      factors[k] = v2_b * (rotation ? mode.inv_omegacrit_b : mode.inv_vcrit_b);
+    }
+  } else {
+    for (std::size_t k = 0; k < n_modes; ++k) {
+      auto const &mode = modes[k];
+      factors[k] = mode.half_bexp(v2) *
+                   (rotation ? mode.inv_omegacrit_b : mode.inv_vcrit_b);
+    }
+  }
+  for (std::size_t k = 0; k < n_modes; ++k) {
+    factors[k] = modes[k].aexp_pow(1. + factors[k]);
+  }
+}
+
+#ifdef EXTERNAL_FORCES
+/** Viscoelastic friction and noise of the Prony modes.
+ *  Propagates the auxiliary variables of the particle by one time step and
+ *  returns their contribution to the force and torque. The per-particle
+ *  state is resized to the number of modes of the kernel if needed.
+ *  @param[in]     gle            Parameters
+ *  @param[in]     kernel         Memory kernel of the particle type
+ *  @param[in,out] p              %Particle
+ *  @param[out]    factors        Scratch buffer for the shear-thinning factors
+ *  @return viscoelastic force and torque
+ */
+inline ParticleForce friction_thermo_gle(GLEThermostat const &gle,
+                                         GLEKernel const &kernel, Particle &p,
+                                         std::vector<double> &factors) {
+  auto const n_modes = kernel.n_modes();
+  auto const &modes = kernel.modes;
+  auto &state = p.gle();
+  if (state.n_modes() != n_modes) {
+    state.resize(n_modes);
+  }
+  factors.resize(modes.size());
+  ParticleForce f = {};
+
+  /* Update of the viscoelastic force */
+  {
+    Utils::Span<double> const u[3] = {state[ParticleGLE::U_X],
+                                      state[ParticleGLE::U_Y],
+                                      state[ParticleGLE::U_Z]};
+    gle_shear_factors(kernel, p.v().norm2(), false, Utils::make_span(factors));
+    for (int k = 0; k < n_modes; k++) {
+      auto const &mode = modes[k];
+      auto const factor = factors[k];
+      auto const pref_force = mode.nu * mode.gamma / factor;
+      auto const pref_noise = mode.pref_noise * std::sqrt(factor);
+      auto const randomG = gle_noise(gle, p, k);
+      for (int j = 0; j < 3; j++) {
+        if (!p.is_fixed_along(j)) {
+          u[j][k] = mode.decay * u[j][k] - mode.drift * p.v()[j] -
+                    pref_noise * kernel.inv_sqrt_gamma_vec[j] * randomG[j];
+          f.f[j] += pref_force * kernel.gamma_vec[j] * u[j][k];
+        }
+      }
+    }
+  }
+
+#ifdef ROTATION
+  if (p.can_rotate()) {
+    Utils::Span<double> const u[3] = {state[ParticleGLE::U_ROT_X],
+                                      state[ParticleGLE::U_ROT_Y],
+                                      state[ParticleGLE::U_ROT_Z]};
+    gle_shear_factors(kernel, p.omega().norm2(), true,
+                      Utils::make_span(factors));
+    /* Update the viscoelastic torque */
+    for (int k = 0; k < n_modes; k++) {
+      auto const &mode = modes[k];
+      auto const factor = factors[k];
+      auto const pref_torque = mode.nu * mode.gamma_rot / factor;
+      auto const pref_noise = mode.pref_noise_rot * std::sqrt(factor);
+      auto const randomGr = gle_noise_rotation(gle, p, k);
+      for (int j = 0; j < 3; j++) {
+        if (p.can_rotate_around(j)) {
+          u[j][k] = mode.decay * u[j][k] - mode.drift * p.omega()[j] -
+                    pref_noise * kernel.inv_sqrt_gamma_vec[j] * randomGr[j];
+          f.torque[j] += pref_torque * kernel.gamma_vec[j] * u[j][k];
+        }
+      }
+    }
+  }
+#endif // ROTATION
+
+  return f;
+}
+#endif // EXTERNAL_FORCES
+
+#endif
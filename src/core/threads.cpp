@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.hpp"
+
+#include "threads.hpp"
+
+#include "communication.hpp"
+
+#include <stdexcept>
+
+static int n_threads = 1;
+
+int get_n_threads() { return n_threads; }
+
+static void mpi_set_n_threads_local(int value) { n_threads = value; }
+
+REGISTER_CALLBACK(mpi_set_n_threads_local)
+
+void mpi_set_n_threads(int value) {
+  if (value < 1) {
+    throw std::domain_error("n_threads must be >= 1");
+  }
+#ifndef OPENMP
+  if (value != 1) {
+    throw std::runtime_error("Multiple threads per rank require OpenMP "
+                             "(CMake option WITH_OPENMP)");
+  }
+#endif
+  mpi_call_all(mpi_set_n_threads_local, value);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_THREADS_HPP
+#define CORE_THREADS_HPP
+
+/** \file
+ *  Shared-memory parallelism of the per-particle passes.
+ *
+ *  When the core is built with OpenMP (CMake option \c WITH_OPENMP), the
+ *  loops over the particles of a rank are distributed over threads, one
+ *  cell at a time. The number of threads is set at runtime and is the same
+ *  on all ranks; it defaults to one thread per rank.
+ *
+ *  Only loops whose iterations are independent may use @ref
+ *  for_each_particle: the kernel can modify the particle it is called
+ *  with, but must not write to other particles or to shared state.
+ *  The non-bonded pair loop uses @ref parallel_for over colored cells,
+ *  see @ref CellStructure::non_bonded_loop_threaded.
+ *
+ *  Implementation in \ref threads.cpp.
+ */
+
+#include "config.hpp"
+
+#include "ParticleRange.hpp"
+
+#include <cstddef>
+#include <iterator>
+
+/** Number of threads of the per-particle loops. */
+int get_n_threads();
+
+/** Set the number of threads of the per-particle loops on all ranks.
+ *  @param n_threads   Number of threads per rank, 1 disables threading
+ */
+void mpi_set_n_threads(int n_threads);
+
+/** Apply a kernel to each index of a range, distributed over the threads.
+ *  @param n           Number of indices
+ *  @param kernel      Callable taking an index
+ */
+template <class Kernel> void parallel_for(std::size_t n, Kernel const &kernel) {
+  auto const size = static_cast<std::ptrdiff_t>(n);
+#ifdef OPENMP
+  auto const n_threads = get_n_threads();
+#pragma omp parallel for schedule(static) num_threads(n_threads)               \
+    if (n_threads > 1)
+#endif
+  for (std::ptrdiff_t i = 0; i < size; i++) {
+    kernel(static_cast<std::size_t>(i));
+  }
+}
+
+/** Apply a kernel to each particle of a range of cells.
+ *  The cells are distributed over the threads, so that each particle is
+ *  visited exactly once by a single thread.
+ *  @param first       First cell
+ *  @param last        Past-the-end cell
+ *  @param kernel      Callable taking a particle by reference
+ */
+template <class CellIterator, class Kernel>
+void for_each_particle(CellIterator first, CellIterator last,
+                       Kernel const &kernel) {
+  auto const n_cells = static_cast<std::size_t>(std::distance(first, last));
+  parallel_for(n_cells, [first, &kernel](std::size_t i) {
+    for (auto &p : first[i]->particles()) {
+      kernel(p);
+    }
+  });
+}
+
+/** Apply a kernel to each particle of a range.
+ *  @param particles   Particles, starting at the beginning of a cell
+ *  @param kernel      Callable taking a particle by reference
+ */
+template <class Kernel>
+void for_each_particle(ParticleRange const &particles, Kernel const &kernel) {
+  for_each_particle(particles.begin().cell(), particles.end().cell(), kernel);
+}
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE CompactParticles test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config.hpp"
+
+#include "cell_system/CompactParticles.hpp"
+
+#include "Particle.hpp"
+#include "algorithm/link_cell.hpp"
+#include "cell_system/Cell.hpp"
+
+#include <utils/Span.hpp>
+
+#include <boost/iterator/indirect_iterator.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+
+/* 6 local cells followed by 4 ghost cells, the red neighbors of each
+ * local cell are all cells with a larger index. The particles sit on
+ * the x-axis at the position of their id and carry half their id as
+ * charge. */
+namespace {
+std::size_t const n_local = 6;
+std::size_t const n_cells = 10;
+std::size_t const n_part_per_cell = 5;
+} // namespace
+
+struct TestCells {
+  TestCells() : storage(n_cells) {
+    auto id = 0;
+    for (auto &cell : storage) {
+      cell.particles().resize(n_part_per_cell);
+      for (auto &p : cell.particles()) {
+        p.id() = id;
+        p.type() = id % 3;
+        p.pos() = {static_cast<double>(id), 0., 0.};
+#ifdef ELECTROSTATICS
+        p.q() = 0.5 * id;
+#endif
+        ++id;
+      }
+      cells.push_back(&cell);
+    }
+    for (std::size_t i = 0; i < n_local; ++i) {
+      std::vector<Cell *> red(cells.begin() + i + 1, cells.end());
+      storage[i].m_neighbors = Neighbors<Cell *>(red, {});
+    }
+  }
+
+  Utils::Span<Cell *> local_cells() { return {cells.data(), n_local}; }
+  Utils::Span<Cell *> ghost_cells() {
+    return {cells.data() + n_local, n_cells - n_local};
+  }
+
+  std::vector<Cell> storage;
+  std::vector<Cell *> cells;
+};
+
+BOOST_AUTO_TEST_CASE(layout) {
+  TestCells cells;
+  CompactParticles cp;
+  cp.rebuild(cells.local_cells(), cells.ghost_cells());
+  cp.gather();
+
+  BOOST_REQUIRE_EQUAL(cp.size(), n_cells * n_part_per_cell);
+  BOOST_REQUIRE_EQUAL(cp.n_local_cells(), n_local);
+  for (std::size_t c = 0; c < n_local; ++c) {
+    BOOST_CHECK_EQUAL(cp.cell_begin(c), c * n_part_per_cell);
+    BOOST_CHECK_EQUAL(cp.cell_end(c), (c + 1) * n_part_per_cell);
+    BOOST_CHECK_EQUAL(cp.red_neighbors(c).size(), n_cells - c - 1);
+  }
+  for (std::size_t i = 0; i < cp.size(); ++i) {
+    BOOST_CHECK_EQUAL(cp.position(i)[0], static_cast<double>(i));
+    BOOST_CHECK_EQUAL(cp.type[i], static_cast<int>(i % 3));
+    BOOST_CHECK_EQUAL(cp.particle(i).id(), static_cast<int>(i));
+#ifdef ELECTROSTATICS
+    BOOST_CHECK_EQUAL(cp.q[i], 0.5 * static_cast<double>(i));
+#else
+    BOOST_CHECK_EQUAL(cp.q[i], 0.);
+#endif
+    BOOST_CHECK_EQUAL(cp.force[0][i], 0.);
+  }
+  BOOST_CHECK(not cp.has_exclusions());
+  BOOST_CHECK(not cp.verlet_lists_valid());
+
+  /* forces are added to the particles */
+  for (std::size_t i = 0; i < cp.size(); ++i) {
+    cp.force[1][i] = static_cast<double>(i);
+  }
+  cp.scatter_forces();
+  cp.scatter_forces();
+  for (auto const cell : cells.cells) {
+    for (auto const &p : cell->particles()) {
+      BOOST_CHECK_EQUAL(p.force()[1], 2. * p.id());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(verlet_lists) {
+  TestCells cells;
+  CompactParticles cp;
+  cp.rebuild(cells.local_cells(), cells.ghost_cells());
+  cp.gather();
+
+  auto const cutoff = 7.5;
+  auto const criterion = [&cp, cutoff](std::size_t i, std::size_t j) {
+    return std::abs(cp.position(i)[0] - cp.position(j)[0]) < cutoff;
+  };
+  cp.rebuild_verlet_lists(criterion);
+  BOOST_REQUIRE(cp.verlet_lists_valid());
+
+  /* same pairs, in the same order, as the link cell loop */
+  std::vector<std::pair<int, int>> lc_pairs;
+  auto const first = boost::make_indirect_iterator(cells.cells.begin());
+  auto const last = first + n_local;
+  Algorithm::link_cell(first, last, [&](Particle &p1, Particle &p2) {
+    if (std::abs(p1.pos()[0] - p2.pos()[0]) < cutoff) {
+      lc_pairs.emplace_back(p1.id(), p2.id());
+    }
+  });
+
+  std::vector<std::pair<int, int>> vl_pairs;
+  for (std::size_t i = 0; i < cp.cell_begin(cp.n_local_cells()); ++i) {
+    for (auto const j : cp.verlet_list(i)) {
+      vl_pairs.emplace_back(static_cast<int>(i), static_cast<int>(j));
+    }
+  }
+  BOOST_CHECK_EQUAL(cp.n_verlet_pairs(), vl_pairs.size());
+  BOOST_CHECK(vl_pairs == lc_pairs);
+
+  /* the lists are invalidated by a rebuild of the layout */
+  cp.rebuild(cells.local_cells(), cells.ghost_cells());
+  BOOST_CHECK(not cp.verlet_lists_valid());
+}
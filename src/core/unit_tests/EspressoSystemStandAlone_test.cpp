@@ -29,35 +29,53 @@ namespace utf = boost::unit_test;
 #include "EspressoSystemStandAlone.hpp"
 #include "MpiCallbacks.hpp"
 #include "Particle.hpp"
+#include "accumulators.hpp"
 #include "accumulators/TimeSeries.hpp"
 #include "bonded_interactions/bonded_interaction_utils.hpp"
 #include "bonded_interactions/fene.hpp"
 #include "bonded_interactions/harmonic.hpp"
+#include "cells.hpp"
 #include "communication.hpp"
+#include "electrostatics/debye_hueckel.hpp"
 #include "electrostatics/p3m.hpp"
 #include "electrostatics/registration.hpp"
 #include "energy.hpp"
 #include "galilei.hpp"
+#include "grid_based_algorithms/lb_boundaries.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
 #include "integrate.hpp"
 #include "nonbonded_interactions/lj.hpp"
 #include "observables/ParticleVelocities.hpp"
+#include "observables/PressureObservable.hpp"
 #include "particle_data.hpp"
 #include "particle_node.hpp"
+#include "threads.hpp"
+
+#include <shapes/Sphere.hpp>
 
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
 #include <utils/math/int_pow.hpp>
 #include <utils/math/sqr.hpp>
 
+#include <boost/filesystem.hpp>
 #include <boost/mpi.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/variant.hpp>
 
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -94,6 +112,67 @@ static void mpi_create_bonds(int harm_bond_id, int fene_bond_id) {
   mpi_call_all(mpi_create_bonds_local, harm_bond_id, fene_bond_id);
 }
 
+namespace {
+std::shared_ptr<Observables::ParticleVelocities> time_series_obs;
+std::shared_ptr<Accumulators::TimeSeries> time_series_acc;
+} // namespace
+
+static void mpi_create_time_series_local(std::vector<int> pids, int delta_N) {
+  time_series_obs = std::make_shared<Observables::ParticleVelocities>(pids);
+  time_series_acc =
+      std::make_shared<Accumulators::TimeSeries>(time_series_obs, delta_N);
+}
+
+REGISTER_CALLBACK(mpi_create_time_series_local)
+
+static void mpi_set_time_series_auto_update_local(bool auto_update) {
+  if (auto_update) {
+    Accumulators::auto_update_add(time_series_acc.get());
+  } else {
+    Accumulators::auto_update_remove(time_series_acc.get());
+  }
+}
+
+REGISTER_CALLBACK(mpi_set_time_series_auto_update_local)
+
+static void mpi_update_time_series_local() {
+  time_series_acc->update(comm_cart);
+}
+
+REGISTER_CALLBACK(mpi_update_time_series_local)
+
+static std::vector<double> mpi_evaluate_time_series_obs_local() {
+  return (*time_series_obs)(comm_cart);
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_evaluate_time_series_obs_local)
+
+namespace {
+std::shared_ptr<Observables::Pressure> pressure_series_obs;
+std::shared_ptr<Accumulators::TimeSeries> pressure_series_acc;
+} // namespace
+
+static void mpi_create_pressure_series_local(int delta_N) {
+  pressure_series_obs = std::make_shared<Observables::Pressure>();
+  pressure_series_acc =
+      std::make_shared<Accumulators::TimeSeries>(pressure_series_obs, delta_N);
+  Accumulators::auto_update_add(pressure_series_acc.get());
+}
+
+REGISTER_CALLBACK(mpi_create_pressure_series_local)
+
+static void mpi_remove_pressure_series_local() {
+  Accumulators::auto_update_remove(pressure_series_acc.get());
+}
+
+REGISTER_CALLBACK(mpi_remove_pressure_series_local)
+
+static std::vector<double> mpi_evaluate_pressure_obs_local() {
+  return Observables::Pressure{}(comm_cart);
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_evaluate_pressure_obs_local)
+
 #ifdef P3M
 static void mpi_set_tuned_p3m_local(double prefactor) {
   auto p3m = P3MParameters{false,
@@ -116,6 +195,63 @@ static void mpi_set_tuned_p3m(double prefactor) {
 }
 #endif // P3M
 
+static void mpi_set_always_threaded_pairs_local(bool always_threaded) {
+  cell_structure.always_threaded_pairs = always_threaded;
+}
+
+REGISTER_CALLBACK(mpi_set_always_threaded_pairs_local)
+
+/** Number of pairs in the Verlet lists of the structure-of-arrays copy of
+ *  the particles on all ranks. */
+static std::size_t mpi_get_n_compact_pairs_local() {
+  return boost::mpi::all_reduce(
+      comm_cart, cell_structure.compact_particles().n_verlet_pairs(),
+      std::plus<std::size_t>());
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_get_n_compact_pairs_local)
+
+#if defined(ELECTROSTATICS) && !defined(P3M)
+static std::shared_ptr<DebyeHueckel> debye_hueckel;
+
+/** Replace the Debye-Hückel actor, a zero @p prefactor removes it. */
+static void mpi_set_debye_hueckel_local(double prefactor, double r_cut) {
+  if (debye_hueckel) {
+    ::Coulomb::remove_actor(debye_hueckel);
+    debye_hueckel.reset();
+  }
+  if (prefactor != 0.) {
+    debye_hueckel = std::make_shared<DebyeHueckel>(prefactor, 0., r_cut);
+    ::Coulomb::add_actor(debye_hueckel);
+  }
+}
+
+REGISTER_CALLBACK(mpi_set_debye_hueckel_local)
+#endif
+
+#ifdef LB_BOUNDARIES
+static void mpi_add_lb_sphere_local(Utils::Vector3d center, double radius,
+                                    Utils::Vector3d velocity) {
+  auto sphere = std::make_shared<Shapes::Sphere>();
+  sphere->pos() = center;
+  sphere->rad() = radius;
+  auto boundary = std::make_shared<LBBoundaries::LBBoundary>();
+  boundary->set_shape(sphere);
+  boundary->set_velocity(velocity);
+  LBBoundaries::add(boundary);
+}
+
+REGISTER_CALLBACK(mpi_add_lb_sphere_local)
+
+static void mpi_remove_lb_boundaries_local() {
+  while (!LBBoundaries::lbboundaries.empty()) {
+    LBBoundaries::remove(LBBoundaries::lbboundaries.back());
+  }
+}
+
+REGISTER_CALLBACK(mpi_remove_lb_boundaries_local)
+#endif // LB_BOUNDARIES
+
 BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
                         *utf::precondition(if_head_node())) {
   auto constexpr tol = 8. * 100. * std::numeric_limits<double>::epsilon();
@@ -160,8 +296,9 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
   // check accumulators
   {
     auto const pids = std::vector<int>{pid2};
-    auto obs = std::make_shared<Observables::ParticleVelocities>(pids);
-    auto acc = Accumulators::TimeSeries(obs, 1);
+    mpi_call_all(mpi_create_time_series_local, pids, 1);
+    auto const &obs = time_series_obs;
+    auto const &acc = time_series_acc;
 
     auto const obs_shape = obs->shape();
     auto const ref_shape = std::vector<std::size_t>{pids.size(), 3u};
@@ -172,12 +309,13 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
     for (int i = 0; i < 5; ++i) {
       set_particle_v(pid2, {static_cast<double>(i), 0., 0.});
 
-      acc.update();
-      auto const time_series = acc.time_series();
+      mpi_call_all(mpi_update_time_series_local);
+      auto const time_series = acc->time_series();
       BOOST_REQUIRE_EQUAL(time_series.size(), i + 1);
 
       auto const acc_value = time_series.back();
-      auto const obs_value = (*obs)();
+      auto const obs_value = mpi_call(Communication::Result::main_rank,
+                                      mpi_evaluate_time_series_obs_local);
       auto const &p = get_particle_data(pid2);
       BOOST_TEST(obs_value == p.v(), boost::test_tools::per_element());
       BOOST_TEST(acc_value == p.v(), boost::test_tools::per_element());
@@ -229,6 +367,20 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
       BOOST_CHECK_CLOSE(obs_energy->non_bonded_inter[i], ref_inter, 1e-10);
       BOOST_CHECK_CLOSE(obs_energy->non_bonded_intra[i], ref_intra, 1e-10);
     }
+
+    // measure forces with the serial pair loop
+    espresso::system->set_time_step(0.001);
+    espresso::system->set_skin(0.4);
+    mpi_integrate(0, 0);
+    auto const lj_force = 48.0 * eps * frac6 * (frac6 - 0.5) / r_off;
+    auto const expected = std::unordered_map<int, Utils::Vector3d>{
+        {pid1, {-lj_force, 0., 0.}},
+        {pid2, {lj_force, -lj_force, 0.}},
+        {pid3, {0., lj_force, 0.}}};
+    for (auto const &kv : expected) {
+      auto const &p = get_particle_data(kv.first);
+      BOOST_CHECK_LE((p.force() - kv.second).norm(), tol * lj_force);
+    }
   }
 #endif // LENNARD_JONES
 
@@ -347,6 +499,294 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory,
         assert((p.pos() - pos_com).norm() < 0.5);
       }
     }
+
+    // accumulators are updated inside the integration loop after steps
+    // 1, 5, 9, 13, ...; the steps towards the next update carry over to
+    // the next integration
+    mpi_call_all(mpi_create_time_series_local, pids, 4);
+    mpi_call_all(mpi_set_time_series_auto_update_local, true);
+    python_integrate(10, false, false);
+    BOOST_CHECK_EQUAL(time_series_acc->time_series().size(), 3u);
+    python_integrate(3, false, false);
+    BOOST_REQUIRE_EQUAL(time_series_acc->time_series().size(), 4u);
+    auto const &sample = time_series_acc->time_series().back();
+    for (std::size_t i = 0; i < pids.size(); ++i) {
+      auto const &p = get_particle_data(pids[i]);
+      auto const first = sample.begin() + static_cast<std::ptrdiff_t>(3 * i);
+      auto const v = std::vector<double>(first, first + 3);
+      BOOST_TEST(v == p.v(), boost::test_tools::per_element());
+    }
+    mpi_call_all(mpi_set_time_series_auto_update_local, false);
+
+    // the pressure is calculated on the head node, the other ranks run its
+    // MPI callbacks from inside the integration loop; the samples match
+    // the pressure after separate integrations, and so does the trajectory
+    {
+      auto const reset_system = [&]() {
+        reset_particle_positions();
+        for (auto pid : pids) {
+          set_particle_v(pid, {});
+        }
+        mpi_integrate(0, -1);
+      };
+      reset_system();
+      std::vector<double> pressures;
+      for (auto const steps : {1, 4, 4}) {
+        mpi_integrate(steps, 0);
+        auto const pressure = mpi_call(Communication::Result::main_rank,
+                                       mpi_evaluate_pressure_obs_local);
+        BOOST_REQUIRE_EQUAL(pressure.size(), 1u);
+        pressures.emplace_back(pressure[0]);
+      }
+      BOOST_REQUIRE_NE(pressures.front(), pressures.back());
+      std::vector<Utils::Vector3d> positions;
+      for (auto pid : pids) {
+        positions.emplace_back(get_particle_data(pid).pos());
+      }
+      reset_system();
+      mpi_call_all(mpi_create_pressure_series_local, 4);
+      python_integrate(9, false, false);
+      mpi_call_all(mpi_remove_pressure_series_local);
+      auto const &series = pressure_series_acc->time_series();
+      BOOST_REQUIRE_EQUAL(series.size(), pressures.size());
+      for (std::size_t i = 0; i < series.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(series[i].size(), 1u);
+        BOOST_CHECK_CLOSE(series[i][0], pressures[i], 1e-10);
+      }
+      for (std::size_t i = 0; i < pids.size(); ++i) {
+        auto const &p = get_particle_data(pids[i]);
+        BOOST_CHECK_LE((p.pos() - positions[i]).norm(), tol);
+      }
+    }
+
+    // the threaded pair loop gives the same forces, both when building
+    // and when replaying the verlet lists, color by color on a single
+    // thread and with OpenMP on several threads; the forces are
+    // recalculated unconditionally since neither setting is an event.
+    // The serial energy loop in between replays the same verlet lists.
+    auto const check_threaded_forces = [&]() {
+      reset_particle_positions();
+      mpi_integrate(0, -1);
+      std::unordered_map<int, Utils::Vector3d> reference;
+      for (auto pid : pids) {
+        reference[pid] = get_particle_data(pid).force();
+      }
+      auto const reference_energy = calculate_energy()->accumulate();
+      auto const check_forces = [&]() {
+        for (int i = 0; i < 2; ++i) {
+          mpi_integrate(0, -1);
+          for (auto pid : pids) {
+            auto const &p = get_particle_data(pid);
+            BOOST_CHECK_LE((p.force() - reference[pid]).norm(), tol);
+          }
+          BOOST_CHECK_CLOSE(calculate_energy()->accumulate(),
+                            reference_energy, tol);
+        }
+      };
+      mpi_call_all(mpi_set_always_threaded_pairs_local, true);
+      check_forces();
+      mpi_call_all(mpi_set_always_threaded_pairs_local, false);
+#ifdef OPENMP
+      mpi_set_n_threads(4);
+      check_forces();
+      mpi_set_n_threads(1);
+#endif // OPENMP
+    };
+    auto const n_compact_pairs = [] {
+      return mpi_call(Communication::Result::main_rank,
+                      mpi_get_n_compact_pairs_local);
+    };
+    // the central pair forces run on the structure-of-arrays copy
+    BOOST_REQUIRE_EQUAL(n_compact_pairs(), 0u);
+    check_threaded_forces();
+    BOOST_CHECK_GT(n_compact_pairs(), 0u);
+#if defined(ELECTROSTATICS) && !defined(P3M)
+    // the real-space electrostatics run in the threaded pair loop too
+    set_particle_q(pid1, 1.);
+    set_particle_q(pid2, -1.);
+    mpi_call_all(mpi_set_debye_hueckel_local, 2., 1.);
+    check_threaded_forces();
+    mpi_call_all(mpi_set_debye_hueckel_local, 0., 0.);
+    set_particle_q(pid1, 0.);
+    set_particle_q(pid2, 0.);
+#endif
+#ifdef EXCLUSIONS
+    // an exclusion between two particles out of range keeps the forces,
+    // but the pair loop runs on the verlet lists of the cells instead of
+    // the structure-of-arrays copy
+    add_particle_exclusion(pid1, pid3);
+    check_threaded_forces();
+    remove_particle_exclusion(pid1, pid3);
+#endif
+  }
+
+  // check bulk extraction of LB fluid fields
+  {
+    lb_lbfluid_set_lattice_switch(ActiveLB::CPU);
+    lb_lbfluid_set_agrid(1.);
+    lb_lbfluid_set_tau(0.01);
+    lb_lbfluid_set_density(0.5);
+    lb_lbfluid_set_viscosity(1.);
+
+    // set a different velocity on every node of every MPI domain
+    auto const grid_size = lb_lbfluid_get_shape();
+    Utils::Vector3i ind;
+    for (ind[0] = 0; ind[0] < grid_size[0]; ++ind[0])
+      for (ind[1] = 0; ind[1] < grid_size[1]; ++ind[1])
+        for (ind[2] = 0; ind[2] < grid_size[2]; ++ind[2])
+          lb_lbnode_set_velocity(
+              ind, {0.001 * ind[0], 0.002 * ind[1], -0.001 * ind[2]});
+
+    auto const node_values = [](LBField field, Utils::Vector3i const &ind) {
+      switch (field) {
+      case LBField::DENSITY:
+        return std::vector<double>{lb_lbnode_get_density(ind)};
+      case LBField::VELOCITY:
+        return lb_lbnode_get_velocity(ind).as_vector();
+      case LBField::PRESSURE_TENSOR:
+        return lb_lbnode_get_pressure_tensor(ind).as_vector();
+      case LBField::PRESSURE_TENSOR_NEQ:
+        return lb_lbnode_get_pressure_tensor_neq(ind).as_vector();
+      case LBField::POPULATIONS:
+        return lb_lbnode_get_pop(ind).as_vector();
+      default:
+        return std::vector<double>{
+            static_cast<double>(lb_lbnode_get_boundary(ind))};
+      }
+    };
+
+    auto const lower = Utils::Vector3i{{1, 2, 0}};
+    auto const upper = grid_size - Utils::Vector3i{{1, 0, 3}};
+    for (auto const field :
+         {LBField::DENSITY, LBField::VELOCITY, LBField::PRESSURE_TENSOR,
+          LBField::PRESSURE_TENSOR_NEQ, LBField::POPULATIONS,
+          LBField::BOUNDARY}) {
+      auto const slab = lb_lbfluid_get_slab(field, lower, upper);
+      BOOST_REQUIRE_EQUAL(slab.size(), Utils::product(upper - lower) *
+                                           lb_field_size(field));
+      // nodes are stored in row-major order
+      auto value = slab.begin();
+      for (ind[0] = lower[0]; ind[0] < upper[0]; ++ind[0])
+        for (ind[1] = lower[1]; ind[1] < upper[1]; ++ind[1])
+          for (ind[2] = lower[2]; ind[2] < upper[2]; ++ind[2])
+            for (auto const ref : node_values(field, ind))
+              BOOST_CHECK_EQUAL(*value++, ref);
+    }
+    auto const too_large = grid_size + Utils::Vector3i{{0, 1, 0}};
+    BOOST_CHECK_THROW(lb_lbfluid_get_slab(LBField::DENSITY, lower, too_large),
+                      std::runtime_error);
+    BOOST_CHECK_THROW(lb_lbfluid_get_slab(LBField::DENSITY, upper, lower),
+                      std::runtime_error);
+
+    // check parallel binary VTK output of every other node
+    {
+      namespace fs = boost::filesystem;
+      auto const path =
+          fs::temp_directory_path() / fs::unique_path("lb_fields_%%%%%%.vti");
+      auto const filename = path.string();
+      auto const stride = 2;
+      auto const lattice_speed = lb_lbfluid_get_lattice_speed();
+      auto const pressure_unit = 1. / (Utils::sqr(lb_lbfluid_get_tau()) *
+                                       lb_lbfluid_get_agrid());
+      lb_lbfluid_write_vtk(filename,
+                           {LBField::DENSITY, LBField::VELOCITY,
+                            LBField::PRESSURE_TENSOR},
+                           stride);
+      std::ifstream file(filename, std::ios::binary);
+      auto const contents = std::string(std::istreambuf_iterator<char>(file),
+                                        std::istreambuf_iterator<char>());
+      file.close();
+      fs::remove(path);
+      auto const marker = std::string("<AppendedData encoding=\"raw\">\n_");
+      auto const data_start = contents.find(marker);
+      BOOST_REQUIRE(data_start != std::string::npos);
+      auto data = contents.data() + data_start + marker.size();
+      auto const n_nodes =
+          Utils::product(grid_size) / Utils::int_pow<3>(stride);
+      auto const read_block = [&data](std::size_t n_values) {
+        std::uint64_t n_bytes;
+        std::memcpy(&n_bytes, data, sizeof(n_bytes));
+        data += sizeof(n_bytes);
+        BOOST_REQUIRE_EQUAL(n_bytes, n_values * sizeof(float));
+        std::vector<float> values(n_values);
+        std::memcpy(values.data(), data, n_bytes);
+        data += n_bytes;
+        return values;
+      };
+      auto const density = read_block(static_cast<std::size_t>(n_nodes));
+      auto const velocity = read_block(3u * static_cast<std::size_t>(n_nodes));
+      auto const pressure = read_block(6u * static_cast<std::size_t>(n_nodes));
+      // nodes are stored with the x index running fastest
+      std::size_t i = 0;
+      for (ind[2] = 0; ind[2] < grid_size[2]; ind[2] += stride)
+        for (ind[1] = 0; ind[1] < grid_size[1]; ind[1] += stride)
+          for (ind[0] = 0; ind[0] < grid_size[0]; ind[0] += stride, ++i) {
+            BOOST_CHECK_CLOSE(density[i], lb_lbnode_get_density(ind), 1e-4);
+            auto const v_ref = lb_lbnode_get_velocity(ind) * lattice_speed;
+            for (unsigned int j = 0; j < 3; ++j) {
+              BOOST_CHECK_CLOSE(velocity[3 * i + j], v_ref[j], 1e-4);
+            }
+            // the XY component follows the diagonal in the VTK order
+            auto const p_ref = lb_lbnode_get_pressure_tensor(ind);
+            BOOST_CHECK_CLOSE(pressure[6 * i + 0], p_ref[0] * pressure_unit,
+                              1e-4);
+            BOOST_CHECK_CLOSE(pressure[6 * i + 3], p_ref[1] * pressure_unit,
+                              1e-4);
+          }
+      BOOST_CHECK_EQUAL(i, static_cast<std::size_t>(n_nodes));
+    }
+
+    // the collide-and-stream kernels reproduce the reference kernel
+    {
+      lb_lbfluid_set_ext_force_density({0.001, -0.002, 0.0005});
+#ifdef LB_BOUNDARIES
+      mpi_call_all(mpi_add_lb_sphere_local,
+                   Utils::Vector3d::broadcast(box_center), 2.,
+                   Utils::Vector3d{0., 0.5, 0.});
+#endif
+      std::vector<Utils::Vector3d> boundary_forces;
+      auto const initial = lb_lbfluid_get_slab(LBField::POPULATIONS,
+                                               Utils::Vector3i{}, grid_size);
+      auto const run = [&](LBKernel kernel) {
+        auto it = initial.begin();
+        for (ind[0] = 0; ind[0] < grid_size[0]; ++ind[0])
+          for (ind[1] = 0; ind[1] < grid_size[1]; ++ind[1])
+            for (ind[2] = 0; ind[2] < grid_size[2]; ++ind[2], it += 19)
+              lb_lbnode_set_pop(ind, Utils::Vector19d(it, it + 19));
+        lb_lbfluid_set_kernel(kernel);
+        mpi_integrate(20, 0);
+#ifdef LB_BOUNDARIES
+        boundary_forces.emplace_back(
+            LBBoundaries::lbboundaries[0]->get_force());
+#endif
+        return lb_lbfluid_get_slab(LBField::POPULATIONS, Utils::Vector3i{},
+                                   grid_size);
+      };
+      auto const reference = run(LBKernel::REFERENCE);
+      auto const blocked = run(LBKernel::BLOCKED);
+      auto const in_place = run(LBKernel::IN_PLACE);
+      BOOST_CHECK(reference != initial);
+      BOOST_REQUIRE_EQUAL(blocked.size(), reference.size());
+      BOOST_REQUIRE_EQUAL(in_place.size(), reference.size());
+      for (std::size_t j = 0; j < reference.size(); ++j) {
+        BOOST_CHECK_EQUAL(blocked[j], reference[j]);
+        BOOST_CHECK_EQUAL(in_place[j], reference[j]);
+      }
+#ifdef LB_BOUNDARIES
+      BOOST_CHECK(boundary_forces[0] != Utils::Vector3d{});
+      BOOST_CHECK(boundary_forces[1] == boundary_forces[0]);
+      BOOST_CHECK(boundary_forces[2] == boundary_forces[0]);
+#endif
+      // leaving the in-place kernel keeps the populations
+      lb_lbfluid_set_kernel(LBKernel::REFERENCE);
+      BOOST_CHECK(lb_lbfluid_get_slab(LBField::POPULATIONS, Utils::Vector3i{},
+                                      grid_size) == in_place);
+#ifdef LB_BOUNDARIES
+      mpi_call_all(mpi_remove_lb_boundaries_local);
+#endif
+    }
+
+    lb_lbfluid_set_lattice_switch(ActiveLB::NONE);
   }
 }
 
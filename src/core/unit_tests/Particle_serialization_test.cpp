@@ -229,6 +229,9 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(
         "BondList",
 #ifdef EXCLUSIONS
         "Utils::compact_vector<int>",
+#endif
+#ifdef EXTERNAL_FORCES
+        "ParticleGLE",
 #endif
     };
     typename Checker::buffer_type buffer = {};
@@ -72,6 +72,11 @@ BOOST_AUTO_TEST_CASE(serialization) {
   std::vector<int> el = {5, 6, 7, 8};
   p.exclusions() = Utils::compact_vector<int>{el.begin(), el.end()};
 #endif
+#ifdef EXTERNAL_FORCES
+  p.gle().resize(2);
+  p.gle()[ParticleGLE::U_X][1] = 0.5;
+  p.gle()[ParticleGLE::U_ROT_Z][0] = -2.;
+#endif
 
   std::stringstream stream;
   boost::archive::text_oarchive out_ar(stream);
@@ -87,7 +92,59 @@ BOOST_AUTO_TEST_CASE(serialization) {
 #ifdef EXCLUSIONS
   BOOST_CHECK(q.exclusions_as_vector() == el);
 #endif
+#ifdef EXTERNAL_FORCES
+  BOOST_CHECK_EQUAL(q.Nm(), 2);
+  BOOST_CHECK_EQUAL(q.gle()[ParticleGLE::U_X][1], 0.5);
+  BOOST_CHECK_EQUAL(q.gle()[ParticleGLE::U_ROT_Z][0], -2.);
+#endif
+}
+
+#ifdef EXTERNAL_FORCES
+BOOST_AUTO_TEST_CASE(gle_modes) {
+  auto p = Particle();
+
+  // particles without Prony modes don't allocate any storage
+  BOOST_CHECK_EQUAL(p.Nm(), 0);
+  BOOST_CHECK(p.gle()[ParticleGLE::U_X].empty());
+  BOOST_CHECK(p.gle().state().empty());
+
+  // growing keeps the existing modes and zero-initializes the new ones
+  p.gle().resize(2);
+  for (unsigned f = 0u; f < ParticleGLE::N_FIELDS; ++f) {
+    auto const field = static_cast<ParticleGLE::Field>(f);
+    p.gle()[field][0] = 10. * f;
+    p.gle()[field][1] = 10. * f + 1.;
+  }
+  p.gle().resize(3);
+  BOOST_CHECK_EQUAL(p.Nm(), 3);
+  for (unsigned f = 0u; f < ParticleGLE::N_FIELDS; ++f) {
+    auto const field = static_cast<ParticleGLE::Field>(f);
+    auto const values = p.gle()[field];
+    auto const ref = std::vector<double>{10. * f, 10. * f + 1., 0.};
+    BOOST_TEST(std::vector<double>(values.begin(), values.end()) == ref,
+               boost::test_tools::per_element());
+  }
+
+  // the state is stored component-major
+  auto const state = p.gle().state();
+  BOOST_REQUIRE_EQUAL(state.size(), 3u * ParticleGLE::N_FIELDS);
+  BOOST_CHECK_EQUAL(state[3u * ParticleGLE::U_Y + 1u], 11.);
+  auto q = Particle();
+  q.gle().set_state(state);
+  BOOST_CHECK_EQUAL(q.Nm(), 3);
+  BOOST_CHECK_EQUAL(q.gle()[ParticleGLE::U_Y][1], 11.);
+
+  // shrinking truncates
+  p.gle().resize(1);
+  BOOST_CHECK_EQUAL(p.gle()[ParticleGLE::U_ROT_Z].size(), 1u);
+  BOOST_CHECK_EQUAL(p.gle()[ParticleGLE::U_ROT_Z][0],
+                    10. * ParticleGLE::U_ROT_Z);
+
+  // removing all modes frees the storage
+  p.gle().resize(0);
+  BOOST_CHECK_EQUAL(p.Nm(), 0);
 }
+#endif // EXTERNAL_FORCES
 
 namespace Utils {
 template <>
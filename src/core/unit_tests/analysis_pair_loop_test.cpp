@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE analysis pair loop test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+namespace bdata = boost::unit_test::data;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "Particle.hpp"
+#include "ParticleFactory.hpp"
+#include "analysis_pair_loop.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/sqr.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/mpi.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+using IdPair = std::pair<int, int>;
+
+static void mpi_set_cell_system_local(bool hybrid) {
+  if (hybrid) {
+    set_hybrid_decomposition(std::set<int>{1}, 1.);
+  } else {
+    cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+  }
+}
+
+REGISTER_CALLBACK(mpi_set_cell_system_local)
+
+static double mpi_get_cell_range_local() {
+  auto const max_range = cell_structure.max_range();
+  return boost::mpi::all_reduce(
+      comm_cart, *std::min_element(max_range.begin(), max_range.end()),
+      boost::mpi::minimum<double>());
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_get_cell_range_local)
+
+static bool mpi_cell_system_covers_local(double max_r) {
+  return Analysis::detail::cell_system_covers(comm_cart, max_r);
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_cell_system_covers_local)
+
+/** Pairs of particles of type 0 or 1 closer than @p max_r, visited by
+ *  the pair loop, with the smaller id first.
+ */
+static std::vector<IdPair> mpi_get_pairs_local(double max_r) {
+  std::vector<IdPair> pairs;
+  auto const select = [](Particle const &p) { return p.type() != 2; };
+  Analysis::analysis_pair_loop(
+      comm_cart, max_r, select,
+      [&pairs](Analysis::PairParticle const &p1,
+               Analysis::PairParticle const &p2, double dist2) {
+        auto const ref = box_geo.get_mi_vector(p1.pos, p2.pos).norm2();
+        if (dist2 == ref and p1.type != 2 and p2.type != 2) {
+          pairs.emplace_back(std::min(p1.id, p2.id), std::max(p1.id, p2.id));
+        }
+      });
+  Utils::Mpi::gather_buffer(pairs, comm_cart);
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_get_pairs_local)
+
+auto const node_grids = std::vector<Utils::Vector3i>{{4, 1, 1}, {2, 2, 1}};
+auto const hybrid_flags = std::vector<bool>{false, true};
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_DATA_TEST_CASE_F(ParticleFactory, pairs_match_brute_force,
+                       bdata::make(node_grids) * bdata::make(hybrid_flags),
+                       node_grid, hybrid) {
+  auto const box_l = 8.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_node_grid(node_grid);
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  mpi_call_all(mpi_set_cell_system_local, hybrid);
+
+  auto const n_part = 300;
+  std::vector<Utils::Vector3d> positions;
+  std::vector<int> types;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> uniform(0., box_l);
+  for (int pid = 0; pid < n_part; ++pid) {
+    positions.push_back({uniform(gen), uniform(gen), uniform(gen)});
+    types.push_back(pid % 3);
+    create_particle(positions.back(), pid, types.back());
+  }
+
+  auto const cell_range =
+      mpi_call(Communication::Result::main_rank, mpi_get_cell_range_local);
+  auto const radii = std::vector<double>{0.9 * cell_range, 2.5, 3.9};
+  for (auto const max_r : radii) {
+    if (max_r > box_l / 2.) {
+      continue;
+    }
+    auto const covers = mpi_call(Communication::Result::main_rank,
+                                 mpi_cell_system_covers_local, max_r);
+    // the hybrid decomposition always takes the analysis grid
+    BOOST_CHECK_EQUAL(covers, not hybrid and max_r <= cell_range);
+
+    std::vector<IdPair> ref;
+    for (int i = 0; i < n_part; ++i) {
+      for (int j = i + 1; j < n_part; ++j) {
+        auto const dist2 =
+            box_geo.get_mi_vector(positions[i], positions[j]).norm2();
+        if (types[i] != 2 and types[j] != 2 and dist2 <= Utils::sqr(max_r)) {
+          ref.emplace_back(i, j);
+        }
+      }
+    }
+    auto const pairs = mpi_call(Communication::Result::main_rank,
+                                mpi_get_pairs_local, max_r);
+    // every pair is visited exactly once
+    BOOST_REQUIRE(not ref.empty());
+    BOOST_CHECK(pairs == ref);
+  }
+
+  mpi_call_all(mpi_set_cell_system_local, false);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 4 MPI ranks
+  boost::mpi::communicator world;
+  int error_code = 0;
+  if (world.size() == 4) {
+    error_code = boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+  }
+  return error_code;
+}
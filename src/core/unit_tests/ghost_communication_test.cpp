@@ -0,0 +1,279 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ghost communication test
+
+#include "config.hpp"
+
+#ifdef LENNARD_JONES
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/data/monomorphic.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+namespace bdata = boost::unit_test::data;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "Particle.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "constraints.hpp"
+#include "constraints/ExternalField.hpp"
+#include "field_coupling/couplings/Direct.hpp"
+#include "field_coupling/fields/Constant.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+#include "thermostat.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/mpi/gather_buffer.hpp>
+
+#include <boost/mpi.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+using IdVector = std::pair<int, Utils::Vector3d>;
+
+static void mpi_set_ghost_protocol_local(bool nonblocking, bool verlet) {
+  cell_structure.nonblocking_ghosts = nonblocking;
+  cell_structure.use_verlet_list = verlet;
+}
+
+REGISTER_CALLBACK(mpi_set_ghost_protocol_local)
+
+using ConstantForce =
+    Constraints::ExternalField<FieldCoupling::Coupling::Direct,
+                               FieldCoupling::Fields::Constant<double, 3>>;
+
+static std::shared_ptr<ConstantForce> external_force;
+
+/** The constraint forces are added while the ghost forces are reduced. */
+static void mpi_set_external_force_local(Utils::Vector3d const &force) {
+  if (external_force) {
+    Constraints::constraints.remove(external_force);
+    external_force.reset();
+  }
+  if (force != Utils::Vector3d{}) {
+    external_force = std::make_shared<ConstantForce>(
+        FieldCoupling::Coupling::Direct{},
+        FieldCoupling::Fields::Constant<double, 3>{force});
+    Constraints::constraints.add(external_force);
+  }
+}
+
+REGISTER_CALLBACK(mpi_set_external_force_local)
+
+static void mpi_create_bond_local(int bond_id) {
+  auto const bond = std::make_shared<Bonded_IA_Parameters>(
+      HarmonicBond(10., 0.7, 0.));
+  bonded_ia_params.insert(bond_id, bond);
+}
+
+REGISTER_CALLBACK(mpi_create_bond_local)
+
+/** Positions or forces of the particles, sorted by id. */
+static std::vector<IdVector> mpi_get_particle_vectors_local(bool forces) {
+  std::vector<IdVector> values;
+  for (auto const &p : cell_structure.local_particles()) {
+    values.emplace_back(p.id(), forces ? p.force() : p.pos());
+  }
+  Utils::Mpi::gather_buffer(values, comm_cart);
+  std::sort(values.begin(), values.end(),
+            [](auto const &a, auto const &b) { return a.first < b.first; });
+  return values;
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_get_particle_vectors_local)
+
+static auto get_particle_vectors(bool forces) {
+  return mpi_call(Communication::Result::main_rank,
+                  mpi_get_particle_vectors_local, forces);
+}
+
+auto const node_grids =
+    std::vector<Utils::Vector3i>{{4, 1, 1}, {2, 2, 1}, {1, 2, 2}};
+auto const verlet_flags = std::vector<bool>{true, false};
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_DATA_TEST_CASE(nonblocking_matches_blocking,
+                     bdata::make(node_grids) * bdata::make(verlet_flags),
+                     node_grid, verlet) {
+  auto const box_l = 20.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_node_grid(node_grid);
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.2);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+
+  // the interaction range leaves interior cells on every node
+  auto const lj_cut = 1.4;
+  lennard_jones_set_params(0, 0, 1., 1.1, lj_cut, 0., 0., 0.);
+  auto const bond_id = 0;
+  mpi_call_all(mpi_create_bond_local, bond_id);
+  auto const field = Utils::Vector3d{0.3, 0.1, -0.7};
+  mpi_call_all(mpi_set_external_force_local, field);
+
+  // jittered lattice of type 0, every 5th site with a bonded type 2
+  // partner that does not interact otherwise
+  std::vector<Utils::Vector3d> positions;
+  std::vector<Utils::Vector3d> velocities;
+  std::vector<int> types;
+  std::vector<std::pair<int, int>> bonds;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> jitter(-0.2, 0.2);
+  std::uniform_real_distribution<double> velocity(-1., 1.);
+  auto const spacing = 1.5;
+  auto const n_sites = static_cast<int>(box_l / spacing);
+  for (int i = 0; i < n_sites; ++i) {
+    for (int j = 0; j < n_sites; ++j) {
+      for (int k = 0; k < n_sites; ++k) {
+        auto const site = spacing * Utils::Vector3d{i + 0.5, j + 0.5, k + 0.5};
+        auto const pid = static_cast<int>(positions.size());
+        positions.emplace_back(
+            site + Utils::Vector3d{jitter(gen), jitter(gen), jitter(gen)});
+        velocities.push_back({velocity(gen), velocity(gen), velocity(gen)});
+        types.push_back(0);
+        if (pid % 5 == 0) {
+          positions.emplace_back(positions.back() +
+                                 Utils::Vector3d{0.5, 0.4, 0.3});
+          velocities.push_back({velocity(gen), velocity(gen), velocity(gen)});
+          types.push_back(2);
+          bonds.emplace_back(pid, pid + 1);
+        }
+      }
+    }
+  }
+  auto const n_part = static_cast<int>(positions.size());
+
+  auto const run = [&](bool nonblocking) {
+    mpi_call_all(mpi_set_ghost_protocol_local, nonblocking, verlet);
+    for (int pid = 0; pid < n_part; ++pid) {
+      place_particle(pid, positions[pid]);
+      set_particle_type(pid, types[pid]);
+      set_particle_v(pid, velocities[pid]);
+    }
+    for (auto const &bond : bonds) {
+      add_particle_bond(bond.first, std::vector<int>{bond_id, bond.second});
+    }
+    mpi_integrate(20, 0);
+    auto result = std::make_pair(get_particle_vectors(false),
+                                 get_particle_vectors(true));
+    for (int pid = 0; pid < n_part; ++pid) {
+      remove_particle(pid);
+    }
+    return result;
+  };
+
+  auto const nonblocking = run(true);
+  auto const blocking = run(false);
+  mpi_call_all(mpi_set_ghost_protocol_local, true, true);
+
+  // same trajectory and forces bit for bit
+  BOOST_REQUIRE_EQUAL(nonblocking.first.size(), n_part);
+  BOOST_REQUIRE_EQUAL(blocking.first.size(), n_part);
+  auto n_differ = 0;
+  for (int pid = 0; pid < n_part; ++pid) {
+    if (nonblocking.first[pid].second != blocking.first[pid].second or
+        nonblocking.second[pid].second != blocking.second[pid].second) {
+      ++n_differ;
+    }
+  }
+  BOOST_CHECK_EQUAL(n_differ, 0);
+
+  // forces from all pairs, to check the split of the pair loop
+  auto const &pos = nonblocking.first;
+  std::vector<Utils::Vector3d> ref(n_part, field);
+  auto const &lj_00 = *get_ia_param(0, 0);
+  for (int i = 0; i < n_part; ++i) {
+    if (types[i] != 0) {
+      continue;
+    }
+    for (int j = i + 1; j < n_part; ++j) {
+      if (types[j] != 0) {
+        continue;
+      }
+      auto const d = box_geo.get_mi_vector(pos[i].second, pos[j].second);
+      auto const r = d.norm();
+      if (r < lj_cut) {
+        auto const f = lj_pair_force_factor(lj_00, r) * d;
+        ref[i] += f;
+        ref[j] -= f;
+      }
+    }
+  }
+  for (auto const &bond : bonds) {
+    auto const d = box_geo.get_mi_vector(pos[bond.first].second,
+                                         pos[bond.second].second);
+    auto const f = -10. * (d.norm() - 0.7) / d.norm() * d;
+    ref[bond.first] += f;
+    ref[bond.second] -= f;
+  }
+  for (int pid = 0; pid < n_part; ++pid) {
+    auto const &force = nonblocking.second[pid].second;
+    BOOST_CHECK_SMALL((force - ref[pid]).norm(), 1e-8 * (1. + ref[pid].norm()));
+  }
+
+  mpi_call_all(mpi_set_external_force_local, Utils::Vector3d{});
+  lennard_jones_set_params(0, 0, 0., 0., 0., 0., 0., 0.);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 4 MPI ranks
+  boost::mpi::communicator world;
+  int error_code = 0;
+  if (world.size() == 4) {
+    error_code = boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+  }
+  return error_code;
+}
+#else // ifdef LENNARD_JONES
+int main(int argc, char **argv) {}
+#endif
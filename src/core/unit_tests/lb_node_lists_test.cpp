@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE LB node lists test
+
+#include "config.hpp"
+
+#ifdef LB_BOUNDARIES
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "communication.hpp"
+#include "grid_based_algorithms/lb-d3q19.hpp"
+#include "grid_based_algorithms/lb.hpp"
+#include "grid_based_algorithms/lb_boundaries.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "grid_based_algorithms/lbboundaries/LBBoundary.hpp"
+#include "integrate.hpp"
+#include "thermostat.hpp"
+
+#include <shapes/Sphere.hpp>
+#include <shapes/Wall.hpp>
+
+#include <utils/Vector.hpp>
+#include <utils/index.hpp>
+
+#include <boost/mpi.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+/** Compare the node lists with a sweep over the whole local lattice, which
+ *  checks the boundary flags node by node.
+ */
+static bool mpi_node_lists_match_dense_sweep_local() {
+  auto const &grid = lblattice.grid;
+  auto const is_boundary = [](int x, int y, int z) {
+    auto const index = Utils::get_linear_index(x, y, z, lblattice.halo_grid);
+    return lbfields[index].boundary != 0;
+  };
+  auto const is_local = [&grid](int x, int y, int z) {
+    return x > 0 && x <= grid[0] && y > 0 && y <= grid[1] && z > 0 &&
+           z <= grid[2];
+  };
+
+  std::vector<Lattice::index_t> fluid_nodes;
+  for (int z = 1; z <= grid[2]; z++)
+    for (int y = 1; y <= grid[1]; y++)
+      for (int x = 1; x <= grid[0]; x++)
+        if (!is_boundary(x, y, z))
+          fluid_nodes.push_back(
+              Utils::get_linear_index(x, y, z, lblattice.halo_grid));
+  auto const &nodes = lb_get_fluid_nodes();
+  auto match = nodes.size() == fluid_nodes.size() &&
+               std::equal(nodes.begin(), nodes.end(), fluid_nodes.begin(),
+                          [](LBFluidNodeEntry const &node,
+                             Lattice::index_t index) {
+                            return node.index == index;
+                          });
+
+  std::vector<LBBoundaryLink> links;
+  for (int z = 0; z < grid[2] + 2; z++)
+    for (int y = 0; y < grid[1] + 2; y++)
+      for (int x = 0; x < grid[0] + 2; x++)
+        if (is_boundary(x, y, z))
+          for (int i = 0; i < 19; i++) {
+            auto const ci = D3Q19::c[i];
+            auto const nx = x - static_cast<int>(ci[0]);
+            auto const ny = y - static_cast<int>(ci[1]);
+            auto const nz = z - static_cast<int>(ci[2]);
+            if (is_local(nx, ny, nz))
+              links.push_back(
+                  {Utils::get_linear_index(x, y, z, lblattice.halo_grid), i,
+                   !is_boundary(nx, ny, nz)});
+          }
+  auto const &boundary_links = lb_get_boundary_links();
+  match = match && boundary_links.size() == links.size() &&
+          std::equal(boundary_links.begin(), boundary_links.end(),
+                     links.begin(),
+                     [](LBBoundaryLink const &a, LBBoundaryLink const &b) {
+                       return a.boundary == b.boundary &&
+                              a.velocity == b.velocity && a.fluid == b.fluid;
+                     });
+
+  return boost::mpi::all_reduce(comm_cart, match, std::logical_and<bool>());
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_node_lists_match_dense_sweep_local)
+
+static bool node_lists_match_dense_sweep() {
+  return mpi_call(Communication::Result::main_rank,
+                  mpi_node_lists_match_dense_sweep_local);
+}
+
+static void mpi_add_lb_boundary_local(std::shared_ptr<Shapes::Shape> shape,
+                                      Utils::Vector3d velocity) {
+  auto boundary = std::make_shared<LBBoundaries::LBBoundary>();
+  boundary->set_shape(shape);
+  boundary->set_velocity(velocity);
+  LBBoundaries::add(boundary);
+}
+
+static void mpi_add_lb_wall_local(Utils::Vector3d normal, double dist,
+                                  Utils::Vector3d velocity) {
+  auto wall = std::make_shared<Shapes::Wall>();
+  wall->set_normal(normal);
+  wall->d() = dist;
+  mpi_add_lb_boundary_local(wall, velocity);
+}
+
+REGISTER_CALLBACK(mpi_add_lb_wall_local)
+
+static void mpi_add_lb_sphere_local(Utils::Vector3d center, double radius,
+                                    Utils::Vector3d velocity) {
+  auto sphere = std::make_shared<Shapes::Sphere>();
+  sphere->pos() = center;
+  sphere->rad() = radius;
+  mpi_add_lb_boundary_local(sphere, velocity);
+}
+
+REGISTER_CALLBACK(mpi_add_lb_sphere_local)
+
+static void mpi_remove_lb_boundaries_local() {
+  while (!LBBoundaries::lbboundaries.empty()) {
+    LBBoundaries::remove(LBBoundaries::lbboundaries.back());
+  }
+}
+
+REGISTER_CALLBACK(mpi_remove_lb_boundaries_local)
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(node_lists) {
+  // split the channel walls between the ranks
+  auto const n_nodes = boost::mpi::communicator().size();
+  auto const node_grid = Utils::Vector3i{{(n_nodes == 4) ? 2 : 1,
+                                          (n_nodes >= 2) ? 2 : 1, 1}};
+  BOOST_REQUIRE_EQUAL(Utils::product(node_grid), n_nodes);
+  auto const box_l = 12.;
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_node_grid(node_grid);
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.5);
+  mpi_set_thermo_switch(THERMO_OFF);
+  integrate_set_nvt();
+
+  lb_lbfluid_set_lattice_switch(ActiveLB::CPU);
+  lb_lbfluid_set_agrid(1.);
+  lb_lbfluid_set_tau(0.01);
+  lb_lbfluid_set_density(0.5);
+  lb_lbfluid_set_viscosity(1.);
+  lb_lbfluid_set_ext_force_density({0.001, -0.0005, 0.002});
+
+  // square channel along z with a moving wall, 75% of the nodes are solid,
+  // and a moving obstacle in the channel
+  auto const v_wall = Utils::Vector3d{{0., 0., 0.5}};
+  mpi_call_all(mpi_add_lb_wall_local, Utils::Vector3d{{1., 0., 0.}}, 3.4,
+               Utils::Vector3d{});
+  mpi_call_all(mpi_add_lb_wall_local, Utils::Vector3d{{-1., 0., 0.}}, -8.6,
+               v_wall);
+  mpi_call_all(mpi_add_lb_wall_local, Utils::Vector3d{{0., 1., 0.}}, 3.4,
+               Utils::Vector3d{});
+  mpi_call_all(mpi_add_lb_wall_local, Utils::Vector3d{{0., -1., 0.}}, -8.6,
+               Utils::Vector3d{});
+  mpi_call_all(mpi_add_lb_sphere_local, Utils::Vector3d{{6.5, 5.5, 6.}}, 1.2,
+               Utils::Vector3d{{0.3, -0.2, 0.1}});
+
+  auto const lower = Utils::Vector3i{};
+  auto const upper = lb_lbfluid_get_shape();
+  auto const flags = lb_lbfluid_get_slab(LBField::BOUNDARY, lower, upper);
+  auto const n_solid = std::count_if(flags.begin(), flags.end(),
+                                     [](double flag) { return flag != 0.; });
+  BOOST_REQUIRE_GT(n_solid, 3 * static_cast<long>(flags.size()) / 4);
+
+  BOOST_CHECK(node_lists_match_dense_sweep());
+
+  auto const run = [&](LBKernel kernel) {
+    lb_lbfluid_set_kernel(kernel);
+    // reset the populations
+    lb_lbfluid_set_density(0.5);
+    mpi_integrate(50, 0);
+    auto const populations =
+        lb_lbfluid_get_slab(LBField::POPULATIONS, lower, upper);
+    std::vector<Utils::Vector3d> forces;
+    for (auto const &boundary : LBBoundaries::lbboundaries) {
+      forces.emplace_back(boundary->get_force());
+    }
+    return std::make_pair(populations, forces);
+  };
+
+  // all kernels visit the listed nodes and give the same populations and
+  // boundary forces bit for bit
+  auto const reference = run(LBKernel::REFERENCE);
+  BOOST_REQUIRE_EQUAL(reference.second.size(), 5u);
+  for (auto const &force : reference.second) {
+    BOOST_CHECK_GT(force.norm(), 0.);
+  }
+  for (auto const kernel : {LBKernel::BLOCKED, LBKernel::IN_PLACE}) {
+    auto const result = run(kernel);
+    BOOST_REQUIRE_EQUAL(result.first.size(), reference.first.size());
+    BOOST_CHECK(result.first == reference.first);
+    BOOST_REQUIRE_EQUAL(result.second.size(), reference.second.size());
+    for (std::size_t i = 0; i < result.second.size(); ++i) {
+      BOOST_CHECK(result.second[i] == reference.second[i]);
+    }
+  }
+  lb_lbfluid_set_kernel(LBKernel::REFERENCE);
+
+  // the lists follow changes of the boundaries
+  mpi_call_all(mpi_add_lb_sphere_local, Utils::Vector3d{{5.5, 6.5, 2.}}, 1.5,
+               Utils::Vector3d{});
+  BOOST_CHECK(node_lists_match_dense_sweep());
+  mpi_call_all(mpi_remove_lb_boundaries_local);
+  BOOST_CHECK(node_lists_match_dense_sweep());
+  BOOST_CHECK_EQUAL(lb_get_fluid_nodes().size(),
+                    static_cast<std::size_t>(Utils::product(
+                        lblattice.grid)));
+
+  lb_lbfluid_set_lattice_switch(ActiveLB::NONE);
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+#else // ifdef LB_BOUNDARIES
+int main(int argc, char **argv) {}
+#endif
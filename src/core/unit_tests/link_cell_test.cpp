@@ -26,6 +26,9 @@
 #include "Particle.hpp"
 #include "cell_system/Cell.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -72,3 +75,53 @@ BOOST_AUTO_TEST_CASE(link_cell) {
       ++it;
     }
 }
+
+BOOST_AUTO_TEST_CASE(color_cells) {
+  /* periodic 6x6x6 grid with a half shell of 13 red neighbors */
+  auto const n = 6;
+  auto const index = [n](int i, int j, int k) {
+    return ((i + n) % n) * n * n + ((j + n) % n) * n + ((k + n) % n);
+  };
+  std::vector<Cell> cells(n * n * n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      for (int k = 0; k < n; k++) {
+        std::vector<Cell *> red;
+        for (int di = -1; di <= 1; di++)
+          for (int dj = -1; dj <= 1; dj++)
+            for (int dk = -1; dk <= 1; dk++) {
+              auto const offset = 9 * di + 3 * dj + dk;
+              if (offset > 0)
+                red.push_back(&cells[index(i + di, j + dj, k + dk)]);
+            }
+        cells[index(i, j, k)].m_neighbors = Neighbors<Cell *>(red, {});
+      }
+
+  auto const colors = Algorithm::color_cells(cells.begin(), cells.end());
+  BOOST_CHECK_GT(colors.size(), 1);
+  BOOST_CHECK_LT(colors.size(), cells.size());
+
+  /* every cell has exactly one color */
+  std::vector<int> counts(cells.size(), 0);
+  for (auto const &color : colors) {
+    for (auto const i : color) {
+      counts[i]++;
+    }
+  }
+  BOOST_CHECK(
+      std::all_of(counts.begin(), counts.end(), [](int c) { return c == 1; }));
+
+  /* footprints of cells of the same color are disjoint */
+  for (auto const &color : colors) {
+    std::set<Cell const *> visited;
+    for (auto const i : color) {
+      BOOST_CHECK(visited.insert(&cells[i]).second);
+      for (auto const neighbor : cells[i].neighbors().red()) {
+        BOOST_CHECK(visited.insert(neighbor).second);
+      }
+    }
+  }
+
+  /* the coloring is deterministic */
+  BOOST_CHECK(Algorithm::color_cells(cells.begin(), cells.end()) == colors);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE P3M charge assignment test
+
+#include "config.hpp"
+
+#ifdef P3M
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#include <boost/test/unit_test.hpp>
+namespace utf = boost::unit_test;
+
+#include "EspressoSystemStandAlone.hpp"
+#include "MpiCallbacks.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "electrostatics/p3m.hpp"
+#include "electrostatics/registration.hpp"
+#include "integrate.hpp"
+#include "particle_data.hpp"
+#include "particle_node.hpp"
+#include "threads.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+#include <boost/mpi/collectives/all_reduce.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+/** Decorator to run a unit test only on the head node. */
+struct if_head_node {
+  boost::test_tools::assertion_result operator()(utf::test_unit_id) {
+    return world.rank() == 0;
+  }
+
+private:
+  boost::mpi::communicator world;
+};
+
+namespace {
+std::shared_ptr<CoulombP3M> p3m_solver;
+} // namespace
+
+static void mpi_add_p3m_local(int cao) {
+  auto p3m = P3MParameters{false,
+                           0.0,
+                           2.,
+                           Utils::Vector3i{{16, 12, 20}},
+                           Utils::Vector3d::broadcast(0.5),
+                           cao,
+                           1.2,
+                           1e-3};
+  p3m_solver = std::make_shared<CoulombP3M>(std::move(p3m), 1., 1, false);
+  ::Coulomb::add_actor(p3m_solver);
+}
+
+REGISTER_CALLBACK(mpi_add_p3m_local)
+
+static void mpi_remove_p3m_local() {
+  ::Coulomb::remove_actor(p3m_solver);
+  p3m_solver.reset();
+}
+
+REGISTER_CALLBACK(mpi_remove_p3m_local)
+
+/** Assign the local charges with the batched assignment and one particle
+ *  at a time, and return the largest difference between the two meshes
+ *  and the sum of the absolute mesh values over all ranks.
+ */
+static std::pair<double, double> mpi_charge_assignment_deviation_local() {
+  auto &p3m = p3m_solver->p3m;
+  auto const particles = cell_structure.local_particles();
+  auto const mesh_size = static_cast<std::size_t>(p3m.local_mesh.size);
+
+  p3m_solver->charge_assign(particles);
+  auto const batched = std::vector<double>(
+      p3m.rs_mesh.begin(), p3m.rs_mesh.begin() + mesh_size);
+
+  std::fill_n(p3m.rs_mesh.begin(), mesh_size, 0.);
+  for (auto const &p : particles) {
+    if (p.q() != 0.0) {
+      p3m_solver->assign_charge(p.q(), p.pos());
+    }
+  }
+
+  auto deviation = 0.;
+  auto norm = 0.;
+  for (std::size_t i = 0; i < mesh_size; ++i) {
+    deviation = std::max(deviation, std::abs(batched[i] - p3m.rs_mesh[i]));
+    norm += std::abs(batched[i]);
+  }
+  return {boost::mpi::all_reduce(comm_cart, deviation,
+                                 boost::mpi::maximum<double>()),
+          boost::mpi::all_reduce(comm_cart, norm, std::plus<double>())};
+}
+
+REGISTER_CALLBACK_MAIN_RANK(mpi_charge_assignment_deviation_local)
+
+static auto charge_assignment_deviation() {
+  return mpi_call(Communication::Result::main_rank,
+                  mpi_charge_assignment_deviation_local);
+}
+
+BOOST_TEST_DECORATOR(*utf::precondition(if_head_node()))
+BOOST_AUTO_TEST_CASE(batched_charge_assignment) {
+  auto const n_nodes = boost::mpi::communicator().size();
+  auto const node_grid = Utils::Vector3i{{(n_nodes >= 2) ? 2 : 1,
+                                          (n_nodes == 4) ? 2 : 1, 1}};
+  BOOST_REQUIRE_EQUAL(Utils::product(node_grid), n_nodes);
+  auto const box_l = Utils::Vector3d{{8., 6., 10.}};
+  espresso::system->set_box_l(box_l);
+  espresso::system->set_node_grid(node_grid);
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+
+  // particles on, just below and just above the mesh planes and the
+  // midplanes along x, which puts particles next to every slab and
+  // thus next to the boundaries of the per-thread patches, and on the
+  // faces of the local boxes along y and z
+  auto const h = 0.5;
+  auto const eps = 1e-9;
+  std::vector<double> x_values;
+  for (int i = 0; i < 16; ++i) {
+    for (auto const offset : {0., 0.5 * h}) {
+      for (auto const shift : {0., eps, h - eps}) {
+        x_values.emplace_back(i * h + offset + shift);
+      }
+    }
+  }
+  auto const y_values = std::vector<double>{
+      {0., eps, 0.5 * box_l[1] - eps, 0.5 * box_l[1], box_l[1] - eps, 1.7}};
+  auto const z_values = std::vector<double>{
+      {0., eps, 0.5 * box_l[2] - eps, 0.5 * box_l[2], box_l[2] - eps}};
+  auto pid = 0;
+  for (auto const x : x_values) {
+    auto const y = y_values[pid % y_values.size()];
+    auto const z = z_values[(pid / y_values.size()) % z_values.size()];
+    place_particle(pid, Utils::Vector3d{{std::fmod(x, box_l[0]), y, z}});
+    set_particle_q(pid, ((pid % 2) ? -1. : 1.) * (1. + 0.01 * (pid / 2 % 13)));
+    ++pid;
+  }
+
+#ifdef OPENMP
+  auto const thread_counts = std::vector<int>{{1, 2, 3, 4}};
+#else
+  auto const thread_counts = std::vector<int>{{1}};
+#endif
+
+  for (int cao = 1; cao <= 7; ++cao) {
+    mpi_call_all(mpi_add_p3m_local, cao);
+    mpi_integrate(0, 0);
+    for (auto const n_threads : thread_counts) {
+      BOOST_TEST_CONTEXT("cao = " << cao << ", " << n_threads << " threads") {
+        mpi_set_n_threads(n_threads);
+        auto const result = charge_assignment_deviation();
+        BOOST_CHECK_GT(result.second, 1.);
+        BOOST_CHECK_LE(result.first, 1e-14);
+      }
+    }
+    mpi_set_n_threads(1);
+    mpi_call_all(mpi_remove_p3m_local);
+  }
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
+#else // ifdef P3M
+int main(int argc, char **argv) {}
+#endif
@@ -29,9 +29,11 @@
 #include "random_test.hpp"
 #include "thermostat.hpp"
 #include "thermostats/brownian_inline.hpp"
+#include "thermostats/gle_inline.hpp"
 #include "thermostats/langevin_inline.hpp"
 #include "thermostats/npt_inline.hpp"
 
+#include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
 #include <array>
@@ -39,6 +41,8 @@
 #include <cstddef>
 #include <limits>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 // multiply by 100 because BOOST_CHECK_CLOSE takes a percentage tolerance,
 // and by 8 to account for error accumulation in thermostat functions
@@ -312,6 +316,228 @@ BOOST_AUTO_TEST_CASE(test_langevin_randomness) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_gle_randomness) {
+  constexpr std::size_t const sample_size = 10'000;
+  GLEThermostat thermostat{};
+  thermostat.rng_initialize(0);
+  auto p1 = particle_factory();
+  auto p2 = particle_factory();
+  p1.id() = 0;
+  p2.id() = 1;
+#ifdef ROTATION
+  constexpr std::size_t N = 4;
+#else
+  constexpr std::size_t N = 3;
+#endif
+
+  /* check the noise only depends on the counter, particle id and mode */
+  {
+    auto const ref = Random::noise_gaussian<RNGSalt::GLE>(0, 0, 1, 2);
+    auto const out = gle_noise(thermostat, p2, 2);
+    BOOST_CHECK_EQUAL(out[0], ref[0]);
+    BOOST_CHECK_EQUAL(out[1], ref[1]);
+    BOOST_CHECK_EQUAL(out[2], ref[2]);
+  }
+
+  /* check the noise is uncorrelated between particles and modes */
+  auto const correlation = std::get<3>(noise_statistics(
+      [&p1, &p2, &thermostat]() -> std::array<VariantVectorXd, N> {
+        thermostat.rng_increment();
+        return {{
+            gle_noise(thermostat, p1, 0),
+            gle_noise(thermostat, p1, 1),
+            gle_noise(thermostat, p2, 0),
+#ifdef ROTATION
+            gle_noise_rotation(thermostat, p1, 0),
+#endif
+        }};
+      },
+      sample_size));
+  for (std::size_t i = 0; i < correlation.size(); ++i) {
+    for (std::size_t j = i + 1; j < correlation.size(); ++j) {
+      BOOST_CHECK(correlation_almost_equal(correlation, i, j, 0.0, 3e-2));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_gle_kernel) {
+  constexpr double time_step = 0.1;
+  constexpr double kT = 2.0;
+  auto const tol_gle = 1e-12;
+  GLEThermostat thermostat{};
+  GLEKernel kernel{};
+  GLEMode mode{};
+  mode.gamma = 4.0;
+  mode.tau = 0.5;
+  mode.vcrit = 2.0;
+  mode.gamma_rot = 8.0;
+  mode.omegacrit = 0.5;
+  kernel.modes = {mode, mode};
+  kernel.gamma_vec = {1.0, 4.0, 0.25};
+  thermostat.kernels.resize(3);
+  thermostat.kernels[2] = kernel;
+  thermostat.recalc_prefactors(kT, time_step);
+
+  /* types without Prony modes have no kernel */
+  BOOST_CHECK(thermostat.kernel(-1) == nullptr);
+  BOOST_CHECK(thermostat.kernel(0) == nullptr);
+  BOOST_CHECK(thermostat.kernel(3) == nullptr);
+  BOOST_REQUIRE(thermostat.kernel(2) != nullptr);
+
+  auto const &out = *thermostat.kernel(2);
+  BOOST_CHECK_EQUAL(out.n_modes(), 2);
+  BOOST_CHECK_CLOSE(out.modes[1].nu, 2.0, tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[1].decay, 0.8, tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[1].inv_vcrit_b, 0.25, tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[1].inv_omegacrit_b, 4.0, tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[1].pref_noise, std::sqrt(0.1), tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[1].pref_noise_rot, std::sqrt(0.05), tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[1].drift, time_step, tol_gle);
+  BOOST_CHECK_CLOSE(out.inv_sqrt_gamma_vec[1], 0.5, tol_gle);
+  BOOST_CHECK_CLOSE(out.inv_sqrt_gamma_vec[2], 2.0, tol_gle);
+
+  /* exact propagator of the Ornstein-Uhlenbeck process */
+  thermostat.exact_propagator = true;
+  thermostat.recalc_prefactors(kT, time_step);
+  auto const decay = std::exp(-0.2);
+  BOOST_CHECK_CLOSE(out.modes[0].decay, decay, tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[0].drift, 0.5 * (1. - decay), tol_gle);
+  BOOST_CHECK_CLOSE(out.modes[0].pref_noise,
+                    std::sqrt(kT * 0.5 * (1. - decay * decay) / 4.), tol_gle);
+  /* it reduces to the Euler scheme for small time steps */
+  thermostat.recalc_prefactors(kT, 1e-7);
+  BOOST_CHECK_CLOSE(out.modes[0].decay, 1. - 2e-7, 1e-9);
+  BOOST_CHECK_CLOSE(out.modes[0].drift, 1e-7, 1e-4);
+  BOOST_CHECK_CLOSE(out.modes[0].pref_noise, std::sqrt(2. * kT * 1e-7 / 4.),
+                    1e-4);
+}
+
+BOOST_AUTO_TEST_CASE(test_gle_shear_factors) {
+  auto const tol_gle = 1e-10;
+  /* integer, half-integer and generic exponents */
+  for (double const x : {0., 0.3, 1., 2.5, 40.}) {
+    for (double const e : {0., 0.5, 1., 1.5, 2., 3., 7.5, 0.37, 2.2}) {
+      BOOST_CHECK_CLOSE(GLEExponent(e)(x), std::pow(x, e), tol_gle);
+    }
+  }
+  BOOST_CHECK_CLOSE(GLEExponent(-0.5)(4.), 0.5, tol_gle);
+  BOOST_CHECK(GLEExponent(3.5).is_fast());
+  BOOST_CHECK(not GLEExponent(0.37).is_fast());
+  BOOST_CHECK(not GLEExponent(-1.).is_fast());
+
+  auto const reference = [](double v2, double vcrit, double aexp,
+                            double bexp) {
+    return std::pow(1. + std::pow(v2 / (vcrit * vcrit), bexp / 2.), aexp);
+  };
+  auto const check_kernel = [&reference, tol_gle](std::vector<GLEMode> modes) {
+    GLEKernel kernel{};
+    kernel.modes = std::move(modes);
+    kernel.recalc_prefactors(1., 0.01, false);
+    std::vector<double> factors(kernel.modes.size());
+    for (double const v2 : {0., 0.2, 3., 50.}) {
+      gle_shear_factors(kernel, v2, false, Utils::make_span(factors));
+      for (std::size_t k = 0; k < factors.size(); ++k) {
+        auto const &m = kernel.modes[k];
+        BOOST_CHECK_CLOSE(factors[k], reference(v2, m.vcrit, m.aexp, m.bexp),
+                          tol_gle);
+      }
+      gle_shear_factors(kernel, v2, true, Utils::make_span(factors));
+      for (std::size_t k = 0; k < factors.size(); ++k) {
+        auto const &m = kernel.modes[k];
+        BOOST_CHECK_CLOSE(factors[k],
+                          reference(v2, m.omegacrit, m.aexp, m.bexp), tol_gle);
+      }
+    }
+    return kernel;
+  };
+  auto const make_mode = [](double vcrit, double aexp, double bexp) {
+    GLEMode mode{};
+    mode.gamma = 1.;
+    mode.gamma_rot = 1.;
+    mode.vcrit = vcrit;
+    mode.omegacrit = 2. * vcrit;
+    mode.aexp = aexp;
+    mode.bexp = bexp;
+    return mode;
+  };
+  /* linear kernel */
+  auto const linear =
+      check_kernel({make_mode(1., 0., 2.), make_mode(2., 0., 3.)});
+  BOOST_CHECK(linear.linear);
+  /* shared exponent b, integer and half-integer exponents */
+  auto const shared = check_kernel(
+      {make_mode(0.5, 1., 2.), make_mode(2., 0.5, 2.), make_mode(3., 2., 2.)});
+  BOOST_CHECK(not shared.linear);
+  BOOST_CHECK(shared.shared_bexp);
+  /* mixed generic exponents */
+  auto const mixed = check_kernel({make_mode(0.5, 0.37, 1.3),
+                                   make_mode(2., 1., 2.), make_mode(3., 0., 5.)});
+  BOOST_CHECK(not mixed.shared_bexp);
+}
+
+BOOST_AUTO_TEST_CASE(test_gle_stationary_variance) {
+  /* the exact propagator keeps the stationary variance kT tau / gamma of
+   * the auxiliary variables of a particle at rest, for any time step */
+  constexpr double kT = 2.0;
+  constexpr double time_step = 5.0;
+  constexpr std::size_t const sample_size = 100'000;
+  GLEThermostat thermostat{};
+  thermostat.rng_initialize(42);
+  thermostat.exact_propagator = true;
+  GLEMode mode{};
+  mode.gamma = 4.0;
+  mode.tau = 0.5;
+  mode.gamma_rot = 4.0;
+  thermostat.kernels.resize(1);
+  thermostat.kernels[0].modes = {mode};
+  thermostat.recalc_prefactors(kT, time_step);
+  auto const &m = thermostat.kernels[0].modes[0];
+  auto p = particle_factory();
+  double u = 0.;
+  double sum2 = 0.;
+  for (std::size_t i = 0; i < sample_size; ++i) {
+    thermostat.rng_increment();
+    u = m.decay * u - m.pref_noise * gle_noise(thermostat, p, 0)[0];
+    sum2 += u * u;
+  }
+  BOOST_CHECK_CLOSE(sum2 / sample_size, kT * mode.tau / mode.gamma, 2.);
+}
+
+#ifdef EXTERNAL_FORCES
+BOOST_AUTO_TEST_CASE(test_gle_dynamics) {
+  /* without noise, the explicit scheme gives u^1 = -dt v and
+   * u^2 = (1 - dt/tau) u^1 - dt v, and the force is gamma/tau u */
+  constexpr double time_step = 0.1;
+  GLEThermostat thermostat{};
+  thermostat.rng_initialize(0);
+  GLEMode mode{};
+  mode.gamma = 4.0;
+  mode.tau = 0.5;
+  GLEKernel kernel{};
+  kernel.modes = {mode, mode};
+  kernel.recalc_prefactors(0., time_step, false);
+  auto p = particle_factory();
+  p.v() = {1.0, 2.0, 3.0};
+  std::vector<double> factors;
+  BOOST_CHECK_EQUAL(p.gle().n_modes(), 0);
+  auto const f1 = friction_thermo_gle(thermostat, kernel, p, factors);
+  BOOST_CHECK_EQUAL(p.gle().n_modes(), 2);
+  BOOST_CHECK_EQUAL(factors.size(), 2);
+  auto const f2 = friction_thermo_gle(thermostat, kernel, p, factors);
+  for (int j = 0; j < 3; j++) {
+    auto const u1 = -time_step * p.v()[j];
+    auto const u2 = (1. - time_step / mode.tau) * u1 - time_step * p.v()[j];
+    BOOST_CHECK_CLOSE(f1.f[j], 2. * mode.gamma / mode.tau * u1, tol);
+    BOOST_CHECK_CLOSE(f2.f[j], 2. * mode.gamma / mode.tau * u2, tol);
+    BOOST_CHECK_CLOSE(p.gle()[static_cast<ParticleGLE::Field>(j)][1], u2, tol);
+  }
+#ifdef ROTATION
+  /* particles that cannot rotate have no viscoelastic torque */
+  BOOST_CHECK_EQUAL(f2.torque.norm2(), 0.);
+#endif
+}
+#endif // EXTERNAL_FORCES
+
 #ifdef NPT
 BOOST_AUTO_TEST_CASE(test_npt_iso_randomness) {
   extern int thermo_switch;
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE threads test
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config.hpp"
+
+#include "Particle.hpp"
+#include "ParticleRange.hpp"
+#include "cell_system/Cell.hpp"
+#include "communication.hpp"
+#include "threads.hpp"
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#ifdef OPENMP
+#include <omp.h>
+#endif
+
+/** Cells with particles, every third cell stays empty. */
+struct CellFixture {
+  int const n_part = 1234;
+  std::vector<Cell> storage;
+  std::vector<Cell *> cells;
+
+  CellFixture() : storage(100) {
+    for (auto &cell : storage) {
+      cells.push_back(&cell);
+    }
+    for (int i = 0; i < n_part; i++) {
+      Particle p;
+      p.id() = i;
+      auto const c = (i % 2 == 0) ? 3 * (i % 33) + 1 : 3 * (i % 33) + 2;
+      storage[c].particles().insert(std::move(p));
+    }
+  }
+
+  ParticleRange particles() {
+    auto const first = cells.data() + 1;
+    auto const last = cells.data() + cells.size();
+    return {CellParticleIterator(first, last), CellParticleIterator(last)};
+  }
+
+  /** Visit every particle once, and check that it was visited once. */
+  void check_for_each_particle() {
+    auto const range = particles();
+    for_each_particle(range, [](Particle &p) { p.v()[0] += 1.; });
+    std::vector<int> counts(n_part, 0);
+    for (auto const &p : range) {
+      BOOST_CHECK_EQUAL(p.v()[0], 1.);
+      counts[p.id()]++;
+    }
+    BOOST_CHECK(std::all_of(counts.begin(), counts.end(),
+                            [](int i) { return i == 1; }));
+  }
+};
+
+BOOST_AUTO_TEST_CASE(default_n_threads) {
+  BOOST_CHECK_EQUAL(get_n_threads(), 1);
+  BOOST_CHECK_THROW(mpi_set_n_threads(0), std::domain_error);
+#ifndef OPENMP
+  BOOST_CHECK_THROW(mpi_set_n_threads(2), std::runtime_error);
+#endif
+  BOOST_CHECK_EQUAL(get_n_threads(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(for_each_particle_completeness, CellFixture) {
+  auto const range = particles();
+  BOOST_REQUIRE_EQUAL(range.size(), n_part);
+  BOOST_CHECK(range.begin().cell() == cells.data() + 1);
+  BOOST_CHECK(range.end().cell() == cells.data() + cells.size());
+
+  /* every particle is visited exactly once */
+  check_for_each_particle();
+
+  /* empty ranges */
+  auto const last = cells.data() + cells.size();
+  for_each_particle(last, last,
+                    [](Particle &) { BOOST_ERROR("unexpected particle"); });
+}
+
+#ifdef OPENMP
+BOOST_FIXTURE_TEST_CASE(several_threads, CellFixture) {
+  auto const n_threads = 4;
+  mpi_set_n_threads(n_threads);
+  BOOST_REQUIRE_EQUAL(get_n_threads(), n_threads);
+
+  /* every index is visited exactly once, by several threads */
+  {
+    auto const n = std::size_t{1000};
+    std::vector<int> thread_ids(n, -1);
+    std::atomic<std::size_t> n_calls{0};
+    parallel_for(n, [&](std::size_t i) {
+      thread_ids[i] = omp_get_thread_num();
+      ++n_calls;
+    });
+    BOOST_CHECK_EQUAL(n_calls.load(), n);
+    BOOST_CHECK(std::none_of(thread_ids.begin(), thread_ids.end(),
+                             [](int id) { return id < 0; }));
+    auto const used = std::set<int>(thread_ids.begin(), thread_ids.end());
+    BOOST_CHECK_GT(used.size(), 1u);
+    BOOST_CHECK_LE(used.size(), static_cast<std::size_t>(n_threads));
+  }
+
+  /* every particle is visited exactly once, cells are not split */
+  {
+    std::atomic<int> n_calls{0};
+    for_each_particle(particles(), [&n_calls](Particle &p) {
+      p.v()[1] = omp_get_thread_num();
+      ++n_calls;
+    });
+    BOOST_CHECK_EQUAL(n_calls.load(), n_part);
+    std::set<int> used;
+    for (auto const &cell : storage) {
+      auto const &cell_particles = cell.particles();
+      for (auto const &p : cell_particles) {
+        BOOST_CHECK_EQUAL(p.v()[1], cell_particles.begin()->v()[1]);
+        used.insert(static_cast<int>(p.v()[1]));
+      }
+    }
+    BOOST_CHECK_GT(used.size(), 1u);
+    check_for_each_particle();
+  }
+
+  mpi_set_n_threads(1);
+  BOOST_CHECK_EQUAL(get_n_threads(), 1);
+}
+#endif // OPENMP
+
+int main(int argc, char **argv) {
+  auto mpi_env = std::make_shared<boost::mpi::environment>(argc, argv);
+  Communication::init(mpi_env);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
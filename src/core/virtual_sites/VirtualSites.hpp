@@ -50,6 +50,8 @@ public:
   virtual void update() const {}
   /** Back-transfer forces (and torques) to non-virtual particles. */
   virtual void back_transfer_forces_and_torques() const {}
+  /** Whether @ref back_transfer_forces_and_torques modifies forces. */
+  virtual bool back_transfers_forces() const { return false; }
   /** @brief Called after force calculation (and before rattle/shake) */
   virtual void after_force_calc() {}
   virtual void after_lb_propagation(double) {}
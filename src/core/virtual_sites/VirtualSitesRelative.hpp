@@ -36,6 +36,8 @@ public:
   void update() const override;
   /** @copydoc VirtualSites::back_transfer_forces_and_torques */
   void back_transfer_forces_and_torques() const override;
+  /** @copydoc VirtualSites::back_transfers_forces */
+  bool back_transfers_forces() const override { return true; }
   /** @copydoc VirtualSites::pressure_tensor */
   Utils::Matrix<double, 3, 3> pressure_tensor() const override;
 };
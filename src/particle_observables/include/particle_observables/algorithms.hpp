@@ -56,35 +56,58 @@ template <class ValueOp, class WeightOp> struct WeightedSum {
 };
 } // namespace detail
 
+/**
+ * The reductions @ref WeightedSum, @ref Sum, @ref WeightedAverage and
+ * @ref Average can also be evaluated piecewise, on disjoint subsets of
+ * the particles: @c partial() gives the contribution of a subset,
+ * contributions are added with @ref PartialSum, and @c finalize() turns
+ * the total into the result for the union of the subsets.
+ */
+struct PartialSum {
+  template <class T, class U>
+  std::pair<T, U> operator()(std::pair<T, U> const &a,
+                             std::pair<T, U> const &b) const {
+    return {a.first + b.first, a.second + b.second};
+  }
+};
+
 template <class ValueOp, class WeightOp> struct WeightedSum {
   template <class ParticleRange>
-  auto operator()(ParticleRange const &particles) const {
-    return detail::WeightedSum<ValueOp, WeightOp>()(particles).first;
+  auto partial(ParticleRange const &particles) const {
+    return detail::WeightedSum<ValueOp, WeightOp>()(particles);
+  }
+
+  template <class Partial> static auto finalize(Partial const &ws) {
+    return ws.first;
   }
-};
 
-template <class ValueOp> struct Sum {
   template <class ParticleRange>
   auto operator()(ParticleRange const &particles) const {
-    return detail::WeightedSum<ValueOp, detail::One>()(particles).first;
+    return finalize(partial(particles));
   }
 };
 
+template <class ValueOp> struct Sum : WeightedSum<ValueOp, detail::One> {};
+
 template <class ValueOp, class WeightOp> struct WeightedAverage {
   template <class ParticleRange>
-  auto operator()(ParticleRange const &particles) const {
-    auto const ws = detail::WeightedSum<ValueOp, WeightOp>()(particles);
+  auto partial(ParticleRange const &particles) const {
+    return detail::WeightedSum<ValueOp, WeightOp>()(particles);
+  }
+
+  template <class Partial> static auto finalize(Partial const &ws) {
     return (ws.second) ? ws.first / ws.second : ws.first;
   }
-};
 
-template <class ValueOp> struct Average {
   template <class ParticleRange>
   auto operator()(ParticleRange const &particles) const {
-    return WeightedAverage<ValueOp, detail::One>()(particles);
+    return finalize(partial(particles));
   }
 };
 
+template <class ValueOp>
+struct Average : WeightedAverage<ValueOp, detail::One> {};
+
 template <class ValueOp> struct Map {
   template <class ParticleRange>
   auto operator()(ParticleRange const &particles) const {
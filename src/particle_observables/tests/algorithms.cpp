@@ -98,3 +98,18 @@ BOOST_AUTO_TEST_CASE(algorithms_double) {
     BOOST_TEST(res == values);
   }
 }
+
+BOOST_AUTO_TEST_CASE(algorithms_partial) {
+  std::vector<double> const values{1., 2., 3., 4.};
+  std::vector<double> const head(values.begin(), values.begin() + 1);
+  std::vector<double> const tail(values.begin() + 1, values.end());
+  auto const check = [&](auto const &algorithm) {
+    auto const total =
+        PartialSum{}(algorithm.partial(head), algorithm.partial(tail));
+    BOOST_CHECK_EQUAL(algorithm.finalize(total), algorithm(values));
+  };
+  check(WeightedAverage<Testing::Identity, Testing::PlusOne>{});
+  check(WeightedSum<Testing::Identity, Testing::PlusOne>{});
+  check(Average<Testing::Identity>{});
+  check(Sum<Testing::Identity>{});
+}
@@ -70,9 +70,9 @@ cdef extern from "Observable_stat.hpp":
         size_t get_chunk_size()
 
 cdef extern from "statistics.hpp":
-    cdef void calc_structurefactor(PartCfg & , const vector[int] & p_types, int order, vector[double] & wavevectors, vector[double] & intensities) except +
-    cdef double mindist(PartCfg & , const vector[int] & set1, const vector[int] & set2)
-    cdef vector[int] nbhood(PartCfg & , const Vector3d & pos, double dist)
+    cdef void calc_structurefactor(const vector[int] & p_types, int order, cbool use_fft, vector[double] & wavevectors, vector[double] & intensities) except +
+    cdef double mindist(const vector[int] & set1, const vector[int] & set2)
+    cdef vector[int] nbhood(const Vector3d & pos, double dist)
     cdef vector[double] calc_linear_momentum(int include_particles, int include_lbfluid)
     cdef vector[double] centerofmass(PartCfg & , int part_type)
 
@@ -81,7 +81,7 @@ cdef extern from "statistics.hpp":
     void momentofinertiamatrix(PartCfg & , int p_type, double * MofImatrix)
 
     void calc_part_distribution(
-        PartCfg &, const vector[int] & p1_types, const vector[int] & p2_types,
+        const vector[int] & p1_types, const vector[int] & p2_types,
         double r_min, double r_max, int r_bins, bint log_flag, double * low,
         double * dist)
 
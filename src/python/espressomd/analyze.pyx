@@ -106,7 +106,7 @@ class Analysis:
         """
 
         if p1 == 'default' and p2 == 'default':
-            return analyze.mindist(analyze.partCfg(), [], [])
+            return analyze.mindist([], [])
         elif p1 == 'default' or p2 == 'default':
             raise ValueError("Both p1 and p2 have to be specified")
         else:
@@ -120,7 +120,7 @@ class Analysis:
                     raise TypeError(
                         f"Particle types in p2 have to be of type int, got: {repr(p2[i])}")
 
-            return analyze.mindist(analyze.partCfg(), p1, p2)
+            return analyze.mindist(p1, p2)
 
     #
     # Analyze Linear Momentum
@@ -203,8 +203,7 @@ class Analysis:
         utils.check_type_or_throw_except(
             r_catch, 1, float, "r_catch must be a float")
 
-        return analyze.nbhood(
-            analyze.partCfg(), utils.make_Vector3d(pos), r_catch)
+        return analyze.nbhood(utils.make_Vector3d(pos), r_catch)
 
     def pressure(self):
         """
@@ -523,14 +522,17 @@ class Analysis:
     # Structure factor
     #
 
-    def structure_factor(self, sf_types=None, sf_order=None):
+    def structure_factor(self, sf_types=None, sf_order=None, sf_fft=False):
         """
         Calculate the structure factor for given types.  Returns the
         spherically averaged structure factor of particles specified in
         ``sf_types``.  The structure factor is calculated for all possible wave
-        vectors q up to ``sf_order``. Do not choose parameter ``sf_order`` too
-        large because the number of calculations grows as ``sf_order`` to the
-        third power.
+        vectors q up to ``sf_order``. The number of calculations grows as
+        ``sf_order`` to the third power times the number of particles. For
+        large ``sf_order``, the FFT mode assigns the particles to a mesh of
+        ``4 * sf_order`` points per axis instead; it is approximate (errors
+        below one percent for disordered systems) and requires FFTW and a
+        cubic box.
 
         Parameters
         ----------
@@ -539,6 +541,8 @@ class Analysis:
             should be considered.
         sf_order : :obj:`int`
             Specifies the maximum wavevector.
+        sf_fft : :obj:`bool`, optional
+            Evaluate the density modes with an FFT of the particle mesh.
 
         Returns
         -------
@@ -556,7 +560,7 @@ class Analysis:
         cdef vector[double] wavevectors
         cdef vector[double] intensities
         analyze.calc_structurefactor(
-            analyze.partCfg(), sf_types, sf_order, wavevectors, intensities)
+            sf_types, sf_order, sf_fft, wavevectors, intensities)
 
         return np.vstack([wavevectors, intensities])
 
@@ -624,7 +628,7 @@ class Analysis:
         distribution.resize(r_bins)
 
         analyze.calc_part_distribution(
-            analyze.partCfg(), type_list_a, type_list_b,
+            type_list_a, type_list_b,
             r_min, r_max, r_bins, < bint > log_flag, & low, distribution.data())
 
         np_distribution = utils.create_nparray_from_double_array(
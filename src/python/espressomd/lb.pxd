@@ -51,6 +51,24 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp" namespace "ActiveLB":
     cdef ActiveLB CPU
     cdef ActiveLB GPU
 
+cdef extern from "grid_based_algorithms/lb_constants.hpp":
+
+    cdef enum LBField:
+        pass
+    cdef LBField LB_FIELD_DENSITY "LBField::DENSITY"
+    cdef LBField LB_FIELD_VELOCITY "LBField::VELOCITY"
+    cdef LBField LB_FIELD_PRESSURE_TENSOR "LBField::PRESSURE_TENSOR"
+    cdef LBField LB_FIELD_PRESSURE_TENSOR_NEQ "LBField::PRESSURE_TENSOR_NEQ"
+    cdef LBField LB_FIELD_POPULATIONS "LBField::POPULATIONS"
+    cdef LBField LB_FIELD_BOUNDARY "LBField::BOUNDARY"
+    size_t lb_field_size(LBField field)
+
+    cdef enum LBKernel:
+        pass
+    cdef LBKernel LB_KERNEL_REFERENCE "LBKernel::REFERENCE"
+    cdef LBKernel LB_KERNEL_BLOCKED "LBKernel::BLOCKED"
+    cdef LBKernel LB_KERNEL_IN_PLACE "LBKernel::IN_PLACE"
+
 cdef extern from "grid_based_algorithms/lb_interface.hpp":
 
     cdef enum ActiveLB:
@@ -76,9 +94,12 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp":
     void lb_lbfluid_print_vtk_boundary(string filename) except +
     void lb_lbfluid_print_velocity(string filename) except +
     void lb_lbfluid_print_boundary(string filename) except +
+    void lb_lbfluid_write_vtk(string filename, const vector[LBField] & fields, int stride) except +
     void lb_lbfluid_save_checkpoint(string filename, bool binary) except +
     void lb_lbfluid_load_checkpoint(string filename, bool binary) except +
     void lb_lbfluid_set_lattice_switch(ActiveLB local_lattice_switch) except +
+    LBKernel lb_lbfluid_get_kernel()
+    void lb_lbfluid_set_kernel(LBKernel kernel) except +
     Vector6d lb_lbfluid_get_pressure_tensor() except +
     bool lb_lbnode_is_index_valid(const Vector3i & ind) except +
     Vector3i lb_lbfluid_get_shape() except +
@@ -91,6 +112,7 @@ cdef extern from "grid_based_algorithms/lb_interface.hpp":
     const Vector19d lb_lbnode_get_pop(const Vector3i & ind) except +
     void lb_lbnode_set_pop(const Vector3i & ind, const Vector19d & populations) except +
     int lb_lbnode_get_boundary(const Vector3i & ind) except +
+    vector[double] lb_lbfluid_get_slab(LBField field, const Vector3i & lower, const Vector3i & upper) except +
     stdint.uint64_t lb_lbfluid_get_rng_state() except +
     void lb_lbfluid_set_rng_state(stdint.uint64_t) except +
     void lb_lbfluid_set_kT(double) except +
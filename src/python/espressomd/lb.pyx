@@ -396,6 +396,43 @@ cdef class HydrodynamicInteraction(FluidActor):
         """
         lb_lbfluid_print_vtk_boundary(utils.to_char_pointer(path))
 
+    def write_vtk_image(self, path, fields=("velocity",), stride=1):
+        """Write LB fluid fields to a binary VTK XML image file. With the
+        CPU implementation, every MPI rank writes its own part of the fluid.
+
+        Parameters
+        ----------
+        path : :obj:`str`
+            Path to the output binary file, usually with extension ``.vti``.
+        fields : (N,) array_like of :obj:`str`, optional
+            Fields to write, out of ``"density"``, ``"velocity"``,
+            ``"pressure_tensor"``, ``"pressure_tensor_neq"``,
+            ``"population"`` and ``"boundary"``.
+        stride : :obj:`int`, optional
+            Only write every ``stride``-th node in each direction.
+
+        """
+        cdef vector[LBField] fields_vec
+        for field in fields:
+            if field == "density":
+                fields_vec.push_back(LB_FIELD_DENSITY)
+            elif field == "velocity":
+                fields_vec.push_back(LB_FIELD_VELOCITY)
+            elif field == "pressure_tensor":
+                fields_vec.push_back(LB_FIELD_PRESSURE_TENSOR)
+            elif field == "pressure_tensor_neq":
+                fields_vec.push_back(LB_FIELD_PRESSURE_TENSOR_NEQ)
+            elif field == "population":
+                fields_vec.push_back(LB_FIELD_POPULATIONS)
+            elif field == "boundary":
+                fields_vec.push_back(LB_FIELD_BOUNDARY)
+            else:
+                raise ValueError(f"Unknown LB field '{field}'")
+        utils.check_type_or_throw_except(
+            stride, 1, int, "stride has to be an integer")
+        lb_lbfluid_write_vtk(utils.to_char_pointer(path), fields_vec, stride)
+        utils.handle_errors("LB VTK output")
+
     def write_velocity(self, path):
         """Write the LB fluid velocity to a data file that can be loaded by
         numpy, with format "x y z vx vy vz".
@@ -555,6 +592,34 @@ cdef class LBFluid(HydrodynamicInteraction):
         self._set_lattice_switch()
         self._set_params_in_es_core()
 
+    property kernel:
+        """
+        Implementation of the collide-and-stream step: ``"reference"``
+        (default), ``"blocked"`` or ``"in_place"``, which only stores
+        one set of populations. All produce identical populations.
+
+        """
+
+        def __get__(self):
+            kernel = lb_lbfluid_get_kernel()
+            if kernel == LB_KERNEL_BLOCKED:
+                return "blocked"
+            if kernel == LB_KERNEL_IN_PLACE:
+                return "in_place"
+            return "reference"
+
+        def __set__(self, kernel):
+            if kernel == "reference":
+                lb_lbfluid_set_kernel(LB_KERNEL_REFERENCE)
+            elif kernel == "blocked":
+                lb_lbfluid_set_kernel(LB_KERNEL_BLOCKED)
+            elif kernel == "in_place":
+                lb_lbfluid_set_kernel(LB_KERNEL_IN_PLACE)
+            else:
+                raise ValueError(
+                    f"Unknown LB kernel '{kernel}', valid kernels are: "
+                    "reference, blocked, in_place")
+
 IF CUDA:
     cdef class LBFluidGPU(HydrodynamicInteraction):
         """
@@ -701,6 +766,50 @@ cdef class LBFluidRoutines:
         return hash(self.index)
 
 
+cdef _lbfluid_get_slab(prop_name, lower, upper):
+    """
+    Read a node property on all nodes in the box ``[lower, upper)`` with
+    a single collective call. Returns ``None`` if the property cannot be
+    read in bulk.
+
+    """
+    cdef LBField field
+    cdef double agrid = lb_lbfluid_get_agrid()
+    cdef double tau = lb_lbfluid_get_tau()
+    unit_conversion = 1.
+    if prop_name == "density":
+        field = LB_FIELD_DENSITY
+        unit_conversion = 1. / agrid**3
+    elif prop_name == "velocity":
+        field = LB_FIELD_VELOCITY
+        unit_conversion = lb_lbfluid_get_lattice_speed()
+    elif prop_name == "pressure_tensor":
+        field = LB_FIELD_PRESSURE_TENSOR
+        unit_conversion = 1. / (tau**2 * agrid)
+    elif prop_name == "pressure_tensor_neq":
+        field = LB_FIELD_PRESSURE_TENSOR_NEQ
+        unit_conversion = 1. / (tau**2 * agrid)
+    elif prop_name == "population":
+        field = LB_FIELD_POPULATIONS
+    elif prop_name == "boundary":
+        field = LB_FIELD_BOUNDARY
+    else:
+        return None
+
+    cdef vector[double] values = lb_lbfluid_get_slab(
+        field, utils.make_Vector3i(lower), utils.make_Vector3i(upper))
+    shape = tuple(np.array(upper) - np.array(lower))
+    res = np.array(values).reshape(
+        (*shape, lb_field_size(field))) * unit_conversion
+    if prop_name.startswith("pressure_tensor"):
+        res = res[..., [0, 1, 3, 1, 2, 4, 3, 4, 5]].reshape((*shape, 3, 3))
+    elif prop_name == "boundary":
+        res = res.astype(int)
+    if res.shape[3:] == (1,):
+        res = np.squeeze(res, axis=-1)
+    return res
+
+
 class LBSlice:
 
     def __init__(self, key, shape):
@@ -714,6 +823,17 @@ class LBSlice:
         return x_indices, y_indices, z_indices
 
     def get_values(self, x_indices, y_indices, z_indices, prop_name):
+        # read the bounding box of the slice in one pass over the lattice
+        lower = [int(np.min(x_indices)), int(np.min(y_indices)),
+                 int(np.min(z_indices))]
+        upper = [int(np.max(x_indices)) + 1, int(np.max(y_indices)) + 1,
+                 int(np.max(z_indices)) + 1]
+        res = _lbfluid_get_slab(prop_name, lower, upper)
+        if res is not None:
+            return utils.array_locked(res[np.ix_(x_indices - lower[0],
+                                                 y_indices - lower[1],
+                                                 z_indices - lower[2])])
+
         shape_res = np.shape(
             getattr(LBFluidRoutines(np.array([0, 0, 0])), prop_name))
         res = np.zeros(
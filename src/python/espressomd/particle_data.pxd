@@ -65,18 +65,7 @@ cdef extern from "Particle.hpp":
         double dipm()
         bint is_virtual()
         Vector3d ext_force()
-        Vector3d visc_force()
-        Vector3d visc_gamma_vec()
-        vector[double] visc_gamma()
-        vector[double] taum()
-        vector[double] vcrit()
-        vector[double] aexp()
-        vector[double] bexp()
-        int Nm()
         Vector3d ext_torque()
-        Vector3d visc_torque()
-        vector[double] omegacrit()
-        vector[double] visc_gamma_rot()
         vector[int] exclusions_as_vector() except +
         bool has_exclusion(int pid) except +
         particle_parameters_swimming swimming()
@@ -148,19 +137,10 @@ cdef extern from "particle_data.hpp":
     IF EXTERNAL_FORCES:
         IF ROTATION:
             void set_particle_ext_torque(int part, const Vector3d & torque)
-            void set_particle_visc_torque(int part, const Vector3d & visc_torque)
-            void set_particle_omegacrit(int part, vector[double] & omegacrit)
-            void set_particle_visc_gamma_rot(int part, vector[double] & visc_gamma_rot)
 
         void set_particle_ext_force(int part, const Vector3d & force)
-        void set_particle_visc_force(int part, const Vector3d & force)
-        void set_particle_visc_gamma_vec(int part, const Vector3d & visc_gamma_vec)
-        void set_particle_visc_gamma(int part, vector[double] & visc_gamma)
-        void set_particle_taum(int part, vector[double] & taum)
-        void set_particle_vcrit(int part, vector[double] & vcrit)
-        void set_particle_aexp(int part, vector[double] & aexp)
-        void set_particle_bexp(int part, vector[double] & bexp)
-        void set_particle_Nm(int part, int Nm)
+        void set_particle_gle_state(int part, const vector[double] & state)
+        vector[double] get_particle_gle_state(const particle * p)
 
         void set_particle_fix(int part, const Vector3i & flag)
         Vector3i get_particle_fix(const particle * p)
@@ -794,223 +794,35 @@ cdef class ParticleHandle:
                 return make_array_locked(
                     self.particle_data.ext_force())
         
-        property visc_force:
+        property gle_state:
             """
-            An additional viscoelastic force applied to the particle.
+            Extended variables of the Prony modes of the generalized
+            Langevin equation, one row per mode with the translational
+            and rotational components. The modes themselves are defined
+            per particle type, see
+            :meth:`espressomd.thermostat.Thermostat.set_gle_kernel`.
 
-            visc_force : (3,) array_like of :obj:`float`
+            gle_state : (Nm, 6) array_like of :obj:`float`
 
             .. note::
                This needs the feature ``EXTERNAL_FORCES``.
 
             """
 
-            def __set__(self, _visc_f):
-                check_type_or_throw_except(
-                    _visc_f, 3, float, "Viscoelastic force vector has to be 3 floats.")
-                set_particle_visc_force(self._id, make_Vector3d(_visc_f))
-
-            def __get__(self):
-                self.update_particle_data()
-                return make_array_locked(
-                    self.particle_data.visc_force())
-
-        property visc_gamma_vec:
-            """
-            The viscoelastic friction coefficient of the particle.
-
-            visc_gamma_vec : (3,) array_like of :obj:`float`
-
-            .. note::
-               This needs the feature ``EXTERNAL_FORCES``.
-
-            """
-
-            def __set__(self, _visc_g):
-                check_type_or_throw_except(
-                    _visc_g, 3, float, "Viscoelastic gamma vector has to be 3 floats.")
-                set_particle_visc_gamma_vec(self._id, make_Vector3d(_visc_g))
-
-            def __get__(self):
-                self.update_particle_data()
-                return make_array_locked(
-                    self.particle_data.visc_gamma_vec())
-        
-        property visc_gamma:
-            """
-            Viscoelastic ratio gammaM / gammaN.
-
-            visc_gamma : (Nm,) array_like of :obj:`double`
-
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _visc_gamma):
-                check_type_or_throw_except(
-                    _visc_gamma, 20, float, "visc_gamma has to be a array-like of length 20.")
-                set_particle_visc_gamma(self._id, _visc_gamma)
-
-            def __get__(self):
-                self.update_particle_data()
-                return array_locked(self.particle_data.visc_gamma())
-
-        property taum:
-            """
-            Viscoelastic relaxation time.
-
-            taum : (Nm,) array_like of :obj:`double`
-
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _taum):
-                check_type_or_throw_except(
-                    _taum, 20, float, "taum has to be a array-like of length 20.")
-                set_particle_taum(self._id, _taum)
-
-            def __get__(self):
-                self.update_particle_data()
-                return array_locked(self.particle_data.taum())
-
-        property vcrit:
-            """
-            Viscoelastic critical velocity.
-
-            vcrit : (Nm,) array_like of :obj:`double`
-
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _vcrit):
-                check_type_or_throw_except(
-                    _vcrit, 20, float, "vcrit has to be a array-like of length 20.")
-                set_particle_vcrit(self._id, _vcrit)
-
-            def __get__(self):
-                self.update_particle_data()
-                return array_locked(self.particle_data.vcrit())
-
-        property aexp:
-            """
-            Viscoelastic viscosity exponent a.
-
-            aexp : (Nm,) array_like of :obj:`double`
-
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _aexp):
-                check_type_or_throw_except(
-                    _aexp, 20, float, "aexp has to be a array-like of length 20.")
-                set_particle_aexp(self._id, _aexp)
-
-            def __get__(self):
-                self.update_particle_data()
-                return array_locked(self.particle_data.aexp())
-
-        property bexp:
-            """
-            Viscoelastic viscosity exponent b.
-
-            bexp : (Nm,) array_like of :obj:`double`
-
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _bexp):
-                check_type_or_throw_except(
-                    _bexp, 20, float, "bexp has to be a array-like of length 20.")
-                set_particle_bexp(self._id, _bexp)
-
-            def __get__(self):
-                self.update_particle_data()
-                return array_locked(self.particle_data.bexp())
-
-        property Nm:
-            """
-            The number of Prony modes of the Particle.
-
-            Nm : :obj:`int`
-
-            .. note::
-            The value of ``Nm`` has to be an integer >= 0.
-
-            """
-
-            def __set__(self, _Nm):
-                if is_valid_type(_Nm, int) and _Nm >= 0:
-                    set_particle_Nm(self._id, _Nm)
-                else:
-                    raise ValueError("Nm must be an integer >= 0")
-
-            def __get__(self):
-                self.update_particle_data()
-                return self.particle_data.Nm()
-
-        property visc_torque:
-            """
-            An additional viscoelastic torque applied to the particle.
-
-            visc_torque : (3,) array_like of :obj:`float`
-
-            .. note::
-               This needs the feature ``EXTERNAL_FORCES``.
-
-            """
-
-            def __set__(self, _visc_t):
-                check_type_or_throw_except(
-                    _visc_t, 3, float, "Viscoelastic torque vector has to be 3 floats.")
-                set_particle_visc_torque(self._id, make_Vector3d(_visc_t))
-
-            def __get__(self):
-                self.update_particle_data()
-                return make_array_locked(
-                    self.particle_data.visc_torque())
-
-        property omegacrit:
-            """
-            Viscoelastic critical angular velocity.
-
-            omegacrit : (Nm,) array_like of :obj:`double`
-
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _omegacrit):
-                check_type_or_throw_except(
-                    _omegacrit, 20, float, "omegacrit has to be a array-like of length 20.")
-                set_particle_omegacrit(self._id, _omegacrit)
+            def __set__(self, _state):
+                state = np.array(_state, dtype=float, ndmin=2)
+                if state.size == 0:
+                    state = np.zeros((0, 6))
+                if state.ndim != 2 or state.shape[1] != 6:
+                    raise ValueError(
+                        "gle_state has to be an array-like of shape (Nm, 6)")
+                set_particle_gle_state(self._id, state.T.flatten())
 
             def __get__(self):
                 self.update_particle_data()
-                return array_locked(self.particle_data.omegacrit())
-
-        property visc_gamma_rot:
-            """
-            Viscoelastic rotational friction coefficient.
-
-            visc_gamma_rot : (Nm,) array_like of :obj:`double`
+                state = np.array(get_particle_gle_state(self.particle_data))
+                return array_locked(state.reshape((6, -1)).T)
 
-            .. note::
-               This needs the feature ``EXTERNAL FORCES``.
-            """
-
-            def __set__(self, _visc_gamma_rot):
-                check_type_or_throw_except(
-                    _visc_gamma_rot, 20, float, "visc_gamma has to be a array-like of length 20.")
-                set_particle_visc_gamma_rot(self._id, _visc_gamma_rot)
-
-            def __get__(self):
-                self.update_particle_data()
-                return array_locked(self.particle_data.visc_gamma_rot())
-             
         property fix:
             """
             Fixes the particle motion in the specified cartesian directions.
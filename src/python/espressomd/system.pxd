@@ -41,6 +41,10 @@ cdef extern from "object-in-fluid/oif_global_forces.hpp":
     int max_oif_objects
     void mpi_set_max_oif_objects(int max_oif_objects)
 
+cdef extern from "threads.hpp":
+    int get_n_threads()
+    void mpi_set_n_threads(int n_threads) except +
+
 cdef extern from "nonbonded_interactions/nonbonded_interaction_data.hpp":
     double get_min_global_cut()
     void mpi_set_min_global_cut(double min_global_cut)
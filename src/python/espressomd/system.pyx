@@ -165,7 +165,8 @@ cdef class System:
             raise ValueError("Required argument 'box_l' not provided.")
 
         setable_properties = ["box_l", "min_global_cut", "periodicity", "time",
-                              "time_step", "force_cap", "max_oif_objects"]
+                              "time_step", "force_cap", "max_oif_objects",
+                              "n_threads"]
         if has_features("VIRTUAL_SITES"):
             setable_properties.append("_active_virtual_sites_handle")
 
@@ -338,6 +339,20 @@ cdef class System:
         def __set__(self, v):
             mpi_set_max_oif_objects(v)
 
+    property n_threads:
+        """
+        :obj:`int`:
+            Number of threads per MPI rank of the per-particle passes of the
+            integrator. Values larger than 1 require the ``OPENMP`` feature.
+
+        """
+
+        def __get__(self):
+            return get_n_threads()
+
+        def __set__(self, int n_threads):
+            mpi_set_n_threads(n_threads)
+
     def change_volume_and_rescale_particles(self, d_new, dir="xyz"):
         """Change box size and rescale particle coordinates.
 
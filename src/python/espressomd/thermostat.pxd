@@ -18,6 +18,7 @@
 #
 from libcpp cimport bool as cbool
 from libc cimport stdint
+from libcpp.vector cimport vector
 
 include "myconfig.pxi"
 from .utils cimport Vector3d
@@ -33,6 +34,7 @@ cdef extern from "thermostat.hpp":
     int THERMO_DPD
     int THERMO_BROWNIAN
     int THERMO_SD
+    int THERMO_GLE
 
     cdef cppclass BaseThermostat:
         stdint.uint32_t rng_seed()
@@ -58,6 +60,20 @@ cdef extern from "thermostat.hpp":
         double gammav
     cdef cppclass ThermalizedBondThermostat(BaseThermostat):
         pass
+    cdef cppclass GLEMode:
+        double gamma
+        double tau
+        double vcrit
+        double aexp
+        double bexp
+        double gamma_rot
+        double omegacrit
+    cdef cppclass GLEKernel:
+        vector[GLEMode] modes
+        Vector3d gamma_vec
+    cdef cppclass GLEThermostat(BaseThermostat):
+        vector[GLEKernel] kernels
+        cbool exact_propagator
     IF DPD:
         cdef cppclass DPDThermostat(BaseThermostat):
             pass
@@ -69,6 +85,7 @@ cdef extern from "thermostat.hpp":
     BrownianThermostat brownian
     IsotropicNptThermostat npt_iso
     ThermalizedBondThermostat thermalized_bond
+    GLEThermostat gle
     IF DPD:
         DPDThermostat dpd
     IF STOKESIAN_DYNAMICS:
@@ -77,6 +94,7 @@ cdef extern from "thermostat.hpp":
     void langevin_set_rng_seed(stdint.uint32_t seed)
     void brownian_set_rng_seed(stdint.uint32_t seed)
     void npt_iso_set_rng_seed(stdint.uint32_t seed)
+    void gle_set_rng_seed(stdint.uint32_t seed)
     IF DPD:
         void dpd_set_rng_seed(stdint.uint32_t seed)
     IF STOKESIAN_DYNAMICS:
@@ -85,6 +103,7 @@ cdef extern from "thermostat.hpp":
     void langevin_set_rng_counter(stdint.uint64_t counter)
     void brownian_set_rng_counter(stdint.uint64_t counter)
     void npt_iso_set_rng_counter(stdint.uint64_t counter)
+    void gle_set_rng_counter(stdint.uint64_t counter)
     IF DPD:
         void dpd_set_rng_counter(stdint.uint64_t counter)
     IF STOKESIAN_DYNAMICS:
@@ -104,6 +123,8 @@ cdef extern from "thermostat.hpp":
         void mpi_set_langevin_gamma_rot(const double & gamma)
 
     void mpi_set_thermo_virtual(cbool thermo_virtual)
+    void mpi_set_gle_kernel(int type, const GLEKernel & kernel)
+    void mpi_set_gle_exact_propagator(cbool exact)
     void mpi_set_temperature(double temperature)
     void mpi_set_thermo_switch(int thermo_switch)
 
@@ -141,6 +141,12 @@ cdef class Thermostat:
                 IF STOKESIAN_DYNAMICS:
                     self.set_stokesian(kT=thmst["kT"], seed=thmst["seed"])
                     stokesian_set_rng_counter(thmst["counter"])
+            if thmst["type"] == "GLE":
+                self.set_gle(kT=thmst["kT"], seed=thmst["seed"],
+                             propagator=thmst["propagator"])
+                gle_set_rng_counter(thmst["counter"])
+                for particle_type, kernel in thmst["kernels"].items():
+                    self.set_gle_kernel(particle_type=particle_type, **kernel)
 
     def get_ts(self):
         return thermo_switch
@@ -235,6 +241,19 @@ cdef class Thermostat:
                 sd_dict["seed"] = stokesian.rng_seed()
                 sd_dict["counter"] = stokesian.rng_counter()
                 thermo_list.append(sd_dict)
+        if thermo_switch & THERMO_GLE:
+            gle_dict = {}
+            gle_dict["type"] = "GLE"
+            gle_dict["kT"] = temperature
+            gle_dict["seed"] = gle.rng_seed()
+            gle_dict["counter"] = gle.rng_counter()
+            gle_dict["propagator"] = "exact" if gle.exact_propagator else "euler"
+            gle_dict["kernels"] = {}
+            for particle_type in range(gle.kernels.size()):
+                if gle.kernels[particle_type].modes.size():
+                    gle_dict["kernels"][particle_type] = \
+                        self.get_gle_kernel(particle_type)
+            thermo_list.append(gle_dict)
         return thermo_list
 
     def turn_off(self):
@@ -261,7 +280,8 @@ cdef class Thermostat:
         mpi_set_thermo_switch(THERMO_OFF)
         lb_lbcoupling_set_gamma(0.0)
 
-    @AssertThermostatType(THERMO_LANGEVIN, THERMO_DPD)
+    @AssertThermostatType(THERMO_LANGEVIN, THERMO_DPD, THERMO_GLE,
+                          THERMO_LANGEVIN | THERMO_GLE)
     def set_langevin(self, kT, gamma, gamma_rotation=None,
                      act_on_virtual=False, seed=None):
         """
@@ -389,7 +409,8 @@ cdef class Thermostat:
 
         mpi_set_thermo_virtual(act_on_virtual)
 
-    @AssertThermostatType(THERMO_BROWNIAN)
+    @AssertThermostatType(THERMO_BROWNIAN, THERMO_GLE,
+                          THERMO_BROWNIAN | THERMO_GLE)
     def set_brownian(self, kT, gamma, gamma_rotation=None,
                      act_on_virtual=False, seed=None):
         """Sets the Brownian thermostat.
@@ -565,6 +586,163 @@ cdef class Thermostat:
         mpi_set_thermo_virtual(act_on_virtual)
         lb_lbcoupling_set_gamma(gamma)
 
+    @AssertThermostatType(THERMO_GLE, THERMO_LANGEVIN, THERMO_BROWNIAN,
+                          THERMO_LANGEVIN | THERMO_GLE,
+                          THERMO_BROWNIAN | THERMO_GLE)
+    def set_gle(self, kT, seed=None, propagator="euler"):
+        """
+        Sets the thermostat of the viscoelastic Prony modes (generalized
+        Langevin equation). It is meant to be combined with the Langevin
+        or Brownian thermostat, which handle the Newtonian friction.
+
+        Parameters
+        ----------
+        kT : :obj:`float`
+            Thermal energy of the heat bath.
+        seed : :obj:`int`
+            Initial counter value (or seed) of the philox RNG.
+            Required on first activation of the GLE thermostat.
+            Must be positive.
+        propagator : :obj:`str`, optional
+            Integration scheme of the auxiliary variables: ``"euler"``
+            for the explicit Euler scheme, which needs time steps much
+            smaller than the shortest relaxation time, or ``"exact"`` for
+            the analytic Ornstein-Uhlenbeck propagator, which is stable
+            for any time step.
+
+        """
+        utils.check_type_or_throw_except(
+            kT, 1, float, "kT must be a number")
+        if float(kT) < 0.:
+            raise ValueError("temperature must be a positive number")
+        if propagator not in ("euler", "exact"):
+            raise ValueError("propagator must be 'euler' or 'exact'")
+
+        # Seed is required if the RNG is not initialized
+        if seed is None and gle.is_seed_required():
+            raise ValueError(
+                "A seed has to be given as keyword argument on first activation of the thermostat")
+
+        if seed is not None:
+            utils.check_type_or_throw_except(
+                seed, 1, int, "seed must be a positive integer")
+            if seed < 0:
+                raise ValueError("seed must be a positive integer")
+            gle_set_rng_seed(seed)
+
+        mpi_set_gle_exact_propagator(propagator == "exact")
+        mpi_set_temperature(kT)
+        global thermo_switch
+        mpi_set_thermo_switch(thermo_switch | THERMO_GLE)
+
+    def set_gle_kernel(self, particle_type, gamma, tau, vcrit=None,
+                       aexp=None, bexp=None, gamma_rot=None, omegacrit=None,
+                       gamma_vec=(1., 1., 1.)):
+        """
+        Sets the memory kernel of the viscoelastic friction of a particle
+        type, as a sum of Prony modes. All particles of the type share the
+        kernel, only their extended variables are stored per particle.
+        The number of modes is given by the length of ``gamma``, an empty
+        ``gamma`` removes the viscoelastic friction of the type.
+
+        Parameters
+        ----------
+        particle_type : :obj:`int`
+            Particle type.
+        gamma : (Nm,) array_like of :obj:`float`
+            Zero-shear friction coefficients of the modes.
+        tau : (Nm,) array_like of :obj:`float`
+            Relaxation times of the modes.
+        vcrit : (Nm,) array_like of :obj:`float`, optional
+            Critical velocities of the Carreau-Yasuda viscosity.
+        aexp : (Nm,) array_like of :obj:`float`, optional
+            Exponents :math:`a` of the viscosity. Defaults to 0, i.e.
+            a linear viscoelastic kernel.
+        bexp : (Nm,) array_like of :obj:`float`, optional
+            Exponents :math:`b` of the viscosity. Defaults to 2.
+        gamma_rot : (Nm,) array_like of :obj:`float`, optional
+            Zero-shear rotational friction coefficients. Defaults to
+            ``gamma``.
+        omegacrit : (Nm,) array_like of :obj:`float`, optional
+            Critical angular velocities. Defaults to ``vcrit``.
+        gamma_vec : (3,) array_like of :obj:`float`, optional
+            Anisotropic scaling of the friction of all modes.
+
+        """
+        utils.check_type_or_throw_except(
+            particle_type, 1, int, "particle_type must be an integer")
+        if particle_type < 0:
+            raise ValueError("particle_type must be a positive integer")
+        n_modes = len(gamma)
+
+        def mode_values(name, values, default):
+            if values is None:
+                values = [default] * n_modes
+            if len(values) != n_modes:
+                raise ValueError(
+                    f"{name} must have the same length as gamma ({n_modes})")
+            utils.check_type_or_throw_except(
+                values, n_modes, float, f"{name} must be an array of floats")
+            return [float(x) for x in values]
+
+        gamma = mode_values("gamma", gamma, None)
+        tau = mode_values("tau", tau, None)
+        vcrit = mode_values("vcrit", vcrit, 1.)
+        aexp = mode_values("aexp", aexp, 0.)
+        bexp = mode_values("bexp", bexp, 2.)
+        if gamma_rot is None:
+            gamma_rot = gamma
+        gamma_rot = mode_values("gamma_rot", gamma_rot, None)
+        if omegacrit is None:
+            omegacrit = vcrit
+        omegacrit = mode_values("omegacrit", omegacrit, None)
+        utils.check_type_or_throw_except(
+            gamma_vec, 3, float, "gamma_vec must be 3 floats")
+        for name, values in (("gamma", gamma), ("tau", tau), ("vcrit", vcrit),
+                             ("gamma_rot", gamma_rot),
+                             ("omegacrit", omegacrit), ("gamma_vec", gamma_vec)):
+            if any(x <= 0. for x in values):
+                raise ValueError(f"{name} must be strictly positive")
+
+        cdef GLEKernel kernel
+        cdef GLEMode mode
+        for k in range(n_modes):
+            mode.gamma = gamma[k]
+            mode.tau = tau[k]
+            mode.vcrit = vcrit[k]
+            mode.aexp = aexp[k]
+            mode.bexp = bexp[k]
+            mode.gamma_rot = gamma_rot[k]
+            mode.omegacrit = omegacrit[k]
+            kernel.modes.push_back(mode)
+        kernel.gamma_vec = utils.make_Vector3d(gamma_vec)
+        mpi_set_gle_kernel(particle_type, kernel)
+
+    def get_gle_kernel(self, particle_type):
+        """
+        Returns the memory kernel of the viscoelastic friction of a particle
+        type, see :meth:`set_gle_kernel`.
+
+        """
+        cdef GLEKernel kernel
+        cdef GLEMode mode
+        if 0 <= particle_type < gle.kernels.size():
+            kernel = gle.kernels[particle_type]
+        params = {key: [] for key in ("gamma", "tau", "vcrit", "aexp", "bexp",
+                                      "gamma_rot", "omegacrit")}
+        for k in range(kernel.modes.size()):
+            mode = kernel.modes[k]
+            params["gamma"].append(mode.gamma)
+            params["tau"].append(mode.tau)
+            params["vcrit"].append(mode.vcrit)
+            params["aexp"].append(mode.aexp)
+            params["bexp"].append(mode.bexp)
+            params["gamma_rot"].append(mode.gamma_rot)
+            params["omegacrit"].append(mode.omegacrit)
+        params["gamma_vec"] = [kernel.gamma_vec[0], kernel.gamma_vec[1],
+                               kernel.gamma_vec[2]]
+        return params
+
     IF NPT:
         @AssertThermostatType(THERMO_NPT_ISO)
         def set_npt(self, kT, gamma0, gammav, seed=None):
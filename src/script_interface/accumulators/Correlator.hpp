@@ -29,6 +29,7 @@
 #include "script_interface/observables/Observable.hpp"
 
 #include "core/accumulators/Correlator.hpp"
+#include "core/communication.hpp"
 
 #include <utils/Vector.hpp>
 #include <utils/as_const.hpp>
@@ -64,14 +65,18 @@ public:
     else
       m_obs2 = m_obs1;
 
-    auto const comp1 = get_value_or<std::string>(args, "compress1", "discard2");
-    auto const comp2 = get_value_or<std::string>(args, "compress2", comp1);
-
-    m_correlator = std::make_shared<CoreCorr>(
-        get_value<int>(args, "tau_lin"), get_value<double>(args, "tau_max"),
-        get_value<int>(args, "delta_N"), comp1, comp2,
-        get_value<std::string>(args, "corr_operation"), m_obs1->observable(),
-        m_obs2->observable(), get_value_or<Utils::Vector3d>(args, "args", {}));
+    context()->parallel_try_catch([this, &args]() {
+      auto const comp1 =
+          get_value_or<std::string>(args, "compress1", "discard2");
+      auto const comp2 = get_value_or<std::string>(args, "compress2", comp1);
+
+      m_correlator = std::make_shared<CoreCorr>(
+          get_value<int>(args, "tau_lin"), get_value<double>(args, "tau_max"),
+          get_value<int>(args, "delta_N"), comp1, comp2,
+          get_value<std::string>(args, "corr_operation"), m_obs1->observable(),
+          m_obs2->observable(),
+          get_value_or<Utils::Vector3d>(args, "args", {}));
+    });
   }
 
   std::shared_ptr<::Accumulators::Correlator> correlator() {
@@ -80,10 +85,13 @@ public:
 
   Variant do_call_method(std::string const &method,
                          VariantMap const &parameters) override {
-    if (method == "update")
-      correlator()->update();
-    if (method == "finalize")
-      correlator()->finalize();
+    if (method == "update") {
+      context()->parallel_try_catch(
+          [this]() { correlator()->update(comm_cart); });
+    }
+    if (method == "finalize") {
+      context()->parallel_try_catch([this]() { correlator()->finalize(); });
+    }
     if (method == "get_correlation")
       return correlator()->get_correlation();
     if (method == "get_lag_times")
@@ -24,6 +24,7 @@
 
 #include "AccumulatorBase.hpp"
 #include "core/accumulators/MeanVarianceCalculator.hpp"
+#include "core/communication.hpp"
 #include "script_interface/ScriptInterface.hpp"
 #include "script_interface/observables/Observable.hpp"
 
@@ -62,8 +63,10 @@ public:
 
   Variant do_call_method(std::string const &method,
                          VariantMap const &parameters) override {
-    if (method == "update")
-      mean_variance_calculator()->update();
+    if (method == "update") {
+      context()->parallel_try_catch(
+          [this]() { mean_variance_calculator()->update(comm_cart); });
+    }
     if (method == "mean")
       return mean_variance_calculator()->mean();
     if (method == "variance")
@@ -23,6 +23,7 @@
 #include "script_interface/observables/Observable.hpp"
 
 #include "core/accumulators/TimeSeries.hpp"
+#include "core/communication.hpp"
 
 #include <boost/range/algorithm/transform.hpp>
 #include <utils/as_const.hpp>
@@ -50,7 +51,8 @@ public:
   Variant do_call_method(std::string const &method,
                          VariantMap const &parameters) override {
     if (method == "update") {
-      m_accumulator->update();
+      context()->parallel_try_catch(
+          [this]() { m_accumulator->update(comm_cart); });
     }
     if (method == "time_series") {
       auto const &series = m_accumulator->time_series();
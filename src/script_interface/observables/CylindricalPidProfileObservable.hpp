@@ -104,19 +104,22 @@ public:
   void do_construct(VariantMap const &params) override {
     set_from_args(m_transform_params, params, "transform_params");
 
-    if (m_transform_params)
-      m_observable = std::make_shared<CoreObs>(
-          get_value<std::vector<int>>(params, "ids"),
-          m_transform_params->cyl_transform_params(),
-          get_value_or<int>(params, "n_r_bins", 1),
-          get_value_or<int>(params, "n_phi_bins", 1),
-          get_value_or<int>(params, "n_z_bins", 1),
-          get_value_or<double>(params, "min_r", 0.),
-          get_value<double>(params, "max_r"),
-          get_value_or<double>(params, "min_phi", -Utils::pi()),
-          get_value_or<double>(params, "max_phi", Utils::pi()),
-          get_value<double>(params, "min_z"),
-          get_value<double>(params, "max_z"));
+    if (m_transform_params) {
+      this->context()->parallel_try_catch([this, &params]() {
+        m_observable = std::make_shared<CoreObs>(
+            get_value<std::vector<int>>(params, "ids"),
+            m_transform_params->cyl_transform_params(),
+            get_value_or<int>(params, "n_r_bins", 1),
+            get_value_or<int>(params, "n_phi_bins", 1),
+            get_value_or<int>(params, "n_z_bins", 1),
+            get_value_or<double>(params, "min_r", 0.),
+            get_value<double>(params, "max_r"),
+            get_value_or<double>(params, "min_phi", -Utils::pi()),
+            get_value_or<double>(params, "max_phi", Utils::pi()),
+            get_value<double>(params, "min_z"),
+            get_value<double>(params, "max_z"));
+      });
+    }
   }
 
   Variant do_call_method(std::string const &method,
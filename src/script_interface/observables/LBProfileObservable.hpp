@@ -92,14 +92,16 @@ public:
   }
 
   void do_construct(VariantMap const &params) override {
-    m_observable =
-        make_shared_from_args<CoreLBObs, double, double, double, double, double,
-                              double, int, int, int, double, double, double,
-                              double, double, double, bool>(
-            params, "sampling_delta_x", "sampling_delta_y", "sampling_delta_z",
-            "sampling_offset_x", "sampling_offset_y", "sampling_offset_z",
-            "n_x_bins", "n_y_bins", "n_z_bins", "min_x", "max_x", "min_y",
-            "max_y", "min_z", "max_z", "allow_empty_bins");
+    this->context()->parallel_try_catch([this, &params]() {
+      m_observable =
+          make_shared_from_args<CoreLBObs, double, double, double, double,
+                                double, double, int, int, int, double, double,
+                                double, double, double, double, bool>(
+              params, "sampling_delta_x", "sampling_delta_y",
+              "sampling_delta_z", "sampling_offset_x", "sampling_offset_y",
+              "sampling_offset_z", "n_x_bins", "n_y_bins", "n_z_bins", "min_x",
+              "max_x", "min_y", "max_y", "min_z", "max_z", "allow_empty_bins");
+    });
   }
 
   Variant do_call_method(std::string const &method,
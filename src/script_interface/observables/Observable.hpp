@@ -24,6 +24,7 @@
 
 #include "script_interface/ScriptInterface.hpp"
 
+#include "core/communication.hpp"
 #include "core/observables/Observable.hpp"
 
 #include <memory>
@@ -41,7 +42,10 @@ public:
   Variant do_call_method(std::string const &method,
                          VariantMap const &parameters) override {
     if (method == "calculate") {
-      return observable()->operator()();
+      std::vector<double> values;
+      context()->parallel_try_catch(
+          [this, &values]() { values = observable()->operator()(comm_cart); });
+      return values;
     }
     if (method == "shape") {
       auto const shape = observable()->shape();
@@ -80,11 +80,13 @@ public:
   }
 
   void do_construct(VariantMap const &params) override {
-    m_observable =
-        make_shared_from_args<CoreObs, std::vector<int>, int, int, int, double,
-                              double, double, double, double, double>(
-            params, "ids", "n_x_bins", "n_y_bins", "n_z_bins", "min_x", "max_x",
-            "min_y", "max_y", "min_z", "max_z");
+    this->context()->parallel_try_catch([this, &params]() {
+      m_observable =
+          make_shared_from_args<CoreObs, std::vector<int>, int, int, int,
+                                double, double, double, double, double, double>(
+              params, "ids", "n_x_bins", "n_y_bins", "n_z_bins", "min_x",
+              "max_x", "min_y", "max_y", "min_z", "max_z");
+    });
   }
 
   Variant do_call_method(std::string const &method,
@@ -55,9 +55,12 @@ public:
   }
 
   void do_construct(VariantMap const &params) override {
-    m_observable = make_shared_from_args<::Observables::RDF, std::vector<int>,
-                                         std::vector<int>, int, double, double>(
-        params, "ids1", "ids2", "n_r_bins", "min_r", "max_r");
+    context()->parallel_try_catch([this, &params]() {
+      m_observable =
+          make_shared_from_args<::Observables::RDF, std::vector<int>,
+                                std::vector<int>, int, double, double>(
+              params, "ids1", "ids2", "n_r_bins", "min_r", "max_r");
+    });
   }
 
   std::shared_ptr<::Observables::RDF> rdf_observable() const {
@@ -17,33 +17,62 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define BOOST_TEST_NO_MAIN
 #define BOOST_TEST_MODULE Accumulators test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include <boost/mpi.hpp>
+#include <boost/mpi/communicator.hpp>
 #include <boost/variant.hpp>
 
+#include "script_interface/LocalContext.hpp"
 #include "script_interface/accumulators/Correlator.hpp"
 #include "script_interface/accumulators/MeanVarianceCalculator.hpp"
 #include "script_interface/accumulators/TimeSeries.hpp"
 #include "script_interface/get_value.hpp"
 #include "script_interface/observables/ParamlessObservable.hpp"
 
+#include "core/accumulators/AccumulatorBase.hpp"
+#include "core/accumulators/Correlator.hpp"
+#include "core/accumulators/TimeSeries.hpp"
+#include "core/communication.hpp"
+#include "core/integrate.hpp"
 #include "core/observables/Observable.hpp"
 
+#include <utils/Factory.hpp>
 #include <utils/as_const.hpp>
 
 #include <cstddef>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 namespace Observables {
 class MockObservable : public Observable {
 public:
-  std::vector<double> operator()() const override { return {1., 2., 3., 4.}; }
+  std::vector<double>
+  operator()(boost::mpi::communicator const &) const override {
+    return {1., 2., 3., 4.};
+  }
   std::vector<std::size_t> shape() const override { return {2u, 2u}; }
 };
+
+/** Return the number of evaluations, for each of the components. */
+class CountingObservable : public Observable {
+public:
+  std::vector<double>
+  operator()(boost::mpi::communicator const &) const override {
+    ++n_evaluations;
+    return std::vector<double>(n_components,
+                               static_cast<double>(n_evaluations));
+  }
+  std::vector<std::size_t> shape() const override { return {n_components}; }
+  mutable int n_evaluations = 0;
+  std::size_t n_components = 2u;
+};
 } // namespace Observables
 
 namespace ScriptInterface {
@@ -56,10 +85,26 @@ using TestObs = ScriptInterface::Observables::MockObservable;
 using TestObsPtr = std::shared_ptr<TestObs>;
 using namespace ScriptInterface;
 
+namespace {
+/** The accumulators rely on the context to handle parallel exceptions. */
+auto make_context() {
+  Utils::Factory<ObjectHandle> factory;
+  factory.register_new<TestObs>("MockObservable");
+  factory.register_new<Accumulators::Correlator>("Correlator");
+  factory.register_new<Accumulators::MeanVarianceCalculator>(
+      "MeanVarianceCalculator");
+  factory.register_new<Accumulators::TimeSeries>("TimeSeries");
+  return std::make_shared<LocalContext>(factory, boost::mpi::communicator());
+}
+} // namespace
+
 BOOST_AUTO_TEST_CASE(time_series) {
-  auto const obs = std::make_shared<TestObs>();
-  ScriptInterface::Accumulators::TimeSeries acc;
-  acc.do_construct({{"obs", obs}, {"delta_N", 2}});
+  auto const ctx = make_context();
+  auto const obs = std::dynamic_pointer_cast<TestObs>(
+      ctx->make_shared("MockObservable", {}));
+  auto const acc_ptr = std::dynamic_pointer_cast<Accumulators::TimeSeries>(
+      ctx->make_shared("TimeSeries", {{"obs", obs}, {"delta_N", 2}}));
+  auto &acc = *acc_ptr;
   acc.do_call_method("update", VariantMap{});
   {
     BOOST_CHECK_EQUAL(get_value<int>(acc.get_parameter("delta_N")), 2);
@@ -86,13 +131,18 @@ BOOST_AUTO_TEST_CASE(time_series) {
 }
 
 BOOST_AUTO_TEST_CASE(correlator) {
-  auto const obs = std::make_shared<TestObs>();
-  ScriptInterface::Accumulators::Correlator acc;
-  acc.do_construct({{"obs1", obs},
-                    {"delta_N", 2},
-                    {"tau_lin", 4},
-                    {"tau_max", 2.},
-                    {"corr_operation", std::string("componentwise_product")}});
+  auto const ctx = make_context();
+  auto const obs = std::dynamic_pointer_cast<TestObs>(
+      ctx->make_shared("MockObservable", {}));
+  auto const acc_ptr = std::dynamic_pointer_cast<Accumulators::Correlator>(
+      ctx->make_shared(
+          "Correlator",
+          {{"obs1", obs},
+           {"delta_N", 2},
+           {"tau_lin", 4},
+           {"tau_max", 2.},
+           {"corr_operation", std::string("componentwise_product")}}));
+  auto &acc = *acc_ptr;
   acc.do_call_method("update", VariantMap{});
   acc.do_call_method("finalize", VariantMap{});
   {
@@ -140,9 +190,14 @@ BOOST_AUTO_TEST_CASE(correlator) {
 }
 
 BOOST_AUTO_TEST_CASE(mean_variance) {
-  auto const obs = std::make_shared<TestObs>();
-  ScriptInterface::Accumulators::MeanVarianceCalculator acc;
-  acc.do_construct({{"obs", obs}, {"delta_N", 2}});
+  auto const ctx = make_context();
+  auto const obs = std::dynamic_pointer_cast<TestObs>(
+      ctx->make_shared("MockObservable", {}));
+  auto const acc_ptr =
+      std::dynamic_pointer_cast<Accumulators::MeanVarianceCalculator>(
+          ctx->make_shared("MeanVarianceCalculator",
+                           {{"obs", obs}, {"delta_N", 2}}));
+  auto &acc = *acc_ptr;
   acc.do_call_method("update", VariantMap{});
   acc.do_call_method("update", VariantMap{});
   {
@@ -181,3 +236,90 @@ BOOST_AUTO_TEST_CASE(mean_variance) {
     BOOST_TEST(stderror == stderror_ref, boost::test_tools::per_element());
   }
 }
+
+BOOST_AUTO_TEST_CASE(shared_observable_samples) {
+  auto const obs = std::make_shared<::Observables::CountingObservable>();
+  ::Accumulators::TimeSeries series(obs, 2);
+  ::Accumulators::Correlator correlator(4, 2., 2, "linear", "linear",
+                                        "scalar_product", obs, obs);
+  boost::mpi::communicator comm;
+  auto const n_updates = 6;
+  for (int i = 0; i < n_updates; ++i) {
+    ::Accumulators::ObservableSamples samples;
+    series.update(comm, samples);
+    correlator.update(comm, samples);
+  }
+  // the observable is evaluated once per sweep
+  BOOST_CHECK_EQUAL(obs->n_evaluations, n_updates);
+  BOOST_REQUIRE_EQUAL(series.time_series().size(),
+                      static_cast<std::size_t>(n_updates));
+  BOOST_CHECK_EQUAL(series.time_series().back()[0], 6.);
+  // compare with the brute-force correlation of the samples
+  auto const correlation = correlator.get_correlation();
+  BOOST_REQUIRE_EQUAL(correlation.size(), 5u);
+  for (int j = 0; j < 5; ++j) {
+    auto sum = 0.;
+    for (int t = j + 1; t <= n_updates; ++t) {
+      sum += 2. * (t - j) * t;
+    }
+    BOOST_CHECK_CLOSE(correlation[j], sum / (n_updates - j), 1e-12);
+  }
+  // without shared samples, the observable is evaluated by each accumulator
+  series.update(comm);
+  correlator.update(comm);
+  BOOST_CHECK_EQUAL(obs->n_evaluations, n_updates + 2);
+}
+
+BOOST_AUTO_TEST_CASE(correlator_hierarchy) {
+  // hierarchy of 6 levels for lags up to 64 steps
+  mpi_set_time_step(1.);
+  auto const tau_lin = 4;
+  auto const obs = std::make_shared<::Observables::CountingObservable>();
+  ::Accumulators::Correlator correlator(tau_lin, 64., 1, "linear", "linear",
+                                        "scalar_product", obs, obs);
+  boost::mpi::communicator comm;
+  auto const n_updates = 200;
+  for (int i = 0; i < n_updates; ++i) {
+    correlator.update(comm);
+  }
+  // entry b of level i is the average of the samples b * 2^i + 1 to
+  // (b + 1) * 2^i, and the new entries are correlated with the older ones
+  auto const correlation = correlator.get_correlation();
+  auto const n_sweeps = correlator.get_samples_sizes();
+  BOOST_REQUIRE_EQUAL(correlation.size(), n_sweeps.size());
+  BOOST_REQUIRE_EQUAL(n_sweeps.size(), 5u + 5u * 2u);
+  auto const level_average = [](int level, int b) {
+    auto const width = 1 << level;
+    return b * width + (width + 1) / 2.;
+  };
+  for (std::size_t r = 0; r < n_sweeps.size(); ++r) {
+    auto level = 0;
+    auto lag = static_cast<int>(r);
+    if (lag > tau_lin) {
+      level = 1 + (lag - tau_lin - 1) / (tau_lin / 2);
+      lag = tau_lin / 2 + 1 + (lag - tau_lin - 1) % (tau_lin / 2);
+    }
+    // the last level is not filled yet
+    if (level == 5) {
+      BOOST_CHECK_EQUAL(n_sweeps[r], 0);
+      BOOST_CHECK_EQUAL(correlation[r], 0.);
+      continue;
+    }
+    BOOST_REQUIRE_GT(n_sweeps[r], 0);
+    auto sum = 0.;
+    for (int b = lag; b < lag + n_sweeps[r]; ++b) {
+      sum += 2. * level_average(level, b - lag) * level_average(level, b);
+    }
+    BOOST_CHECK_CLOSE(correlation[r], sum / n_sweeps[r], 1e-12);
+  }
+  // samples of the wrong size are rejected
+  obs->n_components = 3u;
+  BOOST_CHECK_THROW(correlator.update(comm), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  auto mpi_env = std::make_shared<boost::mpi::environment>(argc, argv);
+  Communication::init(mpi_env);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,223 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+import unittest as ut
+import unittest_decorators as utx
+import numpy as np
+import scipy.special
+
+import espressomd
+import espressomd.electrostatics
+import espressomd.magnetostatics
+import tests_common
+
+
+class Ewald:
+
+    """Ewald sums with metallic boundary conditions, evaluated without
+    a mesh. The real-space sums run over all periodic images within
+    one box length, the reciprocal-space sums over all wave vectors
+    whose Gaussian factor is above machine precision.
+    """
+
+    def __init__(self, box_l, alpha, prefactor):
+        self.box_l = np.array(box_l, dtype=float)
+        self.alpha = alpha
+        self.prefactor = prefactor
+        self.volume = np.prod(self.box_l)
+        k_max = 2. * alpha * np.sqrt(36.)
+        n_max = np.ceil(k_max * self.box_l / (2. * np.pi)).astype(int)
+        n = np.array(np.meshgrid(*[np.arange(-m, m + 1) for m in n_max],
+                                 indexing="ij")).reshape((3, -1)).T
+        n = n[np.any(n != 0, axis=1)]
+        self.k = 2. * np.pi * n / self.box_l
+        self.k2 = np.sum(self.k**2, axis=1)
+        self.g = np.exp(-self.k2 / (4. * alpha**2)) / self.k2
+        shifts = np.array(np.meshgrid(*3 * [[-1, 0, 1]], indexing="ij"))
+        self.shifts = shifts.reshape((3, -1)).T * self.box_l
+
+    def pair_vectors(self, pos):
+        """Distance vectors of all pairs and images, without self pairs."""
+        d = pos[:, np.newaxis, np.newaxis, :] - \
+            pos[np.newaxis, :, np.newaxis, :] + self.shifts
+        r = np.linalg.norm(d, axis=-1)
+        mask = r > 1e-10
+        return d, np.where(mask, r, 1.), mask
+
+    def radial_terms(self, r, n_terms):
+        """The functions :math:`B_l(r)` of the real-space sums, with
+        :math:`dB_l/dr = -r B_{l+1}`.
+        """
+        a = self.alpha
+        gauss = np.exp(-(a * r)**2) / (a * np.sqrt(np.pi))
+        terms = [scipy.special.erfc(a * r) / r]
+        for l in range(1, n_terms):
+            terms.append(((2 * l - 1) * terms[-1] +
+                          (2. * a**2)**l * gauss) / r**2)
+        return terms
+
+    def charges(self, pos, q):
+        """Energy, forces and pressure tensor of point charges."""
+        d, r, mask = self.pair_vectors(pos)
+        B0, B1 = self.radial_terms(r, 2)
+        qq = np.where(mask, np.multiply.outer(q, q)[..., np.newaxis], 0.)
+        energy = 0.5 * np.sum(qq * B0)
+        f_pair = (qq * B1)[..., np.newaxis] * d
+        forces = np.sum(f_pair, axis=(1, 2))
+        virial = 0.5 * np.einsum("ijna,ijnb->ab", f_pair, d)
+
+        phase = np.exp(1j * pos @ self.k.T)
+        S = q @ phase
+        c = 2. * np.pi / self.volume
+        S2 = np.abs(S)**2
+        energy += c * np.sum(self.g * S2)
+        forces += 2. * c * q[:, np.newaxis] * \
+            (np.imag(phase * np.conj(S)) * self.g) @ self.k
+        kk = self.k[:, :, np.newaxis] * self.k[:, np.newaxis, :]
+        factor = 2. * (1. + self.k2 / (4. * self.alpha**2)) / self.k2
+        virial += c * (np.sum(self.g * S2) * np.eye(3) -
+                       np.einsum("k,kab->ab", self.g * S2 * factor, kk))
+
+        energy -= self.alpha / np.sqrt(np.pi) * np.sum(q**2)
+        return (self.prefactor * energy, self.prefactor * forces,
+                self.prefactor * virial / self.volume)
+
+    def dipoles(self, pos, dip):
+        """Energy, forces and torques of point dipoles."""
+        d, r, mask = self.pair_vectors(pos)
+        _, B1, B2, B3 = self.radial_terms(r, 4)
+        B1, B2, B3 = [np.where(mask, B, 0.) for B in (B1, B2, B3)]
+        mi = dip[:, np.newaxis, np.newaxis, :]
+        mj = dip[np.newaxis, :, np.newaxis, :]
+        mimj = np.sum(mi * mj, axis=-1)
+        mid = np.sum(mi * d, axis=-1)
+        mjd = np.sum(mj * d, axis=-1)
+        energy = 0.5 * np.sum(mimj * B1 - mid * mjd * B2)
+        forces = np.sum((mimj * B2 - mid * mjd * B3)[..., np.newaxis] * d +
+                        (mjd * B2)[..., np.newaxis] * mi +
+                        (mid * B2)[..., np.newaxis] * mj, axis=(1, 2))
+        # gradient of the energy with respect to the dipole moments
+        grad = np.sum(B1[..., np.newaxis] * mj -
+                      (mjd * B2)[..., np.newaxis] * d, axis=(1, 2))
+
+        phase = np.exp(1j * pos @ self.k.T)
+        mk = dip @ self.k.T
+        S = np.sum(mk * phase, axis=0)
+        c = 2. * np.pi / self.volume
+        energy += c * np.sum(self.g * np.abs(S)**2)
+        re = np.real(phase * np.conj(S)) * self.g
+        forces += 2. * c * (mk * np.imag(phase * np.conj(S)) * self.g) @ self.k
+        grad += 2. * c * re @ self.k
+
+        self_factor = 2. * self.alpha**3 / (3. * np.sqrt(np.pi))
+        energy -= self_factor * np.sum(dip**2)
+        grad -= 2. * self_factor * dip
+        torques = np.cross(dip, -grad)
+        return (self.prefactor * energy, self.prefactor * forces,
+                self.prefactor * torques)
+
+
+@utx.skipIfMissingFeatures(["P3M"])
+class P3MvsEwald(ut.TestCase):
+
+    """Compare the mesh solvers to Ewald sums on a non-cubic box and
+    mesh, and on a cubic mesh with an odd number of points. The real
+    to complex transforms store only half of the last mesh dimension,
+    so these cases check that the other half is weighted correctly.
+    """
+
+    system = espressomd.System(box_l=[1., 1., 1.])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def tearDown(self):
+        self.system.actors.clear()
+        self.system.part.clear()
+
+    def random_positions(self, n_part, min_dist):
+        positions = []
+        while len(positions) < n_part:
+            pos = np.random.random(3) * self.system.box_l
+            if all(np.linalg.norm(self.system.distance_vec(pos, other)) >
+                   min_dist for other in positions):
+                positions.append(pos)
+        return np.array(positions)
+
+    def test_coulomb_non_cubic(self):
+        np.random.seed(seed=42)
+        self.system.box_l = [10., 12., 14.]
+        n_pairs = 20
+        pos = self.random_positions(2 * n_pairs, 0.8)
+        q = np.array(n_pairs * [1., -1.])
+        partcls = self.system.part.add(pos=pos, q=q)
+
+        params = {"prefactor": 1.7, "cao": 7, "alpha": 0.85, "r_cut": 4.5}
+        p3m = espressomd.electrostatics.P3M(
+            mesh=[20, 24, 30], accuracy=1e-6, tune=False, **params)
+        self.system.actors.add(p3m)
+        self.system.integrator.run(0, recalc_forces=True)
+
+        ref_energy, ref_forces, ref_pressure = Ewald(
+            self.system.box_l, params["alpha"], params["prefactor"]).charges(
+                pos, q)
+        energy = self.system.analysis.energy()["coulomb"]
+        pressure = self.system.analysis.pressure_tensor()["coulomb"]
+        f_scale = np.sqrt(np.mean(np.sum(ref_forces**2, axis=1)))
+        np.testing.assert_allclose(energy, ref_energy, rtol=1e-5)
+        np.testing.assert_allclose(np.copy(partcls.f), ref_forces,
+                                   atol=1e-4 * f_scale)
+        np.testing.assert_allclose(pressure, ref_pressure,
+                                   atol=1e-4 * np.max(np.abs(ref_pressure)))
+        # the virial of the Coulomb potential is its energy
+        np.testing.assert_allclose(
+            np.trace(ref_pressure),
+            ref_energy / self.system.volume(), rtol=1e-8)
+
+    @utx.skipIfMissingFeatures(["DP3M"])
+    def test_dipolar_odd_mesh(self):
+        np.random.seed(seed=42)
+        self.system.box_l = 3 * [12.]
+        n_part = 20
+        pos = self.random_positions(n_part, 1.)
+        dip = tests_common.random_dipoles(n_part)
+        partcls = self.system.part.add(pos=pos, dip=dip,
+                                       rotation=n_part * [(1, 1, 1)])
+
+        params = {"prefactor": 1.1, "cao": 7, "alpha": 0.7, "r_cut": 5.5}
+        dp3m = espressomd.magnetostatics.DipolarP3M(
+            mesh=3 * [25], accuracy=1e-6, tune=False, **params)
+        self.system.actors.add(dp3m)
+        self.system.integrator.run(0, recalc_forces=True)
+
+        ref_energy, ref_forces, ref_torques = Ewald(
+            self.system.box_l, params["alpha"], params["prefactor"]).dipoles(
+                pos, dip)
+        energy = self.system.analysis.energy()["dipolar"]
+        f_scale = np.sqrt(np.mean(np.sum(ref_forces**2, axis=1)))
+        t_scale = np.sqrt(np.mean(np.sum(ref_torques**2, axis=1)))
+        np.testing.assert_allclose(energy, ref_energy,
+                                   atol=1e-4 * np.abs(ref_energy))
+        np.testing.assert_allclose(np.copy(partcls.f), ref_forces,
+                                   atol=1e-3 * f_scale)
+        np.testing.assert_allclose(np.copy(partcls.torque_lab), ref_torques,
+                                   atol=1e-3 * t_scale)
+
+
+if __name__ == "__main__":
+    ut.main()
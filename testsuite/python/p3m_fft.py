@@ -99,6 +99,36 @@ class FFT_test(ut.TestCase):
             self.system.actors.clear()
             np.testing.assert_allclose(p3m_energy, ref_energy, rtol=1e-4)
 
+    @ut.skipIf(n_nodes not in FFT_PLANS, f"no FFT plan for {n_nodes} threads")
+    def test_fft_plans_forces(self):
+        """Compare the forces of each FFT plan, with one and with several
+        threads per rank, to the forces of a single-rank run.
+        """
+        import espressomd.electrostatics
+        data = np.load(tests_common.data_path("p3m_fft_system.npz"))
+        partcls = self.system.part.add(pos=data["pos"], q=data["q"])
+        # the P3M cutoff of the 4x1x1 grid nearly fills the local box
+        self.system.cell_system.skin = 0.1
+        n_threads = [1]
+        if espressomd.has_features("OPENMP"):
+            n_threads.append(2)
+        for node_grid, p3m_params in FFT_PLANS[self.n_nodes]:
+            ref_forces = data[f"forces_mesh_{p3m_params['mesh']}"]
+            self.system.cell_system.node_grid = node_grid
+            for threads in n_threads:
+                self.system.n_threads = threads
+                solver = espressomd.electrostatics.P3M(
+                    prefactor=2, accuracy=1e-6, tune=False, **p3m_params)
+                self.system.actors.add(solver)
+                self.system.integrator.run(0, recalc_forces=True)
+                forces = np.copy(partcls.f)
+                self.system.actors.clear()
+                self.system.n_threads = 1
+                np.testing.assert_allclose(
+                    forces, ref_forces, rtol=0.,
+                    atol=1e-10 * np.max(np.abs(ref_forces)),
+                    err_msg=f"node grid {node_grid}, {threads} threads")
+
     @utx.skipIfMissingFeatures("P3M")
     @ut.skipIf(n_nodes < 2 or n_nodes >= 8, "only runs for 2 <= n_nodes <= 7")
     def test_unsorted_node_grid_exception_p3m(self):
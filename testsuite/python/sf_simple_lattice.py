@@ -18,6 +18,7 @@
 #
 
 import unittest as ut
+import unittest_decorators as utx
 import espressomd
 import numpy as np
 import itertools
@@ -170,6 +171,21 @@ class StructureFactorTest(ut.TestCase):
         peaks = self.peak_orders(wavevectors[np.nonzero(intensities)])
         np.testing.assert_array_equal(peaks, peaks_ref[:len(peaks)])
 
+    @utx.skipIfMissingFeatures(["FFTW"])
+    def test_fft_mode(self):
+        """Check the mesh-based structure factor of a disordered system."""
+        np.random.seed(42)
+        self.system.part.add(type=self.part_ty,
+                             pos=np.random.random((400, 3)) * self.box_l)
+        sf_order = 8
+        wavevectors_ref, intensities_ref = \
+            self.system.analysis.structure_factor(
+                sf_types=[self.part_ty], sf_order=sf_order)
+        wavevectors, intensities = self.system.analysis.structure_factor(
+            sf_types=[self.part_ty], sf_order=sf_order, sf_fft=True)
+        np.testing.assert_allclose(wavevectors, wavevectors_ref, rtol=1e-12)
+        np.testing.assert_allclose(intensities, intensities_ref, rtol=2e-2)
+
     def test_exceptions(self):
         with self.assertRaisesRegex(ValueError, 'order has to be a strictly positive number'):
             self.system.analysis.structure_factor(sf_types=[0], sf_order=0)